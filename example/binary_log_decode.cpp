@@ -0,0 +1,33 @@
+#include <cstdio>
+
+#include "efp.hpp"
+
+using namespace efp;
+
+// Renders a log written by BinaryLog as text, a line per message after the timestamp in seconds
+// usage: binary_log_decode <binary log>
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        std::fprintf(stderr, "usage: %s <binary log>\n", argv[0]);
+        return 1;
+    }
+
+    auto maybe_file = MappedFile::open(argv[1]);
+    if (!maybe_file) {
+        std::fprintf(stderr, "binary_log_decode: cannot open %s\n", argv[1]);
+        return 1;
+    }
+
+    const MappedFile file = maybe_file.move();
+    file.advise(MapAdvice::Sequential);
+
+    BinaryLogReader reader {file.chars()};
+
+    for (auto entry = reader.next(); entry; entry = reader.next()) {
+        const BinaryLogEntry& e = entry.value();
+        println("{}.{:09} {}", e.timestamp / 1000000000, e.timestamp % 1000000000, e.text);
+    }
+
+    return 0;
+}
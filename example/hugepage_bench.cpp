@@ -0,0 +1,80 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+#include "efp.hpp"
+
+using namespace efp;
+
+// Scan throughput of sum and map over a large Vector<double>, with regular and huge pages for
+// both the input and the output
+// usage: hugepage_bench [size in MiB, default 1024]
+
+template<typename F>
+double throughput_gib_s(size_t bytes, int repeat, const F& f) {
+    const auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeat; ++i) {
+        f();
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    const double seconds = std::chrono::duration<double>(end - begin).count();
+    return static_cast<double>(bytes) * repeat / seconds / (1024. * 1024. * 1024.);
+}
+
+const char* mode_name(HugePageMode mode) {
+    switch (mode) {
+        case HugePageMode::Explicit:
+            return "explicit (MAP_HUGETLB)";
+        case HugePageMode::Transparent:
+            return "transparent (MADV_HUGEPAGE)";
+        default:
+            return "none";
+    }
+}
+
+template<typename Allocator>
+void bench(const char* name, size_t n, int repeat) {
+    Vector<double, Allocator> as {};
+    as.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        as[i] = static_cast<double>(i & 0xff);
+    }
+
+    const size_t bytes = n * sizeof(double);
+    volatile double sink = 0.;
+
+    const double sum_tp = throughput_gib_s(bytes, repeat, [&]() { sink = sink + sum(as); });
+    // The loop of map, with the output on the same allocator as the input. efp::map returns
+    // a Vector of the default allocator, which would leave the output on regular pages
+    const double map_tp = throughput_gib_s(bytes, repeat, [&]() {
+        Vector<double, Allocator> bs {};
+        bs.resize(n);
+        for (size_t i = 0; i < n; ++i) {
+            bs[i] = as[i] * 0.5;
+        }
+        sink = sink + bs[n - 1];
+    });
+
+    std::cout << name << "\n"
+              << "  sum: " << sum_tp << " GiB/s\n"
+              << "  map: " << map_tp << " GiB/s\n";
+}
+
+int main(int argc, char const* argv[]) {
+    const size_t mib = argc > 1 ? static_cast<size_t>(std::atoll(argv[1])) : 1024;
+    const size_t n = mib * 1024 * 1024 / sizeof(double);
+    const int repeat = 5;
+
+    std::cout << "Vector<double> of " << mib << " MiB, " << repeat << " passes\n";
+
+    bench<std::allocator<double>>("regular pages", n, repeat);
+    bench<HugePageAllocator<double>>("huge pages", n, repeat);
+
+    HugePageAllocator<double> alloc {};
+    double* p = alloc.allocate(n);
+    std::cout << "huge page mode: " << mode_name(alloc.mode()) << "\n";
+    alloc.deallocate(p, n);
+
+    return 0;
+}
@@ -4,18 +4,37 @@
 #include "./efp/cpp_core.hpp"
 #include "./efp/meta.hpp"
 #include "./efp/trait.hpp"
+#include "./efp/tlsf.hpp"
 #include "./efp/sequence.hpp"
 #include "./efp/enum.hpp"
 #include "./efp/maybe.hpp"
 #include "./efp/prelude.hpp"
 #include "./efp/cyclic.hpp"
+#include "./efp/chunked.hpp"
+#include "./efp/persistent.hpp"
 #include "./efp/numeric.hpp"
 #include "./efp/scientific.hpp"
 #include "./efp/sort.hpp"
 #include "./efp/io.hpp"
 #include "./efp/string.hpp"
+#include "./efp/hash.hpp"
+#include "./efp/hash_map.hpp"
+#include "./efp/flat_map.hpp"
+#include "./efp/search_index.hpp"
+#include "./efp/string_pool.hpp"
+#include "./efp/string_builder.hpp"
+#include "./efp/rope.hpp"
+#include "./efp/mapped_file.hpp"
+#include "./efp/async_file.hpp"
+#include "./efp/serialize.hpp"
+#include "./efp/csv.hpp"
 #include "./efp/format.hpp"
+#include "./efp/pool.hpp"
 #include "./efp/concurrency.hpp"
+#include "./efp/logger.hpp"
+#include "./efp/binary_log.hpp"
+#include "./efp/tracking.hpp"
+#include "./efp/hugepage.hpp"
 
 // ! Deprecated
 #include "./efp/c_utility.hpp"
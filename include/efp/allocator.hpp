@@ -1,10 +1,22 @@
 #ifndef EFP_ALLOCATOR_HPP_
 #define EFP_ALLOCATOR_HPP_
 
-// #if !defined(__STDC_HOSTED__)
-// Define a custom allocator for freestanding environments
-
 #include "efp/cpp_core.hpp"
+#include "efp/meta.hpp"
+
+#if defined(__STDC_HOSTED__) && __STDC_HOSTED__ == 1
+    #include <memory>
+
+namespace efp {
+// Use std::allocator_traits if available
+template<typename A>
+using AllocatorTraits = std::allocator_traits<A>;
+
+}  // namespace efp
+
+#else
+
+// Define a custom allocator traits for freestanding environments
 
 namespace efp {
 
@@ -44,6 +56,12 @@ struct AllocatorTraits {
     }
 };
 
+}  // namespace efp
+
+#endif
+
+namespace efp {
+
 template<typename T>
 class Allocator {
 public:
@@ -86,8 +104,288 @@ public:
     }
 };
 
-}  // namespace efp
+// cache_line_size
+// Destructive interference size of the common x86-64 and AArch64 targets
+constexpr size_t cache_line_size = 64;
+
+// is_aligned
+template<typename A>
+inline bool is_aligned(const A* p, size_t align) {
+    return (reinterpret_cast<uintptr_t>(p) & (align - 1)) == 0;
+}
+
+// assume_aligned
+// Let the compiler assume the alignment of the pointer. Misaligned pointer is undefined behavior
+template<size_t align, typename A>
+inline A* assume_aligned(A* p) {
+    static_assert((align & (align - 1)) == 0, "Alignment must be a power of two");
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<A*>(__builtin_assume_aligned(p, align));
+#else
+    return p;
+#endif
+}
+
+// AlignedAllocator
+// Allocates storage aligned to align bytes. Could be used for aligned SIMD loads and to avoid
+// elements splitting over the cache lines.
+template<typename A, size_t align>
+class AlignedAllocator {
+public:
+    static_assert((align & (align - 1)) == 0, "Alignment must be a power of two");
+    static_assert(align >= alignof(A), "Alignment must not be weaker than alignof(A)");
+
+    using value_type = A;
+    using pointer = A*;
+    using const_pointer = const A*;
+    using reference = A&;
+    using const_reference = const A&;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+
+    static constexpr size_t alignment = align;
+
+    template<typename B>
+    struct rebind {
+        using other = AlignedAllocator<B, align>;
+    };
+
+    AlignedAllocator() noexcept = default;
+
+    template<typename B>
+    AlignedAllocator(const AlignedAllocator<B, align>&) noexcept {}
+
+    pointer allocate(size_type n) {
+        // Over-allocate and stash the original pointer right before the aligned block
+        void* raw = ::operator new(n * sizeof(A) + align + sizeof(void*));
+        const uintptr_t aligned = (reinterpret_cast<uintptr_t>(raw) + sizeof(void*) + align - 1)
+            & ~static_cast<uintptr_t>(align - 1);
+
+        reinterpret_cast<void**>(aligned)[-1] = raw;
+        return reinterpret_cast<pointer>(aligned);
+    }
+
+    void deallocate(pointer p, size_type) {
+        if (p) {
+            ::operator delete(reinterpret_cast<void**>(p)[-1]);
+        }
+    }
+
+    size_type max_size() const noexcept {
+        return (size_type(-1) - align - sizeof(void*)) / sizeof(A);
+    }
+
+    template<typename... Args>
+    void construct(pointer p, Args&&... args) {
+        new (p) A(efp::forward<Args>(args)...);
+    }
+
+    void destroy(pointer p) {
+        p->~A();
+    }
+};
+
+template<typename A, typename B, size_t align>
+bool operator==(const AlignedAllocator<A, align>&, const AlignedAllocator<B, align>&) {
+    return true;
+}
+
+template<typename A, typename B, size_t align>
+bool operator!=(const AlignedAllocator<A, align>&, const AlignedAllocator<B, align>&) {
+    return false;
+}
+
+// MonotonicArena
+// Bump allocator over caller-provided buffer and then over chunks taken from the global heap.
+// Individual deallocation is no-op. All the memory is released at once by release() or destruction.
+class MonotonicArena {
+public:
+    explicit MonotonicArena(size_t chunk_size = 4096)
+        : _initial_buffer(nullptr), _initial_size(0), _current(nullptr), _end(nullptr),
+          _chunks(nullptr), _next_chunk_size(chunk_size), _initial_chunk_size(chunk_size),
+          _allocated(0) {}
+
+    // The buffer must outlive the arena. Chunks are taken from the heap once it is exhausted
+    MonotonicArena(void* buffer, size_t size, size_t chunk_size = 4096)
+        : _initial_buffer(static_cast<char*>(buffer)), _initial_size(size),
+          _current(static_cast<char*>(buffer)), _end(static_cast<char*>(buffer) + size),
+          _chunks(nullptr), _next_chunk_size(chunk_size), _initial_chunk_size(chunk_size),
+          _allocated(0) {}
+
+    MonotonicArena(const MonotonicArena&) = delete;
+
+    MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+    ~MonotonicArena() {
+        _free_chunks();
+    }
+
+    void* allocate(size_t bytes, size_t align = alignof(std::max_align_t)) {
+        char* p = _align_up(_current, align);
+
+        if (_current == nullptr || p + bytes > _end) {
+            _add_chunk(bytes + align);
+            p = _align_up(_current, align);
+        }
+
+        _current = p + bytes;
+        _allocated += bytes;
+        return p;
+    }
 
-// #endif
+    void deallocate(void*, size_t) noexcept {}
+
+    // Release all the chunks and rewind to the caller-provided buffer
+    void release() {
+        _free_chunks();
+
+        _current = _initial_buffer;
+        _end = _initial_buffer + _initial_size;
+        _next_chunk_size = _initial_chunk_size;
+        _allocated = 0;
+    }
+
+    // Total bytes handed out since construction or the last release
+    size_t allocated() const {
+        return _allocated;
+    }
+
+    // Number of heap chunks currently owned
+    size_t chunk_count() const {
+        size_t count = 0;
+        for (const Chunk* c = _chunks; c; c = c->next) {
+            ++count;
+        }
+        return count;
+    }
+
+private:
+    struct Chunk {
+        Chunk* next;
+    };
+
+    static char* _align_up(char* p, size_t align) {
+        return reinterpret_cast<char*>(
+            (reinterpret_cast<uintptr_t>(p) + align - 1) & ~static_cast<uintptr_t>(align - 1)
+        );
+    }
+
+    void _add_chunk(size_t min_bytes) {
+        size_t size = _next_chunk_size;
+        while (size < min_bytes + sizeof(Chunk)) {
+            size *= 2;
+        }
+
+        Chunk* chunk = static_cast<Chunk*>(::operator new(size));
+        chunk->next = _chunks;
+        _chunks = chunk;
+
+        _current = reinterpret_cast<char*>(chunk) + sizeof(Chunk);
+        _end = reinterpret_cast<char*>(chunk) + size;
+
+        // Geometric growth keeps the number of chunks logarithmic
+        _next_chunk_size = size * 2;
+    }
+
+    void _free_chunks() {
+        while (_chunks) {
+            Chunk* next = _chunks->next;
+            ::operator delete(_chunks);
+            _chunks = next;
+        }
+    }
+
+    char* _initial_buffer;
+    size_t _initial_size;
+    char* _current;
+    char* _end;
+    Chunk* _chunks;
+    size_t _next_chunk_size;
+    size_t _initial_chunk_size;
+    size_t _allocated;
+};
+
+// ArenaAllocator
+// Stateful allocator adaptor of MonotonicArena.
+// Containers using it do not pay a malloc/free pair per allocation.
+template<typename A>
+class ArenaAllocator {
+public:
+    using value_type = A;
+    using pointer = A*;
+    using const_pointer = const A*;
+    using reference = A&;
+    using const_reference = const A&;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+
+    template<typename B>
+    struct rebind {
+        using other = ArenaAllocator<B>;
+    };
+
+    ArenaAllocator(MonotonicArena& arena) noexcept : _arena(&arena) {}
+
+    template<typename B>
+    ArenaAllocator(const ArenaAllocator<B>& other) noexcept : _arena(other.arena()) {}
+
+    pointer allocate(size_type n) {
+        return static_cast<pointer>(_arena->allocate(n * sizeof(A), alignof(A)));
+    }
+
+    void deallocate(pointer p, size_type n) {
+        _arena->deallocate(p, n * sizeof(A));
+    }
+
+    size_type max_size() const noexcept {
+        return size_type(-1) / sizeof(A);
+    }
+
+    template<typename... Args>
+    void construct(pointer p, Args&&... args) {
+        new (p) A(efp::forward<Args>(args)...);
+    }
+
+    void destroy(pointer p) {
+        p->~A();
+    }
+
+    MonotonicArena* arena() const noexcept {
+        return _arena;
+    }
+
+private:
+    MonotonicArena* _arena;
+};
+
+template<typename A, typename B>
+bool operator==(const ArenaAllocator<A>& lhs, const ArenaAllocator<B>& rhs) {
+    return lhs.arena() == rhs.arena();
+}
+
+template<typename A, typename B>
+bool operator!=(const ArenaAllocator<A>& lhs, const ArenaAllocator<B>& rhs) {
+    return lhs.arena() != rhs.arena();
+}
+
+// AllocatorAlign
+// Compile time alignment guaranteed by the allocator.
+// Allocators without alignment member are assumed to guarantee alignof(value_type)
+namespace detail {
+    template<typename Alloc, typename = void>
+    struct AllocatorAlignImpl {
+        using Type = Size<alignof(typename Alloc::value_type)>;
+    };
+
+    template<typename Alloc>
+    struct AllocatorAlignImpl<Alloc, Void<decltype(Alloc::alignment)>> {
+        using Type = Size<Alloc::alignment>;
+    };
+}  // namespace detail
+
+template<typename Alloc>
+using AllocatorAlign = typename detail::AllocatorAlignImpl<Alloc>::Type;
+
+}  // namespace efp
 
-#endif
\ No newline at end of file
+#endif
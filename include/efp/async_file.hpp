@@ -0,0 +1,876 @@
+#ifndef EFP_ASYNC_FILE_HPP_
+#define EFP_ASYNC_FILE_HPP_
+
+// ! Not for freestanding environments
+#if defined(__STDC_HOSTED__) && __STDC_HOSTED__ == 1
+
+    #include <condition_variable>
+    #include <cstring>
+    #include <mutex>
+    #include <queue>
+    #include <thread>
+
+    #include "efp/cpp_core.hpp"
+    #include "efp/maybe.hpp"
+    #include "efp/sequence.hpp"
+    #include "efp/string.hpp"
+    #include "efp/concurrency.hpp"
+
+    #if defined(__unix__) || defined(__APPLE__)
+        #include <cerrno>
+        #include <fcntl.h>
+        #include <sys/stat.h>
+        #include <sys/uio.h>
+        #include <unistd.h>
+    #endif
+
+    // io_uring through the raw system calls. IORING_FEAT_RW_CUR_POS marks the headers of Linux
+    // 5.6, the first with IORING_OP_READ and IORING_OP_WRITE
+    #if defined(__linux__) && defined(__has_include)
+        #if __has_include(<linux/io_uring.h>)
+            #include <sys/mman.h>
+            #include <sys/syscall.h>
+            #include <linux/io_uring.h>
+
+            #if defined(__NR_io_uring_setup) && defined(IORING_FEAT_RW_CUR_POS)
+                #define EFP_IO_URING 1
+            #endif
+        #endif
+    #endif
+
+namespace efp {
+
+    #if defined(__unix__) || defined(__APPLE__)
+
+// AsyncFile
+// File descriptor for the requests of an IoQueue, closed on destruction. Opened with the modes of
+// File. Requests carry their own offset, so a file may have many of them in flight. Writes to a
+// file opened for appending go to its end whatever the offset.
+class AsyncFile {
+public:
+    static Maybe<AsyncFile> open(const char* path, const char* mode) {
+        const int flags = _flags(mode);
+        if (flags < 0) {
+            return nothing;
+        }
+
+        const int fd = ::open(path, flags | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            return nothing;
+        }
+
+        return AsyncFile {fd};
+    }
+
+    static Maybe<AsyncFile> open(const String& path, const char* mode) {
+        return open(path.c_str(), mode);
+    }
+
+    AsyncFile(const AsyncFile&) = delete;
+
+    AsyncFile& operator=(const AsyncFile&) = delete;
+
+    AsyncFile(AsyncFile&& other) noexcept : _fd(other._fd) {
+        other._fd = -1;
+    }
+
+    AsyncFile& operator=(AsyncFile&& other) noexcept {
+        if (this != &other) {
+            close();
+            _fd = other._fd;
+            other._fd = -1;
+        }
+        return *this;
+    }
+
+    ~AsyncFile() {
+        close();
+    }
+
+    int fd() const {
+        return _fd;
+    }
+
+    // Size of the file in bytes, 0 if it is closed
+    size_t size() const {
+        struct stat st;
+        if (_fd < 0 || ::fstat(_fd, &st) != 0) {
+            return 0;
+        }
+
+        return static_cast<size_t>(st.st_size);
+    }
+
+    bool close() {
+        if (_fd < 0) {
+            return false;
+        }
+
+        const bool ok = ::close(_fd) == 0;
+        _fd = -1;
+        return ok;
+    }
+
+private:
+    explicit AsyncFile(int fd) : _fd(fd) {}
+
+    // Flags of open for a mode of fopen, -1 for an unknown mode. A b is ignored
+    static int _flags(const char* mode) {
+        const bool update = std::strchr(mode, '+') != nullptr;
+        const int access = update ? O_RDWR : O_WRONLY;
+
+        switch (mode[0]) {
+            case 'r':
+                return update ? O_RDWR : O_RDONLY;
+            case 'w':
+                return access | O_CREAT | O_TRUNC;
+            case 'a':
+                return access | O_CREAT | O_APPEND;
+            default:
+                return -1;
+        }
+    }
+
+    int _fd;
+};
+
+// IoBackend
+// How an IoQueue performs its requests.
+// - Auto: io_uring if the kernel supports it, Threads otherwise.
+// - Uring: io_uring, which takes a whole batch in one system call. Throws if unavailable.
+// - Threads: Blocking pread and pwrite on a pool of worker threads.
+enum class IoBackend {
+    Auto,
+    Uring,
+    Threads,
+};
+
+// IoCompletion
+// Outcome of a request, with the user data it was queued with. The result is the number of bytes
+// transferred, which may be short as with pread and pwrite, or the negated errno on failure.
+struct IoCompletion {
+    uint64_t user_data;
+    int64_t result;
+};
+
+namespace detail {
+
+    // Largest transfer of a single request, the limit of Linux for read and write
+    constexpr size_t io_max_transfer = 0x7ffff000;
+
+    enum class IoOp : uint8_t {
+        Read,
+        Write,
+    };
+
+    // Request with its file and buffer resolved, for the worker pool
+    struct IoRequest {
+        IoOp op;
+        int fd;
+        char* data;
+        size_t size;
+        uint64_t offset;
+        uint64_t user_data;
+    };
+
+    // Worker pool running requests with the blocking system calls. Completions are collected
+    // under the same lock as the requests, which is cheap next to the system calls
+    class IoWorkers {
+    public:
+        IoWorkers() : _jobs(), _done(), _threads(), _stop(false) {}
+
+        IoWorkers(const IoWorkers&) = delete;
+
+        IoWorkers& operator=(const IoWorkers&) = delete;
+
+        ~IoWorkers() {
+            stop();
+        }
+
+        void start(size_t threads) {
+            for (size_t i = 0; i < threads; ++i) {
+                _threads.push_back(std::thread(&IoWorkers::_run, this));
+            }
+        }
+
+        // Runs the requests still queued, then joins the workers
+        void stop() {
+            {
+                std::lock_guard<std::mutex> lock(_m);
+                _stop = true;
+            }
+            _has_job.notify_all();
+
+            for (size_t i = 0; i < _threads.size(); ++i) {
+                if (_threads[i].joinable()) {
+                    _threads[i].join();
+                }
+            }
+        }
+
+        // Hands the batch to the workers under a single lock
+        void push(const Vector<IoRequest>& batch) {
+            {
+                std::lock_guard<std::mutex> lock(_m);
+                for (size_t i = 0; i < batch.size(); ++i) {
+                    _jobs.push(batch[i]);
+                }
+            }
+            _has_job.notify_all();
+        }
+
+        // Takes up to max completions after at least min are available
+        size_t reap(IoCompletion* out, size_t max, size_t min) {
+            std::unique_lock<std::mutex> lock(_m);
+            while (_done.size() < min) {
+                _has_done.wait(lock);
+            }
+
+            size_t n = 0;
+            while (n < max && !_done.empty()) {
+                out[n++] = _done.front();
+                _done.pop();
+            }
+
+            return n;
+        }
+
+    private:
+        static int64_t _perform(const IoRequest& request) {
+            while (true) {
+                const ssize_t result = request.op == IoOp::Read
+                    ? ::pread(request.fd, request.data, request.size, request.offset)
+                    : ::pwrite(request.fd, request.data, request.size, request.offset);
+
+                if (result >= 0) {
+                    return result;
+                }
+
+                if (errno != EINTR) {
+                    return -errno;
+                }
+            }
+        }
+
+        void _run() {
+            std::unique_lock<std::mutex> lock(_m);
+
+            while (true) {
+                while (_jobs.empty() && !_stop) {
+                    _has_job.wait(lock);
+                }
+
+                if (_jobs.empty()) {
+                    return;
+                }
+
+                const IoRequest request = _jobs.front();
+                _jobs.pop();
+
+                lock.unlock();
+                const IoCompletion completion {request.user_data, _perform(request)};
+                lock.lock();
+
+                _done.push(completion);
+                _has_done.notify_one();
+            }
+        }
+
+        std::queue<IoRequest> _jobs;
+        std::queue<IoCompletion> _done;
+        Vector<std::thread> _threads;
+        bool _stop;
+        std::mutex _m;
+        std::condition_variable _has_job;
+        std::condition_variable _has_done;
+    };
+
+        #if defined(EFP_IO_URING)
+
+    // Submission and completion rings shared with the kernel. Only the owning thread touches
+    // them, the atomics order the accesses against the kernel
+    class Uring {
+    public:
+        Uring()
+            : _fd(-1), _ring(MAP_FAILED), _ring_size(0), _sqes(nullptr), _sqes_size(0),
+              _sq_tail(0) {}
+
+        Uring(const Uring&) = delete;
+
+        Uring& operator=(const Uring&) = delete;
+
+        ~Uring() {
+            _close();
+        }
+
+        // Whether the kernel supports the operations used, probed once
+        static bool available() {
+            static const bool result = [] {
+                Uring probe;
+                return probe.open(1);
+            }();
+
+            return result;
+        }
+
+        bool open(unsigned entries) {
+            io_uring_params params;
+            std::memset(&params, 0, sizeof(params));
+
+            _fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+            if (_fd < 0) {
+                return false;
+            }
+
+            // Single mapping of both rings since 5.4
+            if (!(params.features & IORING_FEAT_RW_CUR_POS)
+                || !(params.features & IORING_FEAT_SINGLE_MMAP)) {
+                _close();
+                return false;
+            }
+
+            const size_t sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+            const size_t cq_size =
+                params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+            _ring_size = sq_size > cq_size ? sq_size : cq_size;
+            _ring = _map(_ring_size, IORING_OFF_SQ_RING);
+
+            _sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+            void* sqes = _map(_sqes_size, IORING_OFF_SQES);
+
+            if (_ring == MAP_FAILED || sqes == MAP_FAILED) {
+                if (sqes != MAP_FAILED) {
+                    ::munmap(sqes, _sqes_size);
+                }
+                _close();
+                return false;
+            }
+
+            char* ring = static_cast<char*>(_ring);
+            _sqes = static_cast<io_uring_sqe*>(sqes);
+            _sq_tail_shared = reinterpret_cast<unsigned*>(ring + params.sq_off.tail);
+            _sq_mask = *reinterpret_cast<unsigned*>(ring + params.sq_off.ring_mask);
+            _sq_array = reinterpret_cast<unsigned*>(ring + params.sq_off.array);
+            _cq_head = reinterpret_cast<unsigned*>(ring + params.cq_off.head);
+            _cq_tail = reinterpret_cast<unsigned*>(ring + params.cq_off.tail);
+            _cq_mask = *reinterpret_cast<unsigned*>(ring + params.cq_off.ring_mask);
+            _cqes = reinterpret_cast<io_uring_cqe*>(ring + params.cq_off.cqes);
+            _sq_tail = *_sq_tail_shared;
+
+            return true;
+        }
+
+        // Cleared entry at the tail of the submission ring. The caller keeps the number of
+        // queued and in flight requests within the entries of the ring
+        io_uring_sqe* push() {
+            const unsigned index = _sq_tail & _sq_mask;
+            ++_sq_tail;
+
+            io_uring_sqe* sqe = &_sqes[index];
+            std::memset(sqe, 0, sizeof(io_uring_sqe));
+            _sq_array[index] = index;
+            return sqe;
+        }
+
+        // Publishes the pushed entries, submits up to to_submit of them, and waits for
+        // min_complete completions. Returns the number submitted, or the negated errno
+        int enter(unsigned to_submit, unsigned min_complete) {
+            __atomic_store_n(_sq_tail_shared, _sq_tail, __ATOMIC_RELEASE);
+
+            const unsigned flags = min_complete != 0 ? IORING_ENTER_GETEVENTS : 0;
+
+            while (true) {
+                const long result = ::syscall(
+                    __NR_io_uring_enter,
+                    _fd,
+                    to_submit,
+                    min_complete,
+                    flags,
+                    nullptr,
+                    0
+                );
+
+                if (result >= 0) {
+                    return static_cast<int>(result);
+                }
+
+                if (errno != EINTR) {
+                    return -errno;
+                }
+            }
+        }
+
+        // Takes up to max completions off the completion ring
+        size_t reap(IoCompletion* out, size_t max) {
+            unsigned head = *_cq_head;
+            const unsigned tail = __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE);
+
+            size_t n = 0;
+            while (n < max && head != tail) {
+                const io_uring_cqe& cqe = _cqes[head & _cq_mask];
+                out[n++] = IoCompletion {cqe.user_data, cqe.res};
+                ++head;
+            }
+
+            __atomic_store_n(_cq_head, head, __ATOMIC_RELEASE);
+            return n;
+        }
+
+        bool register_(unsigned op, const void* arg, unsigned n) {
+            return ::syscall(__NR_io_uring_register, _fd, op, arg, n) == 0;
+        }
+
+    private:
+        void* _map(size_t size, off_t offset) {
+            return ::mmap(
+                nullptr,
+                size,
+                PROT_READ | PROT_WRITE,
+                MAP_SHARED | MAP_POPULATE,
+                _fd,
+                offset
+            );
+        }
+
+        void _close() {
+            if (_sqes != nullptr) {
+                ::munmap(_sqes, _sqes_size);
+                _sqes = nullptr;
+            }
+
+            if (_ring != MAP_FAILED) {
+                ::munmap(_ring, _ring_size);
+                _ring = MAP_FAILED;
+            }
+
+            if (_fd >= 0) {
+                ::close(_fd);
+                _fd = -1;
+            }
+        }
+
+        int _fd;
+        void* _ring;
+        size_t _ring_size;
+        io_uring_sqe* _sqes;
+        size_t _sqes_size;
+        unsigned _sq_tail;
+        unsigned* _sq_tail_shared;
+        unsigned _sq_mask;
+        unsigned* _sq_array;
+        unsigned* _cq_head;
+        unsigned* _cq_tail;
+        unsigned _cq_mask;
+        io_uring_cqe* _cqes;
+    };
+
+        #endif  // EFP_IO_URING
+
+}  // namespace detail
+
+// IoQueue
+// Batches reads and writes at explicit offsets of AsyncFiles. Requests are queued, handed over
+// together by submit, and their completions collected by poll or wait in any order. With io_uring
+// a batch costs one system call, otherwise it goes to a pool of worker threads. Registered files
+// and buffers let read_fixed and write_fixed skip the per request lookup and pinning of the
+// kernel. The buffers must stay valid until the completion of their request. Not thread safe.
+// Destruction submits the queued requests and waits for all of them.
+//
+//     IoQueue io {64};
+//     for (size_t i = 0; i < files.size(); ++i) {
+//         io.read(files[i], buffers[i].data(), buffers[i].size(), 0, i);
+//     }
+//     io.submit();
+//     IoCompletion done[64];
+//     while (io.in_flight() != 0) {
+//         const size_t n = io.wait(done, 64);
+//         ...
+//     }
+class IoQueue {
+public:
+    explicit IoQueue(
+        size_t depth = 256,
+        IoBackend backend = IoBackend::Auto,
+        size_t threads = 4
+    )
+        : _backend(_choose(backend)), _depth(depth == 0 ? 1 : depth), _queued(0),
+          _in_flight(0), _requests(), _fixed_fds(), _fixed_buffers(), _workers() {
+        #if defined(EFP_IO_URING)
+        // Auto falls back to the workers when the ring cannot be set up, as on a low memlock limit
+        if (_backend == IoBackend::Uring && !_uring.open(static_cast<unsigned>(_depth))) {
+            if (backend == IoBackend::Uring) {
+                throw RuntimeError("IoQueue::IoQueue: io_uring setup failed");
+            }
+            _backend = IoBackend::Threads;
+        }
+        #endif
+
+        if (_backend == IoBackend::Threads) {
+            _workers.start(threads == 0 ? 1 : threads);
+        }
+    }
+
+    IoQueue(const IoQueue&) = delete;
+
+    IoQueue& operator=(const IoQueue&) = delete;
+
+    ~IoQueue() {
+        IoCompletion done[64];
+        submit();
+        while (_in_flight != 0 && wait(done, 64) != 0) {}
+    }
+
+    // Whether the Uring backend is supported by the kernel
+    static bool uring_available() {
+        #if defined(EFP_IO_URING)
+        return detail::Uring::available();
+        #else
+        return false;
+        #endif
+    }
+
+    // Uring or Threads
+    IoBackend backend() const {
+        return _backend;
+    }
+
+    // Most requests queued and in flight together
+    size_t depth() const {
+        return _depth;
+    }
+
+    // Requests queued and not yet submitted
+    size_t queued() const {
+        return _queued;
+    }
+
+    // Requests submitted and not yet collected
+    size_t in_flight() const {
+        return _in_flight;
+    }
+
+    // Queues a read of n bytes at the offset into the buffer. False if the queue is at its depth
+    bool read(const AsyncFile& file, char* buffer, size_t n, uint64_t offset, uint64_t user_data) {
+        return _queue(detail::IoOp::Read, file.fd(), false, buffer, n, offset, user_data, -1);
+    }
+
+    // Queues a write of n bytes at the offset. False if the queue is at its depth
+    bool write(
+        const AsyncFile& file,
+        const char* data,
+        size_t n,
+        uint64_t offset,
+        uint64_t user_data
+    ) {
+        return _queue(
+            detail::IoOp::Write,
+            file.fd(),
+            false,
+            const_cast<char*>(data),
+            n,
+            offset,
+            user_data,
+            -1
+        );
+    }
+
+    // Queues a read of n bytes at the offset of a registered file into the front of a registered
+    // buffer. False if the queue is at its depth
+    bool read_fixed(size_t file, size_t buffer, size_t n, uint64_t offset, uint64_t user_data) {
+        if (!_is_fixed(file, buffer, n)) {
+            throw RuntimeError("IoQueue::read_fixed: not registered or larger than the buffer");
+        }
+
+        return _queue(
+            detail::IoOp::Read,
+            static_cast<int>(file),
+            true,
+            static_cast<char*>(_fixed_buffers[buffer].iov_base),
+            n,
+            offset,
+            user_data,
+            static_cast<int>(buffer)
+        );
+    }
+
+    // Queues a write of the first n bytes of a registered buffer at the offset of a registered
+    // file. False if the queue is at its depth
+    bool write_fixed(size_t file, size_t buffer, size_t n, uint64_t offset, uint64_t user_data) {
+        if (!_is_fixed(file, buffer, n)) {
+            throw RuntimeError("IoQueue::write_fixed: not registered or larger than the buffer");
+        }
+
+        return _queue(
+            detail::IoOp::Write,
+            static_cast<int>(file),
+            true,
+            static_cast<char*>(_fixed_buffers[buffer].iov_base),
+            n,
+            offset,
+            user_data,
+            static_cast<int>(buffer)
+        );
+    }
+
+    // Registers the files for the fixed requests by their index, replacing any earlier ones.
+    // False if requests are queued or in flight, or the kernel refused them
+    bool register_files(const Vector<AsyncFile>& files) {
+        if (_queued != 0 || _in_flight != 0) {
+            return false;
+        }
+
+        Vector<int> fds {};
+        for (size_t i = 0; i < files.size(); ++i) {
+            fds.push_back(files[i].fd());
+        }
+
+        #if defined(EFP_IO_URING)
+        if (_backend == IoBackend::Uring) {
+            if (!_fixed_fds.empty()) {
+                _uring.register_(IORING_UNREGISTER_FILES, nullptr, 0);
+                _fixed_fds.clear();
+            }
+
+            if (!fds.empty()
+                && !_uring.register_(
+                    IORING_REGISTER_FILES,
+                    fds.data(),
+                    static_cast<unsigned>(fds.size())
+                )) {
+                return false;
+            }
+        }
+        #endif
+
+        _fixed_fds = efp::move(fds);
+        return true;
+    }
+
+    // Registers the buffers for the fixed requests by their index, replacing any earlier ones.
+    // The kernel pins their pages once instead of per request. The buffers must not be resized
+    // while registered. False if requests are queued or in flight, or the kernel refused them
+    bool register_buffers(Vector<Vector<char>>& buffers) {
+        if (_queued != 0 || _in_flight != 0) {
+            return false;
+        }
+
+        Vector<iovec> iovecs {};
+        for (size_t i = 0; i < buffers.size(); ++i) {
+            iovecs.push_back(iovec {buffers[i].data(), buffers[i].size()});
+        }
+
+        #if defined(EFP_IO_URING)
+        if (_backend == IoBackend::Uring) {
+            if (!_fixed_buffers.empty()) {
+                _uring.register_(IORING_UNREGISTER_BUFFERS, nullptr, 0);
+                _fixed_buffers.clear();
+            }
+
+            if (!iovecs.empty()
+                && !_uring.register_(
+                    IORING_REGISTER_BUFFERS,
+                    iovecs.data(),
+                    static_cast<unsigned>(iovecs.size())
+                )) {
+                return false;
+            }
+        }
+        #endif
+
+        _fixed_buffers = efp::move(iovecs);
+        return true;
+    }
+
+    // Hands the queued requests over, returning how many were taken. With io_uring the kernel
+    // may take fewer, leaving the rest queued for the next submit
+    size_t submit() {
+        if (_queued == 0) {
+            return 0;
+        }
+
+        #if defined(EFP_IO_URING)
+        if (_backend == IoBackend::Uring) {
+            return _submitted(_uring.enter(static_cast<unsigned>(_queued), 0));
+        }
+        #endif
+
+        _workers.push(_requests);
+        _requests.clear();
+        return _submitted(static_cast<int>(_queued));
+    }
+
+    // Collects up to max completions without blocking
+    size_t poll(IoCompletion* out, size_t max) {
+        return _reap(out, max, 0);
+    }
+
+    // Collects the available completions into the queue without blocking. Only an unbounded
+    // queue, as a bounded one overwrites its oldest entries when full and would lose completions
+    size_t poll(NonBlockingQ<IoCompletion>& queue) {
+        IoCompletion done[64];
+        size_t total = 0;
+
+        while (true) {
+            const size_t n = poll(done, 64);
+            for (size_t i = 0; i < n; ++i) {
+                queue.enqueue(done[i]);
+            }
+
+            total += n;
+            if (n < 64) {
+                return total;
+            }
+        }
+    }
+
+    // Submits the queued requests, then collects up to max completions after at least min are
+    // available. The minimum is capped to the requests in flight, so it never waits forever
+    size_t wait(IoCompletion* out, size_t max, size_t min = 1) {
+        #if defined(EFP_IO_URING)
+        if (_backend == IoBackend::Uring) {
+            const size_t target = _min_completions(min, _in_flight + _queued);
+
+            // Submits and waits in the same system call
+            const size_t ready = poll(out, max);
+            if (ready >= target || ready == max) {
+                return ready;
+            }
+
+            const int submitted = _uring.enter(
+                static_cast<unsigned>(_queued),
+                static_cast<unsigned>(target - ready)
+            );
+            _submitted(submitted);
+            return ready + poll(out + ready, max - ready);
+        }
+        #endif
+
+        submit();
+        return _reap(out, max, _min_completions(min, _in_flight));
+    }
+
+private:
+    static IoBackend _choose(IoBackend backend) {
+        const bool uring = uring_available();
+
+        if (backend == IoBackend::Uring && !uring) {
+            throw RuntimeError("IoQueue::IoQueue: io_uring is not available");
+        }
+
+        if (backend == IoBackend::Auto) {
+            return uring ? IoBackend::Uring : IoBackend::Threads;
+        }
+
+        return backend;
+    }
+
+    static size_t _min_completions(size_t min, size_t pending) {
+        return min < pending ? min : pending;
+    }
+
+    // Whether the file and buffer are registered and the buffer holds n bytes
+    bool _is_fixed(size_t file, size_t buffer, size_t n) const {
+        return file < _fixed_fds.size() && buffer < _fixed_buffers.size()
+            && n <= _fixed_buffers[buffer].iov_len;
+    }
+
+    bool _queue(
+        detail::IoOp op,
+        int fd,
+        bool fixed,
+        char* data,
+        size_t n,
+        uint64_t offset,
+        uint64_t user_data,
+        int buffer
+    ) {
+        if (_queued + _in_flight >= _depth) {
+            return false;
+        }
+
+        if (n > detail::io_max_transfer) {
+            n = detail::io_max_transfer;
+        }
+
+        #if defined(EFP_IO_URING)
+        if (_backend == IoBackend::Uring) {
+            io_uring_sqe* sqe = _uring.push();
+
+            if (buffer >= 0) {
+                sqe->opcode = op == detail::IoOp::Read ? IORING_OP_READ_FIXED
+                                                       : IORING_OP_WRITE_FIXED;
+                sqe->buf_index = static_cast<uint16_t>(buffer);
+            } else {
+                sqe->opcode = op == detail::IoOp::Read ? IORING_OP_READ : IORING_OP_WRITE;
+            }
+
+            sqe->flags = fixed ? IOSQE_FIXED_FILE : 0;
+            sqe->fd = fd;
+            sqe->off = offset;
+            sqe->addr = reinterpret_cast<uintptr_t>(data);
+            sqe->len = static_cast<uint32_t>(n);
+            sqe->user_data = user_data;
+
+            ++_queued;
+            return true;
+        }
+        #endif
+
+        const int resolved = fixed ? _fixed_fds[static_cast<size_t>(fd)] : fd;
+        _requests.push_back(detail::IoRequest {op, resolved, data, n, offset, user_data});
+
+        ++_queued;
+        return true;
+    }
+
+    size_t _submitted(int n) {
+        if (n <= 0) {
+            return 0;
+        }
+
+        const size_t submitted = static_cast<size_t>(n);
+        _queued -= submitted;
+        _in_flight += submitted;
+        return submitted;
+    }
+
+    size_t _reap(IoCompletion* out, size_t max, size_t min) {
+        size_t n = 0;
+
+        #if defined(EFP_IO_URING)
+        if (_backend == IoBackend::Uring) {
+            n = _uring.reap(out, max);
+            _in_flight -= n;
+            return n;
+        }
+        #endif
+
+        if (_in_flight != 0) {
+            n = _workers.reap(out, max, min);
+        }
+
+        _in_flight -= n;
+        return n;
+    }
+
+    IoBackend _backend;
+    size_t _depth;
+    size_t _queued;
+    size_t _in_flight;
+    Vector<detail::IoRequest> _requests;
+    Vector<int> _fixed_fds;
+    Vector<iovec> _fixed_buffers;
+    detail::IoWorkers _workers;
+        #if defined(EFP_IO_URING)
+    detail::Uring _uring;
+        #endif
+};
+
+    #endif  // __unix__ || __APPLE__
+
+}  // namespace efp
+
+#endif  // __STDC_HOSTED__ && __STDC_HOSTED__ == 1
+
+#endif
@@ -0,0 +1,693 @@
+#ifndef EFP_BINARY_LOG_HPP_
+#define EFP_BINARY_LOG_HPP_
+
+// ! Not for freestanding environments
+#if defined(__STDC_HOSTED__) && __STDC_HOSTED__ == 1
+
+    #include <chrono>
+
+    #include "efp/cpp_core.hpp"
+    #include "efp/meta.hpp"
+    #include "efp/enum.hpp"
+    #include "efp/maybe.hpp"
+    #include "efp/sequence.hpp"
+    #include "efp/string.hpp"
+    #include "efp/hash.hpp"
+    #include "efp/hash_map.hpp"
+    #include "efp/format.hpp"
+    #include "efp/io.hpp"
+
+namespace efp {
+
+namespace detail {
+    // A log starts with the magic and a marker of the byte order of the writer
+    constexpr char binary_log_magic[8] = {'E', 'F', 'P', 'B', 'L', 'O', 'G', '1'};
+    constexpr uint32_t binary_log_byte_order = 0x01020304;
+
+    // Record kinds. A definition is written before the first message of its id
+    constexpr char binary_log_definition = 'D';
+    constexpr char binary_log_message = 'M';
+
+    // Kind, id, payload size and timestamp
+    constexpr size_t binary_log_message_header = 1 + 4 + 4 + 8;
+
+    // Type codes of the arguments in a definition. An Enum is followed by the number of its
+    // alternatives and their codes
+    enum class BinaryLogType : uint8_t {
+        Bool = 1,
+        Char,
+        I8,
+        U8,
+        I16,
+        U16,
+        I32,
+        U32,
+        I64,
+        U64,
+        F32,
+        F64,
+        String,
+        Enum,
+    };
+
+    template<typename A, BinaryLogType type>
+    struct BinaryLogScalar {
+        // Type the format string is checked against, as it is rendered
+        using Checked = A;
+
+        static void signature(Vector<uint8_t>& codes) {
+            codes.push_back(static_cast<uint8_t>(type));
+        }
+
+        template<typename B>
+        static size_t size(const B&) {
+            return sizeof(A);
+        }
+
+        template<typename B>
+        static char* encode(char* out, const B& b) {
+            const A a = static_cast<A>(b);
+            _memcpy(out, &a, sizeof(A));
+            return out + sizeof(A);
+        }
+    };
+
+    template<size_t size, bool is_signed>
+    struct BinaryLogInt;
+
+    template<>
+    struct BinaryLogInt<1, true>: BinaryLogScalar<int8_t, BinaryLogType::I8> {};
+
+    template<>
+    struct BinaryLogInt<1, false>: BinaryLogScalar<uint8_t, BinaryLogType::U8> {};
+
+    template<>
+    struct BinaryLogInt<2, true>: BinaryLogScalar<int16_t, BinaryLogType::I16> {};
+
+    template<>
+    struct BinaryLogInt<2, false>: BinaryLogScalar<uint16_t, BinaryLogType::U16> {};
+
+    template<>
+    struct BinaryLogInt<4, true>: BinaryLogScalar<int32_t, BinaryLogType::I32> {};
+
+    template<>
+    struct BinaryLogInt<4, false>: BinaryLogScalar<uint32_t, BinaryLogType::U32> {};
+
+    template<>
+    struct BinaryLogInt<8, true>: BinaryLogScalar<int64_t, BinaryLogType::I64> {};
+
+    template<>
+    struct BinaryLogInt<8, false>: BinaryLogScalar<uint64_t, BinaryLogType::U64> {};
+
+    // How an argument is encoded in a message
+    template<typename A, typename = void>
+    struct BinaryLogArg {
+        static_assert(
+            AlwaysFalse<A>::value,
+            "BinaryLog: arguments must be arithmetic, enums, strings or Enum"
+        );
+    };
+
+    template<>
+    struct BinaryLogArg<bool>: BinaryLogScalar<bool, BinaryLogType::Bool> {};
+
+    template<>
+    struct BinaryLogArg<char>: BinaryLogScalar<char, BinaryLogType::Char> {};
+
+    template<typename A>
+    struct BinaryLogArg<
+        A,
+        EnableIf<std::is_integral<A>::value && !IsSame<A, bool>::value && !IsSame<A, char>::value>>:
+        BinaryLogInt<sizeof(A), std::is_signed<A>::value> {};
+
+    // Enumerations are written as the underlying integer
+    template<typename A>
+    struct BinaryLogArg<A, EnableIf<std::is_enum<A>::value>>:
+        BinaryLogInt<sizeof(A), std::is_signed<typename std::underlying_type<A>::type>::value> {};
+
+    template<>
+    struct BinaryLogArg<float>: BinaryLogScalar<float, BinaryLogType::F32> {};
+
+    template<>
+    struct BinaryLogArg<double>: BinaryLogScalar<double, BinaryLogType::F64> {};
+
+    template<>
+    struct BinaryLogArg<long double>: BinaryLogScalar<double, BinaryLogType::F64> {};
+
+    // Strings are written as the length followed by the characters
+    struct BinaryLogString {
+        using Checked = efp_fmt::string_view;
+
+        static void signature(Vector<uint8_t>& codes) {
+            codes.push_back(static_cast<uint8_t>(BinaryLogType::String));
+        }
+
+        static size_t size_of(size_t length) {
+            return sizeof(uint32_t) + length;
+        }
+
+        static char* encode_of(char* out, const char* data, size_t length) {
+            const uint32_t n = static_cast<uint32_t>(length);
+            _memcpy(out, &n, sizeof(uint32_t));
+            _memcpy(out + sizeof(uint32_t), data, length);
+            return out + sizeof(uint32_t) + length;
+        }
+    };
+
+    template<typename A>
+    struct BinaryLogArg<A, EnableIf<IsStringLike<A>::value>>: BinaryLogString {
+        static size_t size(const A& s) {
+            return size_of(s.size());
+        }
+
+        static char* encode(char* out, const A& s) {
+            return encode_of(out, s.data(), s.size());
+        }
+    };
+
+    template<>
+    struct BinaryLogArg<const char*>: BinaryLogString {
+        static size_t size(const char* s) {
+            return size_of(std::strlen(s));
+        }
+
+        static char* encode(char* out, const char* s) {
+            return encode_of(out, s, std::strlen(s));
+        }
+    };
+
+    template<>
+    struct BinaryLogArg<char*>: BinaryLogArg<const char*> {};
+
+    template<size_t n>
+    struct BinaryLogArg<char[n]>: BinaryLogArg<const char*> {};
+
+    template<typename... As>
+    struct BinaryLogSignature;
+
+    template<>
+    struct BinaryLogSignature<> {
+        static void append(Vector<uint8_t>&) {}
+    };
+
+    template<typename A, typename... As>
+    struct BinaryLogSignature<A, As...> {
+        static void append(Vector<uint8_t>& codes) {
+            BinaryLogArg<A>::signature(codes);
+            BinaryLogSignature<As...>::append(codes);
+        }
+    };
+
+    // Stands for the alternative of an Enum in the check of a format string, accepting any spec
+    struct BinaryLogAlternative {};
+
+    // The active alternative of an Enum, found by a linear search of the index
+    template<uint8_t i, uint8_t n, typename... As>
+    struct BinaryLogEnumAlt {
+        using Alt = PackAt<i, As...>;
+
+        static size_t size(const Enum<As...>& e) {
+            return e.index() == i ? BinaryLogArg<Alt>::size(e.template get<i>())
+                                  : BinaryLogEnumAlt<i + 1, n, As...>::size(e);
+        }
+
+        static char* encode(char* out, const Enum<As...>& e) {
+            return e.index() == i ? BinaryLogArg<Alt>::encode(out, e.template get<i>())
+                                  : BinaryLogEnumAlt<i + 1, n, As...>::encode(out, e);
+        }
+    };
+
+    template<uint8_t n, typename... As>
+    struct BinaryLogEnumAlt<n, n, As...> {
+        static size_t size(const Enum<As...>&) {
+            return 0;
+        }
+
+        static char* encode(char* out, const Enum<As...>&) {
+            return out;
+        }
+    };
+
+    // The index followed by the active alternative
+    template<typename... As>
+    struct BinaryLogArg<Enum<As...>> {
+        static_assert(sizeof...(As) < 256, "BinaryLog: too many alternatives");
+
+        using Alt = BinaryLogEnumAlt<0, sizeof...(As), As...>;
+        using Checked = BinaryLogAlternative;
+
+        static void signature(Vector<uint8_t>& codes) {
+            codes.push_back(static_cast<uint8_t>(BinaryLogType::Enum));
+            codes.push_back(static_cast<uint8_t>(sizeof...(As)));
+            BinaryLogSignature<As...>::append(codes);
+        }
+
+        static size_t size(const Enum<As...>& e) {
+            return 1 + Alt::size(e);
+        }
+
+        static char* encode(char* out, const Enum<As...>& e) {
+            *out = static_cast<char>(e.index());
+            return Alt::encode(out + 1, e);
+        }
+    };
+
+    inline size_t binary_log_args_size() {
+        return 0;
+    }
+
+    template<typename A, typename... As>
+    inline size_t binary_log_args_size(const A& a, const As&... as) {
+        return BinaryLogArg<A>::size(a) + binary_log_args_size(as...);
+    }
+
+    inline char* binary_log_encode(char* out) {
+        return out;
+    }
+
+    template<typename A, typename... As>
+    inline char* binary_log_encode(char* out, const A& a, const As&... as) {
+        return binary_log_encode(BinaryLogArg<A>::encode(out, a), as...);
+    }
+
+    // Bounded reading of a record
+    struct BinaryLogCursor {
+        const char* p;
+        const char* end;
+
+        // Start of the next n bytes, null if there are not as many
+        const char* skip(size_t n) {
+            if (static_cast<size_t>(end - p) < n) {
+                return nullptr;
+            }
+
+            const char* result = p;
+            p += n;
+            return result;
+        }
+
+        bool read(void* out, size_t n) {
+            const char* from = skip(n);
+            if (from != nullptr) {
+                _memcpy(out, from, n);
+            }
+            return from != nullptr;
+        }
+    };
+}  // namespace detail
+
+// BinaryLogFormat
+// Format string of BinaryLog, checked against the arguments as they are rendered
+template<typename... Args>
+using BinaryLogFormat = FormatString<typename detail::BinaryLogArg<Args>::Checked...>;
+
+// BinaryLog
+// Log sink writing messages unformatted, as the id of the format string, a timestamp and the
+// bytes of the arguments. The format string and the types of the arguments are written once,
+// the first time they are used, so a message costs about a copy of its arguments. The log is
+// rendered later by BinaryLogReader, or by the binary_log_decode example.
+// Arguments are arithmetic values, enumerations, which are written as integers, strings, and
+// Enum of those. The format strings must outlive the log, as literals do. Not thread safe.
+//
+//     BinaryLog log {file};
+//     log.log("order {} filled at {:.2f}", id, price);
+class BinaryLog {
+public:
+    explicit BinaryLog(File& file, size_t capacity = 1 << 16)
+        : _writer(file, capacity), _ids(), _definitions(), _codes() {
+        _writer.write(detail::binary_log_magic, sizeof(detail::binary_log_magic));
+        _write_scalar(detail::binary_log_byte_order);
+    }
+
+    BinaryLog(const BinaryLog&) = delete;
+
+    BinaryLog& operator=(const BinaryLog&) = delete;
+
+    // Logs with the current time of the system clock
+    template<typename... Args>
+    bool log(BinaryLogFormat<Args...> fmt, const Args&... args) {
+        const auto now = std::chrono::system_clock::now().time_since_epoch();
+        const int64_t timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+        return log_at(timestamp, fmt, args...);
+    }
+
+    // Logs with the timestamp given in nanoseconds
+    template<typename... Args>
+    bool log_at(int64_t timestamp, BinaryLogFormat<Args...> fmt, const Args&... args) {
+        static_assert(sizeof...(Args) < 256, "BinaryLog::log: too many arguments");
+
+        const efp_fmt::string_view f = fmt;
+        const uint32_t id = _id(f.data(), f.size(), &detail::BinaryLogSignature<Args...>::append);
+
+        const size_t payload = detail::binary_log_args_size(args...);
+        const size_t size = detail::binary_log_message_header + payload;
+
+        // A message larger than the buffer is assembled aside
+        Vector<char> large {};
+        char* p = _writer.reserve(size);
+        if (p == nullptr) {
+            large.resize(size);
+            p = large.data();
+        }
+
+        const uint32_t payload_size = static_cast<uint32_t>(payload);
+        p[0] = detail::binary_log_message;
+        _memcpy(p + 1, &id, 4);
+        _memcpy(p + 5, &payload_size, 4);
+        _memcpy(p + 9, &timestamp, 8);
+        detail::binary_log_encode(p + detail::binary_log_message_header, args...);
+
+        return large.empty() ? _writer.commit(size) : _writer.write(large.data(), size);
+    }
+
+    bool flush() {
+        return _writer.flush();
+    }
+
+    // Number of distinct format strings and argument types
+    size_t definitions() const {
+        return _definitions.size();
+    }
+
+private:
+    using Signature = void (*)(Vector<uint8_t>&);
+
+    struct Definition {
+        const char* fmt;
+        Signature signature;
+    };
+
+    // Id of the format string with the argument types, defined on the first use
+    uint32_t _id(const char* fmt, size_t fmt_size, Signature signature) {
+        const uint32_t* found = _ids.find(fmt);
+        if (found != nullptr && _definitions[*found].signature == signature) {
+            return *found;
+        }
+
+        // The same string with other types, which is rare enough for a linear search
+        for (size_t i = 0; found != nullptr && i < _definitions.size(); ++i) {
+            if (_definitions[i].fmt == fmt && _definitions[i].signature == signature) {
+                return static_cast<uint32_t>(i);
+            }
+        }
+
+        const uint32_t id = static_cast<uint32_t>(_definitions.size());
+        _definitions.push_back(Definition {fmt, signature});
+        if (found == nullptr) {
+            _ids.insert(fmt, id);
+        }
+
+        // Number of arguments and their codes
+        _codes.clear();
+        _codes.push_back(0);
+        signature(_codes);
+
+        size_t count = 0;
+        for (size_t i = 1; i < _codes.size(); i = _skip_code(i)) {
+            ++count;
+        }
+        _codes[0] = static_cast<uint8_t>(count);
+
+        _writer.write(detail::binary_log_definition);
+        _write_scalar(id);
+        _write_scalar(static_cast<uint32_t>(fmt_size));
+        _writer.write(fmt, fmt_size);
+        _write_scalar(static_cast<uint32_t>(_codes.size()));
+        _writer.write(reinterpret_cast<const char*>(_codes.data()), _codes.size());
+
+        return id;
+    }
+
+    // Position after the code at i
+    size_t _skip_code(size_t i) const {
+        if (_codes[i] != static_cast<uint8_t>(detail::BinaryLogType::Enum)) {
+            return i + 1;
+        }
+
+        const size_t n = _codes[i + 1];
+        i += 2;
+        for (size_t j = 0; j < n; ++j) {
+            i = _skip_code(i);
+        }
+        return i;
+    }
+
+    template<typename A>
+    void _write_scalar(const A& a) {
+        _writer.write(reinterpret_cast<const char*>(&a), sizeof(A));
+    }
+
+    BufWriter _writer;
+    HashMap<const char*, uint32_t> _ids;
+    Vector<Definition> _definitions;
+    Vector<uint8_t> _codes;
+};
+
+// BinaryLogEntry
+// A message of a binary log, formatted
+struct BinaryLogEntry {
+    // Id of the format string with the argument types
+    uint32_t id;
+    // Nanoseconds since the epoch of the system clock
+    int64_t timestamp;
+    String text;
+};
+
+// BinaryLogReader
+// Reads the messages of a log written by BinaryLog, formatting them with efp::format. The bytes,
+// for example of a MappedFile, must outlive the reader. The log must be written on a machine of
+// the same byte order. A record cut short, as by a crash of the writer, ends the log.
+//
+//     const auto file = MappedFile::open("app.blog").move();
+//     BinaryLogReader reader {file.chars()};
+//     for (auto entry = reader.next(); entry; entry = reader.next()) { ... }
+class BinaryLogReader {
+public:
+    explicit BinaryLogReader(const VectorView<const char>& bytes)
+        : _data(bytes.data()), _size(bytes.size()), _pos(header_size), _definitions(), _args() {
+        if (_size < header_size
+            || std::memcmp(_data, detail::binary_log_magic, sizeof(detail::binary_log_magic))
+                != 0) {
+            throw RuntimeError("BinaryLogReader: not a binary log");
+        }
+
+        uint32_t byte_order;
+        _memcpy(&byte_order, _data + sizeof(detail::binary_log_magic), sizeof(uint32_t));
+        if (byte_order != detail::binary_log_byte_order) {
+            throw RuntimeError("BinaryLogReader: written with another byte order");
+        }
+    }
+
+    // The next message, nothing at the end of the log
+    Maybe<BinaryLogEntry> next() {
+        while (_pos < _size) {
+            const char kind = _data[_pos];
+
+            if (kind == detail::binary_log_definition) {
+                if (!_read_definition()) {
+                    return nothing;
+                }
+            } else if (kind == detail::binary_log_message) {
+                return _read_message();
+            } else {
+                throw RuntimeError("BinaryLogReader::next: unknown record");
+            }
+        }
+        return nothing;
+    }
+
+    // Number of definitions read so far
+    size_t definitions() const {
+        return _definitions.size();
+    }
+
+private:
+    static constexpr size_t header_size = sizeof(detail::binary_log_magic) + sizeof(uint32_t);
+
+    using Arg = efp_fmt::basic_format_arg<efp_fmt::format_context>;
+
+    struct Definition {
+        efp_fmt::string_view fmt;
+        const char* codes;
+        size_t codes_size;
+    };
+
+    bool _read_definition() {
+        detail::BinaryLogCursor c {_data + _pos + 1, _data + _size};
+
+        uint32_t id;
+        uint32_t fmt_size;
+        uint32_t codes_size;
+        const char* fmt;
+        const char* codes;
+
+        if (!c.read(&id, 4) || !c.read(&fmt_size, 4) || (fmt = c.skip(fmt_size)) == nullptr
+            || !c.read(&codes_size, 4) || (codes = c.skip(codes_size)) == nullptr) {
+            _pos = _size;
+            return false;
+        }
+
+        if (id != _definitions.size() || codes_size == 0) {
+            throw RuntimeError("BinaryLogReader::next: corrupt definition");
+        }
+
+        _definitions.push_back(Definition {efp_fmt::string_view(fmt, fmt_size), codes, codes_size});
+        _pos = static_cast<size_t>(c.p - _data);
+        return true;
+    }
+
+    Maybe<BinaryLogEntry> _read_message() {
+        detail::BinaryLogCursor c {_data + _pos + 1, _data + _size};
+
+        uint32_t id;
+        uint32_t payload_size;
+        int64_t timestamp;
+        const char* payload;
+
+        if (!c.read(&id, 4) || !c.read(&payload_size, 4) || !c.read(&timestamp, 8)
+            || (payload = c.skip(payload_size)) == nullptr) {
+            _pos = _size;
+            return nothing;
+        }
+
+        if (id >= _definitions.size()) {
+            throw RuntimeError("BinaryLogReader::next: message of an unknown format");
+        }
+
+        const Definition& d = _definitions[id];
+        detail::BinaryLogCursor codes {d.codes + 1, d.codes + d.codes_size};
+        detail::BinaryLogCursor values {payload, payload + payload_size};
+
+        const size_t count = static_cast<uint8_t>(d.codes[0]);
+        _args.clear();
+        for (size_t i = 0; i < count; ++i) {
+            _args.push_back(_decode(codes, values));
+        }
+
+        _pos = static_cast<size_t>(c.p - _data);
+
+        return BinaryLogEntry {
+            id,
+            timestamp,
+            efp_fmt::vformat(d.fmt, efp_fmt::format_args(_args.data(), static_cast<int>(count)))
+        };
+    }
+
+    template<typename A>
+    static Arg _scalar(detail::BinaryLogCursor& values) {
+        A a;
+        if (!values.read(&a, sizeof(A))) {
+            throw RuntimeError("BinaryLogReader::next: corrupt message");
+        }
+        return efp_fmt::detail::make_arg<efp_fmt::format_context>(a);
+    }
+
+    // Strings refer to the bytes of the log
+    static Arg _decode(detail::BinaryLogCursor& codes, detail::BinaryLogCursor& values) {
+        using detail::BinaryLogType;
+
+        uint8_t code = 0;
+        codes.read(&code, 1);
+
+        switch (static_cast<BinaryLogType>(code)) {
+            case BinaryLogType::Bool:
+                return _scalar<bool>(values);
+            case BinaryLogType::Char:
+                return _scalar<char>(values);
+            case BinaryLogType::I8:
+                return _scalar<int8_t>(values);
+            case BinaryLogType::U8:
+                return _scalar<uint8_t>(values);
+            case BinaryLogType::I16:
+                return _scalar<int16_t>(values);
+            case BinaryLogType::U16:
+                return _scalar<uint16_t>(values);
+            case BinaryLogType::I32:
+                return _scalar<int32_t>(values);
+            case BinaryLogType::U32:
+                return _scalar<uint32_t>(values);
+            case BinaryLogType::I64:
+                return _scalar<int64_t>(values);
+            case BinaryLogType::U64:
+                return _scalar<uint64_t>(values);
+            case BinaryLogType::F32:
+                return _scalar<float>(values);
+            case BinaryLogType::F64:
+                return _scalar<double>(values);
+            case BinaryLogType::String: {
+                uint32_t length;
+                const char* s;
+                if (!values.read(&length, 4) || (s = values.skip(length)) == nullptr) {
+                    throw RuntimeError("BinaryLogReader::next: corrupt message");
+                }
+
+                efp_fmt::string_view view {s, length};
+                return efp_fmt::detail::make_arg<efp_fmt::format_context>(view);
+            }
+            case BinaryLogType::Enum: {
+                uint8_t n = 0;
+                uint8_t index = 0;
+                codes.read(&n, 1);
+                if (!values.read(&index, 1) || index >= n) {
+                    throw RuntimeError("BinaryLogReader::next: corrupt message");
+                }
+
+                Arg active {};
+                for (uint8_t i = 0; i < n; ++i) {
+                    if (i == index) {
+                        active = _decode(codes, values);
+                    } else {
+                        _skip(codes);
+                    }
+                }
+                return active;
+            }
+            default:
+                throw RuntimeError("BinaryLogReader::next: corrupt definition");
+        }
+    }
+
+    static void _skip(detail::BinaryLogCursor& codes) {
+        uint8_t code = 0;
+        codes.read(&code, 1);
+
+        if (code == static_cast<uint8_t>(detail::BinaryLogType::Enum)) {
+            uint8_t n = 0;
+            codes.read(&n, 1);
+            for (uint8_t i = 0; i < n; ++i) {
+                _skip(codes);
+            }
+        }
+    }
+
+    const char* _data;
+    size_t _size;
+    size_t _pos;
+    Vector<Definition> _definitions;
+    Vector<Arg> _args;
+};
+
+}  // namespace efp
+
+// Specialize efp_fmt::formatter for the alternatives of Enum in BinaryLogFormat. Only parses
+template<>
+struct efp_fmt::formatter<efp::detail::BinaryLogAlternative> {
+    template<typename ParseContext>
+    EFP_FMT_CONSTEXPR auto parse(ParseContext& ctx) const -> decltype(ctx.begin()) {
+        auto it = ctx.begin();
+        while (it != ctx.end() && *it != '}') {
+            ++it;
+        }
+        return it;
+    }
+
+    template<typename FormatContext>
+    auto format(const efp::detail::BinaryLogAlternative&, FormatContext& ctx) const
+        -> decltype(ctx.out()) {
+        return ctx.out();
+    }
+};
+
+#endif  // __STDC_HOSTED__ && __STDC_HOSTED__ == 1
+
+#endif
@@ -0,0 +1,340 @@
+#ifndef EFP_CHUNKED_HPP_
+#define EFP_CHUNKED_HPP_
+
+#include "efp/cpp_core.hpp"
+#include "efp/allocator.hpp"
+#include "efp/sequence.hpp"
+
+namespace efp {
+
+namespace detail {
+    constexpr size_t ct_log2(size_t n) {
+        return n <= 1 ? 0 : 1 + ct_log2(n >> 1);
+    }
+}  // namespace detail
+
+// ChunkedVector
+// Growable sequence allocating fixed-size chunks of ct_chunk elements.
+// Existing elements are never moved, so references and pointers stay valid on append.
+// Indexing is O(1) through the chunk table. Storage is not contiguous across chunks, hence data()
+// is not provided. Use chunk(i) to process contiguous blocks one by one.
+template<typename A, size_t ct_chunk = 1024, typename Allocator = detail::DefaultAllocator<A>>
+class ChunkedVector {
+public:
+    static_assert(ct_chunk > 0 && (ct_chunk & (ct_chunk - 1)) == 0, "Chunk size must be a power of two");
+
+    using Element = A;
+    using CtSize = Size<dyn>;
+    using CtCapacity = Size<dyn>;
+
+    // STL compatible types
+    using value_type = Element;
+    using allocator_type = Allocator;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+
+    static constexpr size_t chunk_size = ct_chunk;
+
+    template<typename B>
+    class IteratorBase {
+    public:
+        using value_type = ConstRemoved<B>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = B*;
+        using reference = B&;
+        using iterator_category = std::forward_iterator_tag;
+
+        IteratorBase(B* const* chunks, size_t index) : _chunks(chunks), _index(index) {}
+
+        B& operator*() const {
+            return _chunks[_index >> _shift][_index & _mask];
+        }
+
+        B* operator->() const {
+            return &**this;
+        }
+
+        IteratorBase& operator++() {
+            ++_index;
+            return *this;
+        }
+
+        IteratorBase operator++(int) {
+            IteratorBase tmp = *this;
+            ++_index;
+            return tmp;
+        }
+
+        bool operator==(const IteratorBase& other) const {
+            return _index == other._index;
+        }
+
+        bool operator!=(const IteratorBase& other) const {
+            return _index != other._index;
+        }
+
+    private:
+        B* const* _chunks;
+        size_t _index;
+    };
+
+    using iterator = IteratorBase<A>;
+    using const_iterator = IteratorBase<const A>;
+
+    ChunkedVector() : _allocator(Allocator()), _chunks(), _size(0) {}
+
+    explicit ChunkedVector(const Allocator& alloc) : _allocator(alloc), _chunks(), _size(0) {}
+
+    ChunkedVector(const ChunkedVector& other)
+        : _allocator(other._allocator), _chunks(), _size(0) {
+        reserve(other._size);
+
+        for (size_t i = 0; i < other._size; ++i) {
+            push_back(other[i]);
+        }
+    }
+
+    ChunkedVector& operator=(const ChunkedVector& other) {
+        if (this != &other) {
+            clear();
+            reserve(other._size);
+
+            for (size_t i = 0; i < other._size; ++i) {
+                push_back(other[i]);
+            }
+        }
+
+        return *this;
+    }
+
+    ChunkedVector(ChunkedVector&& other) noexcept
+        : _allocator(other._allocator), _chunks(efp::move(other._chunks)), _size(other._size) {
+        other._size = 0;
+    }
+
+    ChunkedVector& operator=(ChunkedVector&& other) noexcept {
+        if (this != &other) {
+            _release();
+
+            _allocator = other._allocator;
+            _chunks = efp::move(other._chunks);
+            _size = other._size;
+
+            other._size = 0;
+        }
+
+        return *this;
+    }
+
+    ChunkedVector(InitializerList<Element> il) : _allocator(Allocator()), _chunks(), _size(0) {
+        reserve(il.size());
+
+        for (const auto& e : il) {
+            push_back(e);
+        }
+    }
+
+    ~ChunkedVector() {
+        _release();
+    }
+
+    Element& operator[](size_t index) {
+        return _chunks[index >> _shift][index & _mask];
+    }
+
+    const Element& operator[](size_t index) const {
+        return _chunks[index >> _shift][index & _mask];
+    }
+
+    bool operator==(const ChunkedVector& other) const {
+        if (_size != other._size) {
+            return false;
+        }
+
+        for (size_t i = 0; i < _size; ++i) {
+            if ((*this)[i] != other[i]) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    size_t size() const {
+        return _size;
+    }
+
+    size_t capacity() const {
+        return _chunks.size() * ct_chunk;
+    }
+
+    bool empty() const {
+        return _size == 0;
+    }
+
+    // Allocate chunks in advance. Never moves the existing elements.
+    void reserve(size_t new_capacity) {
+        while (capacity() < new_capacity) {
+            _chunks.push_back(AllocatorTraits<Allocator>::allocate(_allocator, ct_chunk));
+        }
+    }
+
+    void push_back(const Element& value) {
+        _grow_if_full();
+        AllocatorTraits<Allocator>::construct(_allocator, &(*this)[_size], value);
+        ++_size;
+    }
+
+    void push_back(Element&& value) {
+        _grow_if_full();
+        AllocatorTraits<Allocator>::construct(_allocator, &(*this)[_size], efp::move(value));
+        ++_size;
+    }
+
+    template<typename... Args>
+    void emplace_back(Args&&... args) {
+        _grow_if_full();
+        AllocatorTraits<Allocator>::construct(
+            _allocator,
+            &(*this)[_size],
+            efp::forward<Args>(args)...
+        );
+        ++_size;
+    }
+
+    void pop_back() {
+        if (_size == 0) {
+            throw RuntimeError("ChunkedVector::pop_back: size must be greater than 0");
+        }
+
+        AllocatorTraits<Allocator>::destroy(_allocator, &(*this)[--_size]);
+    }
+
+    // Destroy all the elements but keep the chunks for reuse
+    void clear() {
+        for (size_t i = 0; i < _size; ++i) {
+            AllocatorTraits<Allocator>::destroy(_allocator, &(*this)[i]);
+        }
+        _size = 0;
+    }
+
+    Element& front() {
+        return (*this)[0];
+    }
+
+    const Element& front() const {
+        return (*this)[0];
+    }
+
+    Element& back() {
+        return (*this)[_size - 1];
+    }
+
+    const Element& back() const {
+        return (*this)[_size - 1];
+    }
+
+    // Number of chunks holding at least one element
+    size_t chunk_count() const {
+        return (_size + ct_chunk - 1) >> _shift;
+    }
+
+    // Contiguous view of the i-th chunk. Only the last chunk could be partially filled.
+    VectorView<const Element> chunk(size_t i) const {
+        return VectorView<const Element>(_chunks[i], _chunk_length(i));
+    }
+
+    VectorView<Element> chunk(size_t i) {
+        return VectorView<Element>(_chunks[i], _chunk_length(i));
+    }
+
+    iterator begin() {
+        return iterator(_chunks.data(), 0);
+    }
+
+    const_iterator begin() const {
+        return const_iterator(_chunks.data(), 0);
+    }
+
+    iterator end() {
+        return iterator(_chunks.data(), _size);
+    }
+
+    const_iterator end() const {
+        return const_iterator(_chunks.data(), _size);
+    }
+
+private:
+    static constexpr size_t _shift = detail::ct_log2(ct_chunk);
+    static constexpr size_t _mask = ct_chunk - 1;
+
+    size_t _chunk_length(size_t i) const {
+        const size_t begin = i << _shift;
+        return _size - begin < ct_chunk ? _size - begin : ct_chunk;
+    }
+
+    void _grow_if_full() {
+        if (_size == capacity()) {
+            _chunks.push_back(AllocatorTraits<Allocator>::allocate(_allocator, ct_chunk));
+        }
+    }
+
+    void _release() {
+        clear();
+
+        for (size_t i = 0; i < _chunks.size(); ++i) {
+            AllocatorTraits<Allocator>::deallocate(_allocator, _chunks[i], ct_chunk);
+        }
+        _chunks.clear();
+    }
+
+    Allocator _allocator;
+    Vector<Element*> _chunks;
+    size_t _size;
+};
+
+template<typename A, size_t n, typename Allocator>
+struct ElementImpl<ChunkedVector<A, n, Allocator>> {
+    using Type = A;
+};
+
+template<typename A, size_t n, typename Allocator>
+struct CtSizeImpl<ChunkedVector<A, n, Allocator>> {
+    using Type = Size<dyn>;
+};
+
+template<typename A, size_t n, typename Allocator>
+struct CtCapacityImpl<ChunkedVector<A, n, Allocator>> {
+    using Type = Size<dyn>;
+};
+
+template<typename A, size_t n, typename Allocator>
+constexpr auto length(const ChunkedVector<A, n, Allocator>& as) -> size_t {
+    return as.size();
+}
+
+template<typename A, size_t n, typename Allocator>
+constexpr auto nth(size_t i, const ChunkedVector<A, n, Allocator>& as) -> const A& {
+    return as[i];
+}
+
+template<typename A, size_t n, typename Allocator>
+constexpr auto nth(size_t i, ChunkedVector<A, n, Allocator>& as) -> A& {
+    return as[i];
+}
+
+// for_each_chunk :: (VectorView<A> -> void) -> ChunkedVector<A> -> void
+template<typename A, size_t n, typename Allocator, typename F>
+void for_each_chunk(const F& f, const ChunkedVector<A, n, Allocator>& as) {
+    const size_t chunk_count = as.chunk_count();
+
+    for (size_t i = 0; i < chunk_count; ++i) {
+        f(as.chunk(i));
+    }
+}
+
+}  // namespace efp
+
+#endif
@@ -12,6 +12,7 @@
     #include "efp/cpp_core.hpp"
     #include "efp/maybe.hpp"
     #include "efp/cyclic.hpp"
+    #include "efp/pool.hpp"
 
 namespace efp {
 
@@ -26,6 +27,25 @@ inline Arc<A> arc(A&& a) {
     return std::make_shared<A>(std::forward<A>(a));
 };
 
+// arc_block_size
+// Block size of BlockPool enough to hold the shared control block with A embedded.
+// Covers the layouts of libstdc++ and libc++, which are vtable pointer, two counters, allocator
+// and the value. Larger control blocks still work, falling back to the global heap.
+template<typename A>
+constexpr size_t arc_block_size() {
+    return sizeof(A) + 4 * sizeof(void*) + alignof(A);
+}
+
+// arc_in
+// Allocate the value and the control block of Arc in a single block of the pool
+template<typename A, size_t blocks_per_chunk>
+inline Arc<CVRefRemoved<A>> arc_in(BlockPool<blocks_per_chunk>& pool, A&& a) {
+    return std::allocate_shared<CVRefRemoved<A>>(
+        PoolAllocator<CVRefRemoved<A>, blocks_per_chunk>(pool),
+        std::forward<A>(a)
+    );
+}
+
 template<typename A, size_t capacity = dyn>
 class BlockingQ {
 public:
@@ -4,6 +4,7 @@
 // C++ 11 Freestanding headers specified by N3242=11-0012
 
 #include <cstddef>  // Defines int, ptrdiff_t, and nullptr_t
+#include <cstdint>  // Defines fixed width integer types and uintptr_t
 #include <limits>   // Defines numeric limits
 #include <cstdlib>  // Defines general utilities: memory management, program utilities, string conversions, random numbers, and more.
 #include <new>  // Defines operator new and operator delete, which can be overridden for custom memory management.
@@ -0,0 +1,658 @@
+#ifndef EFP_CSV_HPP_
+#define EFP_CSV_HPP_
+
+// ! Not for freestanding environments
+#if defined(__STDC_HOSTED__) && __STDC_HOSTED__ == 1
+
+    #include <cstdlib>
+    #include <limits>
+
+    #include "efp/cpp_core.hpp"
+    #include "efp/meta.hpp"
+    #include "efp/maybe.hpp"
+    #include "efp/sequence.hpp"
+    #include "efp/string.hpp"
+
+    #if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        #include <emmintrin.h>
+        #define EFP_CSV_SSE2
+    #elif defined(__ARM_NEON) && defined(__aarch64__)
+        #include <arm_neon.h>
+        #define EFP_CSV_NEON
+    #endif
+
+namespace efp {
+
+namespace detail {
+    constexpr size_t csv_block_size = 64;
+
+    inline size_t csv_lowest_bit(uint64_t mask) {
+    #if defined(__GNUC__) || defined(__clang__)
+        return static_cast<size_t>(__builtin_ctzll(static_cast<unsigned long long>(mask)));
+    #else
+        size_t i = 0;
+        while (!(mask & 1u)) {
+            mask >>= 1;
+            ++i;
+        }
+        return i;
+    #endif
+    }
+
+    inline bool csv_odd_bits(uint64_t mask) {
+    #if defined(__GNUC__) || defined(__clang__)
+        return __builtin_parityll(static_cast<unsigned long long>(mask)) != 0;
+    #else
+        mask ^= mask >> 32;
+        mask ^= mask >> 16;
+        mask ^= mask >> 8;
+        mask ^= mask >> 4;
+        mask ^= mask >> 2;
+        mask ^= mask >> 1;
+        return (mask & 1u) != 0;
+    #endif
+    }
+
+    #if defined(EFP_CSV_NEON)
+    inline uint64_t csv_movemask(uint8x16_t eq) {
+        static const uint8_t bits[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+        const uint8x16_t masked = vandq_u8(eq, vld1q_u8(bits));
+        return static_cast<uint64_t>(vaddv_u8(vget_low_u8(masked)))
+            | (static_cast<uint64_t>(vaddv_u8(vget_high_u8(masked))) << 8);
+    }
+    #endif
+
+    // Bit masks of the quotes, and of the delimiters and newlines, among the 64 bytes at p
+    inline void csv_classify(
+        const char* p,
+        char delimiter,
+        uint64_t& quotes,
+        uint64_t& separators
+    ) {
+        quotes = 0;
+        separators = 0;
+
+    #if defined(EFP_CSV_SSE2)
+        const __m128i quote = _mm_set1_epi8('"');
+        const __m128i delim = _mm_set1_epi8(delimiter);
+        const __m128i newline = _mm_set1_epi8('\n');
+
+        for (size_t i = 0; i < csv_block_size; i += 16) {
+            const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+            const __m128i separator =
+                _mm_or_si128(_mm_cmpeq_epi8(bytes, delim), _mm_cmpeq_epi8(bytes, newline));
+
+            quotes |= static_cast<uint64_t>(
+                          static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, quote)))
+                      )
+                << i;
+            separators |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(separator)))
+                << i;
+        }
+
+    #elif defined(EFP_CSV_NEON)
+        const uint8x16_t quote = vdupq_n_u8('"');
+        const uint8x16_t delim = vdupq_n_u8(static_cast<uint8_t>(delimiter));
+        const uint8x16_t newline = vdupq_n_u8('\n');
+
+        for (size_t i = 0; i < csv_block_size; i += 16) {
+            const uint8x16_t bytes = vld1q_u8(reinterpret_cast<const uint8_t*>(p + i));
+            const uint8x16_t separator = vorrq_u8(vceqq_u8(bytes, delim), vceqq_u8(bytes, newline));
+
+            quotes |= csv_movemask(vceqq_u8(bytes, quote)) << i;
+            separators |= csv_movemask(separator) << i;
+        }
+
+    #else
+        for (size_t i = 0; i < csv_block_size; ++i) {
+            quotes |= static_cast<uint64_t>(p[i] == '"') << i;
+            separators |= static_cast<uint64_t>(p[i] == delimiter || p[i] == '\n') << i;
+        }
+    #endif
+    }
+
+    // Bits of the bytes after an odd number of quotes, by prefix XOR. An opening quote and the
+    // content are inside, the closing quote is not, and an escaped quote flips twice
+    inline uint64_t csv_inside_quotes(uint64_t quotes) {
+        quotes ^= quotes << 1;
+        quotes ^= quotes << 2;
+        quotes ^= quotes << 4;
+        quotes ^= quotes << 8;
+        quotes ^= quotes << 16;
+        quotes ^= quotes << 32;
+        return quotes;
+    }
+
+    // Whether the n bytes at p hold an odd number of quotes
+    inline bool csv_odd_quotes(const char* p, size_t n, char delimiter) {
+        bool odd = false;
+        size_t i = 0;
+
+        for (; i + csv_block_size <= n; i += csv_block_size) {
+            uint64_t quotes;
+            uint64_t separators;
+            csv_classify(p + i, delimiter, quotes, separators);
+            odd = odd != csv_odd_bits(quotes);
+        }
+
+        for (; i < n; ++i) {
+            odd = odd != (p[i] == '"');
+        }
+
+        return odd;
+    }
+
+    // CsvScanner
+    // Finds the delimiters and newlines outside quotes, a block of 64 bytes at a time. The
+    // classification is carried across blocks by the quote state at the end of the block
+    class CsvScanner {
+    public:
+        CsvScanner(const char* data, size_t size, char delimiter, size_t begin, bool inside)
+            : _data(data), _size(size), _delimiter(delimiter), _block(begin), _separators(0),
+              _carry(inside ? ~uint64_t(0) : 0) {
+            _load();
+        }
+
+        // Offset of the next delimiter or newline outside quotes, the size at the end
+        size_t next() {
+            while (_separators == 0) {
+                if (_size - _block <= csv_block_size) {
+                    return _size;
+                }
+
+                _block += csv_block_size;
+                _load();
+            }
+
+            const size_t offset = _block + csv_lowest_bit(_separators);
+            _separators &= _separators - 1;
+            return offset;
+        }
+
+    private:
+        void _load() {
+            uint64_t quotes;
+            const size_t n = _size - _block;
+
+            if (n >= csv_block_size) {
+                csv_classify(_data + _block, _delimiter, quotes, _separators);
+            } else {
+                // The tail is classified out of a copy padded with zeros, masked off after
+                char tail[csv_block_size] = {};
+                _memcpy(tail, _data + _block, n);
+                csv_classify(tail, _delimiter, quotes, _separators);
+
+                const uint64_t valid = (uint64_t(1) << n) - 1;
+                quotes &= valid;
+                _separators &= valid;
+            }
+
+            const uint64_t inside = csv_inside_quotes(quotes) ^ _carry;
+            _carry = (inside >> 63) != 0 ? ~uint64_t(0) : 0;
+            _separators &= ~inside;
+        }
+
+        const char* _data;
+        size_t _size;
+        char _delimiter;
+        size_t _block;
+        uint64_t _separators;
+        uint64_t _carry;
+    };
+
+    // The field without the carriage return of a CRLF line ending and without enclosing quotes
+    inline StringView csv_unquote(const char* p, size_t n) {
+        if (n != 0 && p[n - 1] == '\r') {
+            --n;
+        }
+
+        if (n >= 2 && p[0] == '"' && p[n - 1] == '"') {
+            return StringView(p + 1, n - 2);
+        }
+
+        return StringView(p, n);
+    }
+
+    inline double csv_strto(const char* s, char** end, double) {
+        return std::strtod(s, end);
+    }
+
+    inline float csv_strto(const char* s, char** end, float) {
+        return std::strtof(s, end);
+    }
+
+    inline long double csv_strto(const char* s, char** end, long double) {
+        return std::strtold(s, end);
+    }
+
+    // Numbers the fast path does not take, such as long mantissas, large exponents, inf and nan
+    template<typename A>
+    inline A csv_parse_float_slow(const char* p, size_t n) {
+        char local[64];
+        String heap {};
+        char* s = local;
+
+        if (n >= sizeof(local)) {
+            heap.resize(n);
+            s = heap.data();
+        }
+
+        _memcpy(s, p, n);
+        s[n] = '\0';
+
+        char* end = nullptr;
+        const A value = csv_strto(s, &end, A(0));
+        if (n == 0 || end != s + n) {
+            throw RuntimeError("CsvReader: invalid number");
+        }
+
+        return value;
+    }
+
+    // Largest mantissa and power of ten both exactly representable, so that their product or
+    // quotient is correctly rounded
+    template<typename A>
+    struct CsvFloat;
+
+    template<>
+    struct CsvFloat<double> {
+        static constexpr uint64_t max_mantissa() {
+            return uint64_t(1) << 53;
+        }
+
+        static constexpr int max_exponent() {
+            return 22;
+        }
+    };
+
+    template<>
+    struct CsvFloat<float> {
+        static constexpr uint64_t max_mantissa() {
+            return uint64_t(1) << 24;
+        }
+
+        static constexpr int max_exponent() {
+            return 10;
+        }
+    };
+
+    // Long double is always parsed by strtold
+    template<>
+    struct CsvFloat<long double> {
+        static constexpr uint64_t max_mantissa() {
+            return 0;
+        }
+
+        static constexpr int max_exponent() {
+            return 0;
+        }
+    };
+
+    // Decimal digits, a fraction and an exponent. Exact mantissas times exact powers of ten are
+    // computed directly, the rest is left to strtod
+    template<typename A>
+    inline A csv_parse_float(const char* p, size_t n) {
+        static const A powers[] = {
+            A(1e0),  A(1e1),  A(1e2),  A(1e3),  A(1e4),  A(1e5),  A(1e6),  A(1e7),
+            A(1e8),  A(1e9),  A(1e10), A(1e11), A(1e12), A(1e13), A(1e14), A(1e15),
+            A(1e16), A(1e17), A(1e18), A(1e19), A(1e20), A(1e21), A(1e22),
+        };
+
+        const char* q = p;
+        const char* end = p + n;
+
+        const bool negative = q != end && *q == '-';
+        if (q != end && (*q == '-' || *q == '+')) {
+            ++q;
+        }
+
+        uint64_t mantissa = 0;
+        int digits = 0;
+        int exponent = 0;
+
+        for (; q != end && static_cast<unsigned>(*q - '0') <= 9; ++q, ++digits) {
+            mantissa = 10 * mantissa + static_cast<unsigned>(*q - '0');
+        }
+
+        if (q != end && *q == '.') {
+            for (++q; q != end && static_cast<unsigned>(*q - '0') <= 9; ++q, ++digits) {
+                mantissa = 10 * mantissa + static_cast<unsigned>(*q - '0');
+                --exponent;
+            }
+        }
+
+        if (q != end && (*q == 'e' || *q == 'E') && digits != 0) {
+            ++q;
+
+            const bool exponent_negative = q != end && *q == '-';
+            if (q != end && (*q == '-' || *q == '+')) {
+                ++q;
+            }
+
+            // Only small exponents take the fast path, so larger ones are not accumulated
+            int e = 0;
+            const char* e_begin = q;
+            for (; q != end && static_cast<unsigned>(*q - '0') <= 9; ++q) {
+                e = e < 1000 ? 10 * e + (*q - '0') : e;
+            }
+
+            exponent += q == e_begin ? 1000 : exponent_negative ? -e : e;
+        }
+
+        const int magnitude = exponent < 0 ? -exponent : exponent;
+
+        if (q != end || digits == 0 || digits > 19 || mantissa > CsvFloat<A>::max_mantissa()
+            || magnitude > CsvFloat<A>::max_exponent()) {
+            return csv_parse_float_slow<A>(p, n);
+        }
+
+        A value = static_cast<A>(mantissa);
+        value = exponent < 0 ? value / powers[magnitude] : value * powers[magnitude];
+        return negative ? -value : value;
+    }
+
+    // Parses a field into a column of A
+    template<typename A, typename = void>
+    struct CsvField;
+
+    // An optional sign and decimal digits, throwing on overflow
+    template<typename A>
+    struct CsvField<A, EnableIf<std::is_integral<A>::value && !IsSame<A, bool>::value>> {
+        static A parse(const StringView& field) {
+            using Unsigned = typename std::make_unsigned<A>::type;
+
+            const char* p = field.data();
+            const char* end = p + field.size();
+
+            const bool negative = p != end && *p == '-';
+            if (p != end && (*p == '-' || *p == '+')) {
+                ++p;
+            }
+
+            if (p == end || (negative && !std::is_signed<A>::value)) {
+                throw RuntimeError("CsvReader: invalid integer");
+            }
+
+            const Unsigned limit = negative
+                ? static_cast<Unsigned>(static_cast<Unsigned>(std::numeric_limits<A>::max()) + 1)
+                : static_cast<Unsigned>(std::numeric_limits<A>::max());
+
+            // Up to digits10 digits cannot overflow, so only longer numbers check each digit
+            const bool short_number =
+                end - p <= static_cast<ptrdiff_t>(std::numeric_limits<Unsigned>::digits10);
+
+            Unsigned value = 0;
+            for (; p != end; ++p) {
+                const unsigned digit = static_cast<unsigned>(*p - '0');
+                if (digit > 9 || (!short_number && value > (limit - digit) / 10)) {
+                    throw RuntimeError("CsvReader: invalid integer");
+                }
+
+                value = static_cast<Unsigned>(10 * value + digit);
+            }
+
+            if (value > limit) {
+                throw RuntimeError("CsvReader: invalid integer");
+            }
+
+            return negative ? static_cast<A>(static_cast<Unsigned>(0) - value)
+                            : static_cast<A>(value);
+        }
+    };
+
+    template<typename A>
+    struct CsvField<A, EnableIf<std::is_floating_point<A>::value>> {
+        static A parse(const StringView& field) {
+            return csv_parse_float<A>(field.data(), field.size());
+        }
+    };
+
+    // In place, with the escaped quotes of a quoted field left doubled
+    template<>
+    struct CsvField<StringView> {
+        static StringView parse(const StringView& field) {
+            return field;
+        }
+    };
+
+    // A copy, with the escaped quotes of a quoted field undoubled
+    template<>
+    struct CsvField<String> {
+        static String parse(const StringView& field) {
+            String s {};
+            s.reserve(field.size());
+
+            for (size_t i = 0; i < field.size(); ++i) {
+                s.push_back(field[i]);
+                if (field[i] == '"' && i + 1 < field.size() && field[i + 1] == '"') {
+                    ++i;
+                }
+            }
+
+            return s;
+        }
+    };
+
+    // Nothing for an empty field
+    template<typename A>
+    struct CsvField<Maybe<A>> {
+        static Maybe<A> parse(const StringView& field) {
+            if (field.empty()) {
+                return nothing;
+            }
+
+            return CsvField<A>::parse(field);
+        }
+    };
+}  // namespace detail
+
+class CsvReader;
+
+// CsvTable
+// Records of a CSV as a column per field, of numbers, StringViews into the input, Strings, or
+// Maybe of those for fields which may be empty.
+template<typename... As>
+class CsvTable {
+public:
+    static_assert(sizeof...(As) != 0, "CsvTable: at least one column");
+
+    CsvTable() : _columns(Vector<As>()...) {}
+
+    // Number of records
+    size_t size() const {
+        return _columns.template get<0>().size();
+    }
+
+    template<size_t i>
+    const Vector<PackAt<i, As...>>& column() const {
+        return _columns.template get<i>();
+    }
+
+    template<size_t i>
+    Vector<PackAt<i, As...>>& column() {
+        return _columns.template get<i>();
+    }
+
+    // Appends the records of the table, as parsed from a later chunk
+    void append(const CsvTable& other) {
+        _append(other, Size<0> {});
+    }
+
+private:
+    friend class CsvReader;
+
+    template<size_t i>
+    void _append(const CsvTable& other, Size<i>) {
+        Vector<PackAt<i, As...>>& column = _columns.template get<i>();
+        const Vector<PackAt<i, As...>>& from = other._columns.template get<i>();
+
+        column.reserve(column.size() + from.size());
+        for (size_t j = 0; j < from.size(); ++j) {
+            column.push_back(from[j]);
+        }
+
+        _append(other, Size<i + 1> {});
+    }
+
+    void _append(const CsvTable&, Size<sizeof...(As)>) {}
+
+    Tuple<Vector<As>...> _columns;
+};
+
+// CsvReader
+// Parses CSV in memory, such as a MappedFile, without a String per line or field. Delimiters,
+// quotes and newlines are classified 64 bytes at a time with SIMD, and delimiters and newlines
+// inside quotes are masked out. Fields may be quoted, with quotes escaped by doubling, and lines
+// may end with CRLF. read parses numbers straight into typed columns, while text fields are
+// StringViews into the input, valid as long as it is. Blank lines are skipped, and fields past
+// the columns are ignored. Throws on too few fields or a malformed number.
+//
+//     const auto file = MappedFile::open("trades.csv").move();
+//     CsvReader reader {file.chars()};
+//     reader.skip();
+//     const auto table = reader.read<int64_t, StringView, double>();
+//     const Vector<double>& prices = table.column<2>();
+//
+// For multiple threads, chunks splits the input at record boundaries. Each chunk is read by its
+// own CsvReader and the tables appended in order.
+class CsvReader {
+public:
+    explicit CsvReader(const VectorView<const char>& bytes, char delimiter = ',')
+        : _data(bytes.data()), _size(bytes.size()), _pos(0),
+          _scanner(bytes.data(), bytes.size(), delimiter, 0, false) {}
+
+    bool done() const {
+        return _pos >= _size;
+    }
+
+    // Skips the next record, such as a header. False at the end
+    bool skip() {
+        if (done()) {
+            return false;
+        }
+
+        bool last = false;
+        while (!last) {
+            _field(last);
+        }
+        return true;
+    }
+
+    // Fields of the next record, unquoted, replacing the contents of the vector. False at the end
+    bool next(Vector<StringView>& fields) {
+        fields.clear();
+        if (done()) {
+            return false;
+        }
+
+        bool last = false;
+        while (!last) {
+            fields.push_back(_field(last));
+        }
+        return true;
+    }
+
+    // Parses the remaining records into columns of the types, a field per column in order
+    template<typename... As>
+    CsvTable<As...> read() {
+        CsvTable<As...> table {};
+
+        while (!done()) {
+            bool last = false;
+            const StringView first = _field(last);
+
+            if (last && first.empty()) {
+                continue;
+            }
+
+            Tuple<Vector<As>...>& columns = table._columns;
+            columns.template get<0>().push_back(detail::CsvField<PackAt<0, As...>>::parse(first));
+            _read_fields<1>(columns, last);
+
+            while (!last) {
+                _field(last);
+            }
+        }
+
+        return table;
+    }
+
+    // Splits the bytes into up to n chunks of about the same size, each ending after a newline
+    // outside quotes but the last
+    static Vector<VectorView<const char>> chunks(
+        const VectorView<const char>& bytes,
+        size_t n,
+        char delimiter = ','
+    ) {
+        const char* data = bytes.data();
+        const size_t size = bytes.size();
+
+        Vector<VectorView<const char>> result {};
+        size_t begin = 0;
+
+        for (size_t i = 1; i < n && begin < size; ++i) {
+            const size_t target = size / n * i + size % n * i / n;
+            if (target <= begin) {
+                continue;
+            }
+
+            // A chunk begins outside quotes, so the quotes up to the target tell if it is inside
+            const bool inside = detail::csv_odd_quotes(data + begin, target - begin, delimiter);
+            detail::CsvScanner scanner {data, size, delimiter, target, inside};
+
+            size_t end = scanner.next();
+            while (end < size && data[end] != '\n') {
+                end = scanner.next();
+            }
+
+            if (end >= size) {
+                break;
+            }
+
+            result.push_back(VectorView<const char>(data + begin, end + 1 - begin));
+            begin = end + 1;
+        }
+
+        if (begin < size) {
+            result.push_back(VectorView<const char>(data + begin, size - begin));
+        }
+
+        return result;
+    }
+
+private:
+    // The field up to the next separator, and whether it ends the record
+    StringView _field(bool& last) {
+        const size_t begin = _pos;
+        const size_t end = _scanner.next();
+
+        last = end >= _size || _data[end] == '\n';
+        _pos = end + 1;
+        return detail::csv_unquote(_data + begin, end - begin);
+    }
+
+    template<size_t i, typename... As>
+    EnableIf<(i < sizeof...(As))> _read_fields(Tuple<Vector<As>...>& columns, bool& last) {
+        if (last) {
+            throw RuntimeError("CsvReader::read: too few fields");
+        }
+
+        const StringView field = _field(last);
+        columns.template get<i>().push_back(detail::CsvField<PackAt<i, As...>>::parse(field));
+        _read_fields<i + 1>(columns, last);
+    }
+
+    template<size_t i, typename... As>
+    EnableIf<(i >= sizeof...(As))> _read_fields(Tuple<Vector<As>...>&, bool&) {}
+
+    const char* _data;
+    size_t _size;
+    size_t _pos;
+    detail::CsvScanner _scanner;
+};
+
+}  // namespace efp
+
+#endif  // __STDC_HOSTED__ && __STDC_HOSTED__ == 1
+
+#endif
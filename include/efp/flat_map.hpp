@@ -0,0 +1,432 @@
+#ifndef EFP_FLAT_MAP_HPP_
+#define EFP_FLAT_MAP_HPP_
+
+#include "efp/cpp_core.hpp"
+#include "efp/meta.hpp"
+#include "efp/trait.hpp"
+#include "efp/allocator.hpp"
+#include "efp/sequence.hpp"
+#include "efp/maybe.hpp"
+#include "efp/sort.hpp"
+#include "efp/hash.hpp"
+
+namespace efp {
+
+// Sorted flat maps and sets.
+// Keys are kept sorted in a Vector, and values in another Vector at the same indices. Lookup is a
+// binary search over the keys only, which is cache friendly and fits read mostly tables built once
+// with insert_bulk. Single insertion and erase shift the elements after the position, hence O(n).
+
+namespace detail {
+    // Key ordering of the lookup. Strings are ordered lexicographically, whether owning or view
+    template<typename A, typename B, typename = void>
+    struct FlatKeyLess {
+        static bool call(const A& a, const B& b) {
+            return a < b;
+        }
+    };
+
+    template<typename A, typename B>
+    struct FlatKeyLess<A, B, EnableIf<IsStringLike<A>::value && IsStringLike<B>::value>> {
+        static bool call(const A& a, const B& b) {
+            const size_t a_len = length(a);
+            const size_t b_len = length(b);
+            const size_t len = a_len < b_len ? a_len : b_len;
+
+            const auto* a_data = data(a);
+            const auto* b_data = data(b);
+            for (size_t i = 0; i < len; ++i) {
+                if (a_data[i] != b_data[i]) {
+                    return a_data[i] < b_data[i];
+                }
+            }
+            return a_len < b_len;
+        }
+    };
+
+    template<typename A, typename B>
+    bool flat_key_less(const A& a, const B& b) {
+        return FlatKeyLess<A, B>::call(a, b);
+    }
+
+    // Lookup by a key type other than the key is for strings only
+    template<typename K, typename Q>
+    using IsFlatLookupKey =
+        Bool<IsSame<K, Q>::value || (IsStringLike<K>::value && IsStringLike<Q>::value)>;
+
+    // flat_lower_bound
+    // Index of the first key not less than the key. Branchless, so that the loop runs the same
+    // log2(n) steps for any key and the compiler emits a conditional move instead of a branch.
+    template<typename K, typename Q>
+    size_t flat_lower_bound(const K* keys, size_t n, const Q& key) {
+        if (n == 0) {
+            return 0;
+        }
+
+        const K* first = keys;
+        while (n > 1) {
+            const size_t half = n / 2;
+            first = flat_key_less(first[half], key) ? first + half : first;
+            n -= half;
+        }
+
+        return static_cast<size_t>(first - keys) + flat_key_less(*first, key);
+    }
+
+    // Stable sort of the indices of the elements by key, for bulk insertion
+    template<typename As, typename KeyAt>
+    Vector<size_t> flat_sorted_order(const As& as, const KeyAt& key_at) {
+        const size_t len = length(as);
+
+        Vector<size_t> order {};
+        order.reserve(len);
+        for (size_t i = 0; i < len; ++i) {
+            order.push_back(i);
+        }
+
+        sort_by(order, [&](size_t a, size_t b) {
+            return flat_key_less(key_at(nth(a, as)), key_at(nth(b, as)));
+        });
+
+        return order;
+    }
+}  // namespace detail
+
+// FlatMap
+template<typename K, typename V, typename Allocator = detail::DefaultAllocator<Pair<K, V>>>
+class FlatMap {
+public:
+    using Key = K;
+    using Value = V;
+    using Keys = Vector<K, typename AllocatorTraits<Allocator>::template rebind_alloc<K>>;
+    using Values = Vector<V, typename AllocatorTraits<Allocator>::template rebind_alloc<V>>;
+
+    FlatMap() : _keys(), _values() {}
+
+    explicit FlatMap(const Allocator& alloc) : _keys(alloc), _values(alloc) {}
+
+    FlatMap(InitializerList<Pair<K, V>> il) : _keys(), _values() {
+        insert_bulk(Vector<Pair<K, V>>(il));
+    }
+
+    size_t size() const {
+        return _keys.size();
+    }
+
+    bool empty() const {
+        return _keys.size() == 0;
+    }
+
+    void reserve(size_t n) {
+        _keys.reserve(n);
+        _values.reserve(n);
+    }
+
+    void clear() {
+        _keys.clear();
+        _values.clear();
+    }
+
+    // Sorted keys
+    const Keys& keys() const {
+        return _keys;
+    }
+
+    // Values in the order of the keys
+    const Values& values() const {
+        return _values;
+    }
+
+    Values& values() {
+        return _values;
+    }
+
+    // Index of the first key not less than the key
+    template<typename Q, typename = EnableIf<detail::IsFlatLookupKey<K, Q>::value>>
+    size_t lower_bound(const Q& key) const {
+        return detail::flat_lower_bound(_keys.data(), _keys.size(), key);
+    }
+
+    template<typename Q, typename = EnableIf<detail::IsFlatLookupKey<K, Q>::value>>
+    const V* find(const Q& key) const {
+        const size_t i = _index_of(key);
+        return i == _keys.size() ? nullptr : _values.data() + i;
+    }
+
+    template<typename Q, typename = EnableIf<detail::IsFlatLookupKey<K, Q>::value>>
+    V* find(const Q& key) {
+        const size_t i = _index_of(key);
+        return i == _keys.size() ? nullptr : _values.data() + i;
+    }
+
+    template<typename Q, typename = EnableIf<detail::IsFlatLookupKey<K, Q>::value>>
+    Maybe<V> get(const Q& key) const {
+        const V* v = find(key);
+        if (v) {
+            return *v;
+        }
+        return nothing;
+    }
+
+    template<typename Q, typename = EnableIf<detail::IsFlatLookupKey<K, Q>::value>>
+    bool contains(const Q& key) const {
+        return _index_of(key) != _keys.size();
+    }
+
+    // Insert if the key is absent. Returns whether inserted
+    bool insert(const K& key, const V& value) {
+        const size_t i = lower_bound(key);
+        if (i != _keys.size() && !detail::flat_key_less(key, _keys[i])) {
+            return false;
+        }
+
+        _keys.insert(i, key);
+        _values.insert(i, value);
+        return true;
+    }
+
+    void insert_or_assign(const K& key, const V& value) {
+        const size_t i = lower_bound(key);
+        if (i != _keys.size() && !detail::flat_key_less(key, _keys[i])) {
+            _values[i] = value;
+        } else {
+            _keys.insert(i, key);
+            _values.insert(i, value);
+        }
+    }
+
+    // Default construct the value if the key is absent
+    V& operator[](const K& key) {
+        const size_t i = lower_bound(key);
+        if (i == _keys.size() || detail::flat_key_less(key, _keys[i])) {
+            _keys.insert(i, key);
+            _values.insert(i, V {});
+        }
+        return _values[i];
+    }
+
+    template<typename Q, typename = EnableIf<detail::IsFlatLookupKey<K, Q>::value>>
+    bool erase(const Q& key) {
+        const size_t i = _index_of(key);
+        if (i == _keys.size()) {
+            return false;
+        }
+
+        _keys.erase(i);
+        _values.erase(i);
+        return true;
+    }
+
+    // insert_bulk
+    // Insert a sequence of Pair<K, V>. Sorts the new entries and merges them with the existing ones
+    // in one pass, so building a map of n entries is O(n log n) instead of O(n^2).
+    // Existing keys are not overwritten, and the first of duplicated new keys wins.
+    template<typename As>
+    void insert_bulk(const As& entries) {
+        const Vector<size_t> order =
+            detail::flat_sorted_order(entries, [](const Pair<K, V>& e) -> const K& {
+                return fst(e);
+            });
+
+        const size_t n = _keys.size();
+        const size_t len = order.size();
+
+        Keys keys(_keys.get_allocator());
+        Values values(_values.get_allocator());
+        keys.reserve(n + len);
+        values.reserve(n + len);
+
+        const auto key_at = [&](size_t idx) -> const K& { return fst(nth(order[idx], entries)); };
+
+        size_t i = 0, j = 0;
+        while (i < n || j < len) {
+            if (j == len || (i < n && !detail::flat_key_less(key_at(j), _keys[i]))) {
+                // Existing key is the smallest. Drop the new entries of the same key
+                while (j < len && !detail::flat_key_less(_keys[i], key_at(j))) {
+                    ++j;
+                }
+
+                keys.push_back(efp::move(_keys[i]));
+                values.push_back(efp::move(_values[i]));
+                ++i;
+            } else {
+                const Pair<K, V>& e = nth(order[j], entries);
+                keys.push_back(fst(e));
+                values.push_back(snd(e));
+
+                // Drop the following duplicates of the new key
+                ++j;
+                while (j < len && !detail::flat_key_less(fst(e), key_at(j))) {
+                    ++j;
+                }
+            }
+        }
+
+        _keys = efp::move(keys);
+        _values = efp::move(values);
+    }
+
+private:
+    // Index of the key, or size if absent
+    template<typename Q>
+    size_t _index_of(const Q& key) const {
+        const size_t i = lower_bound(key);
+        return i != _keys.size() && !detail::flat_key_less(key, _keys[i]) ? i : _keys.size();
+    }
+
+    Keys _keys;
+    Values _values;
+};
+
+// FlatSet
+template<typename K, typename Allocator = detail::DefaultAllocator<K>>
+class FlatSet {
+public:
+    using Key = K;
+    using Keys = Vector<K, Allocator>;
+
+    FlatSet() : _keys() {}
+
+    explicit FlatSet(const Allocator& alloc) : _keys(alloc) {}
+
+    FlatSet(InitializerList<K> il) : _keys() {
+        insert_bulk(Vector<K>(il));
+    }
+
+    size_t size() const {
+        return _keys.size();
+    }
+
+    bool empty() const {
+        return _keys.size() == 0;
+    }
+
+    void reserve(size_t n) {
+        _keys.reserve(n);
+    }
+
+    void clear() {
+        _keys.clear();
+    }
+
+    // Sorted keys
+    const Keys& keys() const {
+        return _keys;
+    }
+
+    const K* data() const {
+        return _keys.data();
+    }
+
+    template<typename Q, typename = EnableIf<detail::IsFlatLookupKey<K, Q>::value>>
+    size_t lower_bound(const Q& key) const {
+        return detail::flat_lower_bound(_keys.data(), _keys.size(), key);
+    }
+
+    template<typename Q, typename = EnableIf<detail::IsFlatLookupKey<K, Q>::value>>
+    bool contains(const Q& key) const {
+        const size_t i = lower_bound(key);
+        return i != _keys.size() && !detail::flat_key_less(key, _keys[i]);
+    }
+
+    // Returns whether inserted
+    bool insert(const K& key) {
+        const size_t i = lower_bound(key);
+        if (i != _keys.size() && !detail::flat_key_less(key, _keys[i])) {
+            return false;
+        }
+
+        _keys.insert(i, key);
+        return true;
+    }
+
+    template<typename Q, typename = EnableIf<detail::IsFlatLookupKey<K, Q>::value>>
+    bool erase(const Q& key) {
+        const size_t i = lower_bound(key);
+        if (i == _keys.size() || detail::flat_key_less(key, _keys[i])) {
+            return false;
+        }
+
+        _keys.erase(i);
+        return true;
+    }
+
+    // insert_bulk
+    // Sorts the new keys and merges them with the existing ones in one pass, dropping duplicates
+    template<typename As>
+    void insert_bulk(const As& new_keys) {
+        const Vector<size_t> order =
+            detail::flat_sorted_order(new_keys, [](const K& k) -> const K& { return k; });
+
+        const size_t n = _keys.size();
+        const size_t len = order.size();
+
+        Keys keys(_keys.get_allocator());
+        keys.reserve(n + len);
+
+        size_t i = 0, j = 0;
+        while (i < n || j < len) {
+            const bool take_existing =
+                j == len || (i < n && !detail::flat_key_less(nth(order[j], new_keys), _keys[i]));
+            const K& k = take_existing ? _keys[i] : nth(order[j], new_keys);
+
+            // Drop the new keys equal to the one taken
+            if (!take_existing) {
+                ++j;
+            }
+            while (j < len && !detail::flat_key_less(k, nth(order[j], new_keys))) {
+                ++j;
+            }
+
+            if (take_existing) {
+                keys.push_back(efp::move(_keys[i++]));
+            } else {
+                keys.push_back(k);
+            }
+        }
+
+        _keys = efp::move(keys);
+    }
+
+private:
+    Keys _keys;
+};
+
+template<typename K, typename Allocator>
+struct ElementImpl<FlatSet<K, Allocator>> {
+    using Type = K;
+};
+
+template<typename K, typename Allocator>
+struct CtSizeImpl<FlatSet<K, Allocator>> {
+    using Type = Size<dyn>;
+};
+
+template<typename K, typename Allocator>
+struct CtCapacityImpl<FlatSet<K, Allocator>> {
+    using Type = Size<dyn>;
+};
+
+template<typename K, typename Allocator>
+constexpr auto length(const FlatSet<K, Allocator>& as) -> size_t {
+    return as.size();
+}
+
+template<typename K, typename Allocator>
+constexpr auto nth(size_t i, const FlatSet<K, Allocator>& as) -> const K& {
+    return as.data()[i];
+}
+
+template<typename K, typename Allocator>
+constexpr auto nth(size_t i, FlatSet<K, Allocator>& as) -> const K& {
+    return as.data()[i];
+}
+
+template<typename K, typename Allocator>
+constexpr auto data(const FlatSet<K, Allocator>& as) -> const K* {
+    return as.data();
+}
+
+}  // namespace efp
+
+#endif
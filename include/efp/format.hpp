@@ -26,6 +26,122 @@ inline void print(FormatString<Args...> fmt, Args&&... args) {
                                       : efp_fmt::detail::vprint_mojibake(stdout, fmt, vargs);
 }
 
+namespace detail {
+    // Lets fmt write into the spare capacity of a Vector<char>, growing it geometrically
+    template<typename Allocator, typename Traits>
+    class VectorFormatBuffer final: public efp_fmt::detail::buffer<char> {
+    public:
+        explicit VectorFormatBuffer(Vector<char, Allocator, Traits>& out) : _out(out) {
+            _reset();
+        }
+
+        void finish() {
+            _commit();
+        }
+
+    protected:
+        void grow(size_t capacity) override {
+            _commit();
+
+            const size_t doubled = 2 * _out.capacity();
+            const size_t required = _out.size() + capacity + 1;
+            _out.reserve(doubled > required ? doubled : required);
+            _reset();
+        }
+
+    private:
+        void _commit() {
+            _out.resize(_out.size() + size());
+            clear();
+        }
+
+        // Spare capacity, keeping the slot of the null terminator
+        void _reset() {
+            set(_out.data() + _out.size(), _out.capacity() - _out.size() - 1);
+        }
+
+        Vector<char, Allocator, Traits>& _out;
+    };
+
+    // Lets fmt write into the spare capacity of an ArrVec<char, n>, counting what does not fit.
+    // fmt asks to grow before filling the capacity, so after the first request the output goes
+    // through the scratch space, and is copied into whatever room is left.
+    template<size_t n, size_t align>
+    class ArrVecFormatBuffer final: public efp_fmt::detail::buffer<char> {
+    public:
+        explicit ArrVecFormatBuffer(ArrVec<char, n, align>& out)
+            : efp_fmt::detail::buffer<char>(out.data() + out.size(), 0, n - out.size()), _out(out),
+              _total(0), _scratched(false) {}
+
+        // Size of the whole output, including the truncated part
+        size_t finish() {
+            _commit();
+            return _total;
+        }
+
+    protected:
+        void grow(size_t) override {
+            _commit();
+            _scratched = true;
+            set(_scratch, sizeof(_scratch));
+        }
+
+    private:
+        void _commit() {
+            const size_t count = size();
+            const size_t before = _out.size();
+
+            if (_scratched) {
+                const size_t room = n - before;
+                const size_t copied = count < room ? count : room;
+                _memcpy(_out.data() + before, _scratch, copied);
+                _out.resize(before + copied);
+            } else {
+                _out.resize(before + count);
+            }
+
+            _total += count;
+            clear();
+        }
+
+        ArrVec<char, n, align>& _out;
+        size_t _total;
+        bool _scratched;
+        char _scratch[64];
+    };
+}  // namespace detail
+
+// format_to
+// Appends the formatted output to the buffer. Once the buffer has grown enough, formatting into
+// a cleared one does not allocate
+template<typename Allocator, typename Traits, typename... Args>
+inline void format_to(
+    Vector<char, Allocator, Traits>& out,
+    FormatString<Args...> fmt,
+    Args&&... args
+) {
+    detail::VectorFormatBuffer<Allocator, Traits> buffer {out};
+    efp_fmt::detail::vformat_to<char>(buffer, fmt, efp_fmt::make_format_args(args...), {});
+    buffer.finish();
+}
+
+// format_to_n
+// Appends as much of the formatted output as fits in the capacity of the buffer. Returns the
+// size of the whole output, which is larger than the appended if truncated
+template<size_t n, size_t align, typename... Args>
+inline size_t format_to_n(ArrVec<char, n, align>& out, FormatString<Args...> fmt, Args&&... args) {
+    detail::ArrVecFormatBuffer<n, align> buffer {out};
+    efp_fmt::detail::vformat_to<char>(buffer, fmt, efp_fmt::make_format_args(args...), {});
+    return buffer.finish();
+}
+
+// formatted_size
+// Size of the output of format, without formatting into memory
+template<typename... Args>
+inline size_t formatted_size(FormatString<Args...> fmt, Args&&... args) {
+    return efp_fmt::formatted_size(fmt, efp::forward<Args>(args)...);
+}
+
 // todo Move to io.hpp
 // todo Need to make it use Maybe or Result rather than exceptions
 // template<typename... Args>
@@ -47,32 +163,395 @@ inline void println(FormatString<Args...> fmt, Args&&... args) {
 //     return efp_fmt::print(f, "{}\n", efp_fmt::format(fmt, efp::forward<Args>(args)...));
 // }
 
+#if __cplusplus >= 201402L
+
+template<typename S>
+class CompiledFormat;
+
+namespace detail {
+    // Literal text or replacement field of a compiled format string, as offsets into it
+    struct CompiledSegment {
+        size_t begin;
+        size_t end;
+        // Index of the argument of a field, dyn for literal text
+        size_t arg;
+    };
+
+    template<size_t n>
+    struct CompiledSegments {
+        CompiledSegment items[n == 0 ? 1 : n];
+    };
+
+    constexpr size_t compiled_push(CompiledSegment* out, size_t count, CompiledSegment segment) {
+        if (segment.arg == dyn && segment.begin == segment.end) {
+            return count;
+        }
+
+        if (out != nullptr) {
+            out[count] = segment;
+        }
+        return count + 1;
+    }
+
+    // Splits the format string into segments, writing them to out unless it is null. The spec of
+    // a field is the text between the colon and the closing brace. Returns the number of
+    // segments, or dyn if the string is malformed. Named arguments and nested replacement
+    // fields are not supported
+    constexpr size_t compile_format(const char* s, size_t n, CompiledSegment* out) {
+        size_t count = 0;
+        size_t literal = 0;
+        size_t next_arg = 0;
+        bool automatic = false;
+        bool manual = false;
+        size_t i = 0;
+
+        while (i < n) {
+            if (s[i] != '{' && s[i] != '}') {
+                ++i;
+                continue;
+            }
+
+            // Escaped brace, kept as the first of the two
+            if (i + 1 < n && s[i + 1] == s[i]) {
+                count = compiled_push(out, count, CompiledSegment {literal, i + 1, dyn});
+                i += 2;
+                literal = i;
+                continue;
+            }
+
+            if (s[i] == '}') {
+                return dyn;
+            }
+
+            count = compiled_push(out, count, CompiledSegment {literal, i, dyn});
+            ++i;
+
+            size_t arg = 0;
+            if (i < n && s[i] >= '0' && s[i] <= '9') {
+                manual = true;
+                while (i < n && s[i] >= '0' && s[i] <= '9') {
+                    arg = arg * 10 + static_cast<size_t>(s[i] - '0');
+                    ++i;
+                }
+            } else {
+                automatic = true;
+                arg = next_arg++;
+            }
+
+            size_t spec = i;
+            if (i < n && s[i] == ':') {
+                spec = ++i;
+                while (i < n && s[i] != '}') {
+                    if (s[i] == '{') {
+                        return dyn;
+                    }
+                    ++i;
+                }
+            }
+
+            if (i == n || s[i] != '}') {
+                return dyn;
+            }
+
+            count = compiled_push(out, count, CompiledSegment {spec, i, arg});
+            ++i;
+            literal = i;
+        }
+
+        if (automatic && manual) {
+            return dyn;
+        }
+
+        return compiled_push(out, count, CompiledSegment {literal, n, dyn});
+    }
+
+    template<size_t n>
+    constexpr CompiledSegments<n> compiled_segments(const char* s, size_t size) {
+        CompiledSegments<n> result {};
+        compile_format(s, size, result.items);
+        return result;
+    }
+
+    // The argument at index i
+    template<size_t i>
+    struct CompiledArg {
+        template<typename A, typename... As>
+        static auto get(const A&, const As&... as) -> const PackAt<i - 1, As...>& {
+            return CompiledArg<i - 1>::get(as...);
+        }
+    };
+
+    template<>
+    struct CompiledArg<0> {
+        template<typename A, typename... As>
+        static auto get(const A& a, const As&...) -> const A& {
+            return a;
+        }
+    };
+
+    // Type an argument is formatted as, which is what fmt would store it as
+    template<typename A>
+    using CompiledMapped = CVRefRemoved<decltype(
+        efp_fmt::detail::arg_mapper<efp_fmt::format_context>().map(declval<const A&>())
+    )>;
+
+    template<typename Formatter>
+    inline Formatter compiled_formatter(const char* spec, size_t length) {
+        Formatter formatter {};
+        efp_fmt::format_parse_context ctx {efp_fmt::string_view(spec, length)};
+
+        if (formatter.parse(ctx) != ctx.end()) {
+            efp_fmt::throw_format_error("invalid format specifier");
+        }
+        return formatter;
+    }
+
+    // Whether a field is formatted with the defaults of a built in type
+    template<typename A>
+    using IsCompiledPlain = Bool<
+        efp_fmt::detail::type_constant<CompiledMapped<A>, char>::value
+        != efp_fmt::detail::type::custom_type>;
+
+    template<typename S, size_t i, typename A>
+    inline void compiled_write_field(efp_fmt::detail::buffer<char>& buffer, const A& value, True) {
+        efp_fmt::detail::write<char>(
+            efp_fmt::appender(buffer),
+            efp_fmt::detail::arg_mapper<efp_fmt::format_context>().map(value)
+        );
+    }
+
+    // Formats the argument of the field at segment i. The spec is parsed on the first call
+    template<typename S, size_t i, typename A>
+    inline void compiled_write_field(efp_fmt::detail::buffer<char>& buffer, const A& value, False) {
+        using Formatter = efp_fmt::formatter<CompiledMapped<A>, char>;
+        constexpr CompiledSegment segment = CompiledFormat<S>::segments.items[i];
+
+        static const Formatter parsed = compiled_formatter<Formatter>(
+            S::data() + segment.begin,
+            segment.end - segment.begin
+        );
+
+        Formatter formatter = parsed;
+        efp_fmt::format_context ctx {efp_fmt::appender(buffer), {}, {}};
+        formatter.format(efp_fmt::detail::arg_mapper<efp_fmt::format_context>().map(value), ctx);
+    }
+
+    // Writes the segments from i on, unrolled at compile time
+    template<typename S, size_t i, size_t n>
+    struct CompiledWriter {
+        template<typename... Args>
+        static void write(efp_fmt::detail::buffer<char>& buffer, const Args&... args) {
+            _write(buffer, Bool<CompiledFormat<S>::segments.items[i].arg == dyn> {}, args...);
+            CompiledWriter<S, i + 1, n>::write(buffer, args...);
+        }
+
+    private:
+        template<typename... Args>
+        static void _write(efp_fmt::detail::buffer<char>& buffer, True, const Args&...) {
+            constexpr CompiledSegment segment = CompiledFormat<S>::segments.items[i];
+            buffer.append(S::data() + segment.begin, S::data() + segment.end);
+        }
+
+        template<typename... Args>
+        static void _write(efp_fmt::detail::buffer<char>& buffer, False, const Args&... args) {
+            constexpr size_t arg = CompiledFormat<S>::segments.items[i].arg;
+            static_assert(arg < sizeof...(Args), "CompiledFormat: argument index out of range");
+
+            constexpr bool plain = CompiledFormat<S>::segments.items[i].begin
+                                == CompiledFormat<S>::segments.items[i].end;
+            using A = CVRefRemoved<PackAt<arg, Args...>>;
+
+            compiled_write_field<S, i>(
+                buffer,
+                CompiledArg<arg>::get(args...),
+                Bool<plain && IsCompiledPlain<A>::value> {}
+            );
+        }
+    };
+
+    template<typename S, size_t n>
+    struct CompiledWriter<S, n, n> {
+        template<typename... Args>
+        static void write(efp_fmt::detail::buffer<char>&, const Args&...) {}
+    };
+
+    // The format string of S as a compile time string of fmt, whose check runs the parse of the
+    // formatter of each field in a constant expression
+    template<typename S>
+    struct CompiledCheckedSource: efp_fmt::detail::compile_string {
+        using char_type = char;
+
+        constexpr operator efp_fmt::string_view() const {
+            return efp_fmt::string_view(S::data(), S::size());
+        }
+    };
+}  // namespace detail
+
+// CompiledFormat
+// Format string split into literal text and replacement fields at compile time. Formatting
+// appends the text as is and hands each argument to the formatter of its type, whose spec is
+// parsed once, so the format string is not scanned on each call. The string and the specs are
+// checked against the arguments at compile time. Made with EFP_COMPILE, or with
+// efp::compiled since C++20. Before C++14, EFP_COMPILE leaves the string to the run time parser.
+//
+//     format(EFP_COMPILE("{}: {:.3f}"), name, value);
+template<typename S>
+class CompiledFormat {
+public:
+    static constexpr size_t segment_count = detail::compile_format(S::data(), S::size(), nullptr);
+
+    static_assert(segment_count != dyn, "CompiledFormat: malformed format string");
+
+    static constexpr detail::CompiledSegments<segment_count == dyn ? 0 : segment_count> segments =
+        detail::compiled_segments<segment_count == dyn ? 0 : segment_count>(S::data(), S::size());
+
+    template<typename... Args>
+    static void write(efp_fmt::detail::buffer<char>& buffer, const Args&... args) {
+    #if EFP_FMT_USE_CONSTEXPR
+        efp_fmt::detail::check_format_string<Args...>(detail::CompiledCheckedSource<S> {});
+    #endif
+        detail::CompiledWriter<S, 0, segment_count>::write(buffer, args...);
+    }
+};
+
+template<typename S>
+constexpr size_t CompiledFormat<S>::segment_count;
+
+template<typename S>
+constexpr detail::CompiledSegments<
+    CompiledFormat<S>::segment_count == dyn ? 0 : CompiledFormat<S>::segment_count>
+    CompiledFormat<S>::segments;
+
+    // The string is returned by a local class, which makes a distinct CompiledFormat per string
+    #define EFP_COMPILE(s)                                         \
+        [] {                                                       \
+            struct EfpCompiledSource {                             \
+                static constexpr const char* data() {              \
+                    return s;                                      \
+                }                                                  \
+                static constexpr size_t size() {                   \
+                    return sizeof(s) - 1;                          \
+                }                                                  \
+            };                                                     \
+            return efp::CompiledFormat<EfpCompiledSource> {};      \
+        }()
+
+    #if __cplusplus >= 202002L
+namespace detail {
+    template<size_t n>
+    struct CompiledLiteral {
+        constexpr CompiledLiteral(const char (&s)[n]) {
+            for (size_t i = 0; i < n; ++i) {
+                chars[i] = s[i];
+            }
+        }
+
+        char chars[n] {};
+    };
+
+    template<CompiledLiteral s>
+    struct CompiledLiteralSource {
+        static constexpr const char* data() {
+            return s.chars;
+        }
+
+        static constexpr size_t size() {
+            return sizeof(s.chars) - 1;
+        }
+    };
+}  // namespace detail
+
+// compiled
+// CompiledFormat of a string literal, as in format(compiled<"{}: {}">, key, value)
+template<detail::CompiledLiteral s>
+constexpr CompiledFormat<detail::CompiledLiteralSource<s>> compiled {};
+    #endif
+
+template<typename S, typename... Args>
+inline auto format(const CompiledFormat<S>&, const Args&... args) -> String {
+    efp_fmt::memory_buffer buffer {};
+    CompiledFormat<S>::write(buffer, args...);
+    return String(buffer.data(), buffer.size());
+}
+
+template<typename S, typename... Args>
+inline void print(const CompiledFormat<S>&, const Args&... args) {
+    efp_fmt::memory_buffer buffer {};
+    CompiledFormat<S>::write(buffer, args...);
+    std::fwrite(buffer.data(), 1, buffer.size(), stdout);
+}
+
+template<typename S, typename... Args>
+inline void println(const CompiledFormat<S>&, const Args&... args) {
+    efp_fmt::memory_buffer buffer {};
+    CompiledFormat<S>::write(buffer, args...);
+    buffer.push_back('\n');
+    std::fwrite(buffer.data(), 1, buffer.size(), stdout);
+}
+
+template<typename Allocator, typename Traits, typename S, typename... Args>
+inline void format_to(
+    Vector<char, Allocator, Traits>& out,
+    const CompiledFormat<S>&,
+    const Args&... args
+) {
+    detail::VectorFormatBuffer<Allocator, Traits> buffer {out};
+    CompiledFormat<S>::write(buffer, args...);
+    buffer.finish();
+}
+
+template<size_t n, size_t align, typename S, typename... Args>
+inline size_t format_to_n(
+    ArrVec<char, n, align>& out,
+    const CompiledFormat<S>&,
+    const Args&... args
+) {
+    detail::ArrVecFormatBuffer<n, align> buffer {out};
+    CompiledFormat<S>::write(buffer, args...);
+    return buffer.finish();
+}
+
+template<typename S, typename... Args>
+inline size_t formatted_size(const CompiledFormat<S>&, const Args&... args) {
+    efp_fmt::detail::counting_buffer<char> buffer {};
+    CompiledFormat<S>::write(buffer, args...);
+    return buffer.count();
+}
+
+#else
+
+    // Before C++14 the format string is parsed at run time
+    #define EFP_COMPILE(s) s
+
+#endif
+
+
 }  // namespace efp
 
 // Specialize efp_fmt::formatter for efp::Array
-template<typename T, size_t ct_size>
-struct efp_fmt::formatter<efp::Array<T, ct_size>> {
+template<typename T, size_t ct_size, size_t ct_align>
+struct efp_fmt::formatter<efp::Array<T, ct_size, ct_align>> {
     template<typename ParseContext>
     constexpr auto parse(ParseContext& ctx) const -> format_parse_context::iterator {
         return ctx.begin();
     }
 
     template<typename FormatContext>
-    auto format(const efp::Array<T, ct_size>& arr, FormatContext& ctx) -> format_context::iterator {
+    auto format(const efp::Array<T, ct_size, ct_align>& arr, FormatContext& ctx) -> format_context::iterator {
         return efp_fmt::format_to(ctx.out(), "[{}]", efp_fmt::join(arr.begin(), arr.end(), ", "));
     }
 };
 
 // Specialize efp_fmt::formatter for efp::ArrVec
-template<typename T, size_t ct_cap>
-struct efp_fmt::formatter<efp::ArrVec<T, ct_cap>> {
+template<typename T, size_t ct_cap, size_t ct_align>
+struct efp_fmt::formatter<efp::ArrVec<T, ct_cap, ct_align>> {
     template<typename ParseContext>
     constexpr auto parse(ParseContext& ctx) const -> format_parse_context::iterator {
         return ctx.begin();
     }
 
     template<typename FormatContext>
-    auto format(const efp::ArrVec<T, ct_cap>& arrvec, FormatContext& ctx)
+    auto format(const efp::ArrVec<T, ct_cap, ct_align>& arrvec, FormatContext& ctx)
         -> format_context::iterator {
         return efp_fmt::format_to(
             ctx.out(),
@@ -0,0 +1,329 @@
+#ifndef EFP_HASH_HPP_
+#define EFP_HASH_HPP_
+
+#include "efp/cpp_core.hpp"
+#include "efp/meta.hpp"
+#include "efp/trait.hpp"
+#include "efp/sequence.hpp"
+#include "efp/enum.hpp"
+#include "efp/maybe.hpp"
+#include "efp/string.hpp"
+
+#if defined(__STDC_HOSTED__) && __STDC_HOSTED__ == 1
+    #include <functional>
+#endif
+
+namespace efp {
+
+namespace detail {
+    // Finalizer of MurmurHash3. Spreads every input bit over the whole word
+    inline uint64_t hash_mix(uint64_t x) {
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdull;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53ull;
+        x ^= x >> 33;
+        return x;
+    }
+
+    constexpr uint64_t hash_secret[4] = {
+        0x2d358dccaa6c78a5ull,
+        0x8bb84b93962eacc9ull,
+        0x4b33a62ed433d4a3ull,
+        0x4d5a2da51de1aa47ull,
+    };
+
+#if defined(__SIZEOF_INT128__)
+    __extension__ typedef unsigned __int128 HashU128;
+
+    // Full 64 x 64 -> 128 bit multiplication, returning the low and high halves
+    inline void hash_mum(uint64_t& a, uint64_t& b) {
+        const HashU128 r = static_cast<HashU128>(a) * b;
+        a = static_cast<uint64_t>(r);
+        b = static_cast<uint64_t>(r >> 64);
+    }
+#else
+    inline void hash_mum(uint64_t& a, uint64_t& b) {
+        const uint64_t ha = a >> 32, hb = b >> 32, la = static_cast<uint32_t>(a),
+                       lb = static_cast<uint32_t>(b);
+        const uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+        const uint64_t t = rl + (rm0 << 32);
+        uint64_t c = t < rl;
+        const uint64_t lo = t + (rm1 << 32);
+        c += lo < t;
+        a = lo;
+        b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+    }
+#endif
+
+    inline uint64_t hash_mum_mix(uint64_t a, uint64_t b) {
+        hash_mum(a, b);
+        return a ^ b;
+    }
+
+    inline uint64_t hash_read8(const uint8_t* p) {
+        uint64_t v;
+        _memcpy(&v, p, 8);
+        return v;
+    }
+
+    inline uint64_t hash_read4(const uint8_t* p) {
+        uint32_t v;
+        _memcpy(&v, p, 4);
+        return v;
+    }
+
+    // Reads 1 to 3 bytes without branching on the length
+    inline uint64_t hash_read3(const uint8_t* p, size_t k) {
+        return (static_cast<uint64_t>(p[0]) << 16) | (static_cast<uint64_t>(p[k >> 1]) << 8)
+            | p[k - 1];
+    }
+
+    // Consumes 16 bytes
+    inline uint64_t hash_step(const uint8_t* p, uint64_t secret, uint64_t seed) {
+        return hash_mum_mix(hash_read8(p) ^ secret, hash_read8(p + 8) ^ seed);
+    }
+
+    // hash_bytes
+    // wyhash (final version 4). Long inputs are consumed 48 bytes at a time by three independent
+    // multiply chains, which keeps the multipliers busy at several GB/s without SIMD.
+    inline uint64_t hash_bytes(const void* key, size_t len, uint64_t seed = 0) {
+        const uint8_t* p = static_cast<const uint8_t*>(key);
+        seed ^= hash_mum_mix(seed ^ hash_secret[0], hash_secret[1]);
+        uint64_t a, b;
+
+        if (len <= 16) {
+            if (len >= 4) {
+                a = (hash_read4(p) << 32) | hash_read4(p + ((len >> 3) << 2));
+                b = (hash_read4(p + len - 4) << 32) | hash_read4(p + len - 4 - ((len >> 3) << 2));
+            } else if (len > 0) {
+                a = hash_read3(p, len);
+                b = 0;
+            } else {
+                a = b = 0;
+            }
+        } else {
+            size_t i = len;
+            if (i > 48) {
+                uint64_t see1 = seed, see2 = seed;
+                do {
+                    seed = hash_step(p, hash_secret[1], seed);
+                    see1 = hash_step(p + 16, hash_secret[2], see1);
+                    see2 = hash_step(p + 32, hash_secret[3], see2);
+                    p += 48;
+                    i -= 48;
+                } while (i > 48);
+                seed ^= see1 ^ see2;
+            }
+
+            while (i > 16) {
+                seed = hash_step(p, hash_secret[1], seed);
+                i -= 16;
+                p += 16;
+            }
+
+            a = hash_read8(p + i - 16);
+            b = hash_read8(p + i - 8);
+        }
+
+        a ^= hash_secret[1];
+        b ^= seed;
+        hash_mum(a, b);
+        return hash_mum_mix(a ^ hash_secret[0] ^ len, b ^ hash_secret[1]);
+    }
+
+    // Order dependent combination of hashes
+    inline uint64_t hash_combine(uint64_t seed, uint64_t h) {
+        return hash_mum_mix(seed ^ hash_secret[0], h ^ hash_secret[2]);
+    }
+
+    template<typename A>
+    struct IsStringLike: False {};
+
+    template<typename Char, typename Allocator, typename Traits>
+    struct IsStringLike<Vector<Char, Allocator, Traits, EnableIf<IsCharType<Char>::value>>>:
+        True {};
+
+    template<typename Char, typename Traits>
+    struct IsStringLike<VectorView<Char, Traits, EnableIf<IsCharType<Char>::value>>>: True {};
+
+    // Elements of which the object representation is the value, hence could be hashed in bulk.
+    // Floating points are not, since -0.0 equals to 0.0.
+    template<typename A>
+    using IsBulkHashable =
+        Bool<std::is_integral<A>::value || std::is_enum<A>::value || std::is_pointer<A>::value>;
+
+    template<typename A, typename = void>
+    struct SequenceHashImpl;
+}  // namespace detail
+
+// Hash
+// Hash function object with good distribution of all the bits, as required by open addressing
+// hash tables. Unlike many std::hash implementations, integers are not hashed to themselves.
+// Falls back to std::hash for the other types in hosted environments.
+#if defined(__STDC_HOSTED__) && __STDC_HOSTED__ == 1
+template<typename A, typename = void>
+struct Hash {
+    size_t operator()(const A& a) const {
+        return static_cast<size_t>(detail::hash_mix(static_cast<uint64_t>(std::hash<A>()(a))));
+    }
+};
+#else
+template<typename A, typename = void>
+struct Hash;
+#endif
+
+template<typename A>
+struct Hash<A, EnableIf<std::is_integral<A>::value || std::is_enum<A>::value>> {
+    size_t operator()(A a) const {
+        return static_cast<size_t>(detail::hash_mix(static_cast<uint64_t>(a)));
+    }
+};
+
+template<typename A>
+struct Hash<A, EnableIf<std::is_floating_point<A>::value>> {
+    size_t operator()(A a) const {
+        // -0.0 and 0.0 are equal, hence should have the same hash
+        const A normalized = a == A(0) ? A(0) : a;
+        return static_cast<size_t>(detail::hash_bytes(&normalized, sizeof(A)));
+    }
+};
+
+template<typename A>
+struct Hash<A*> {
+    size_t operator()(const A* p) const {
+        return static_cast<size_t>(detail::hash_mix(reinterpret_cast<uintptr_t>(p)));
+    }
+};
+
+template<>
+struct Hash<Nothing> {
+    size_t operator()(const Nothing&) const {
+        return static_cast<size_t>(detail::hash_secret[3]);
+    }
+};
+
+namespace detail {
+    // Contiguous sequence of bulk hashable elements. Hashes the bytes at once
+    template<typename A>
+    struct SequenceHashImpl<A, EnableIf<IsBulkHashable<A>::value>> {
+        template<typename As>
+        static uint64_t call(const As& as) {
+            return hash_bytes(data(as), length(as) * sizeof(A));
+        }
+    };
+
+    // Combines the hashes of elements, followed by the length
+    template<typename A>
+    struct SequenceHashImpl<A, EnableIf<!IsBulkHashable<A>::value>> {
+        template<typename As>
+        static uint64_t call(const As& as) {
+            const size_t len = length(as);
+            const Hash<A> hasher {};
+
+            uint64_t h = hash_secret[0];
+            for (size_t i = 0; i < len; ++i) {
+                h = hash_combine(h, hasher(nth(i, as)));
+            }
+            return hash_combine(h, len);
+        }
+    };
+
+    // SequenceHash
+    // Hash of a sequence depends only on the elements, so the same elements in Array, Vector or
+    // any view have the same hash
+    struct SequenceHash {
+        template<typename As>
+        size_t operator()(const As& as) const {
+            return static_cast<size_t>(SequenceHashImpl<ConstRemoved<Element<As>>>::call(as));
+        }
+    };
+
+    // Owning strings, string views and C strings of the same characters have the same hash, so
+    // that they could be looked up by each other
+    template<typename Char>
+    struct StringHash: SequenceHash {
+        using is_transparent = void;
+        using SequenceHash::operator();
+
+        size_t operator()(const Char* c_str) const {
+            size_t len = 0;
+            while (c_str[len] != Char(0)) {
+                ++len;
+            }
+            return static_cast<size_t>(hash_bytes(c_str, len * sizeof(Char)));
+        }
+    };
+
+    template<typename A>
+    using SequenceHashOf =
+        Conditional<IsCharType<ConstRemoved<A>>::value, StringHash<ConstRemoved<A>>, SequenceHash>;
+
+    template<typename... As>
+    struct EnumHash {
+        template<uint8_t i>
+        struct Case {
+            using Alt = PackAt<i, As...>;
+
+            static inline uint64_t call(const Enum<As...>& e) {
+                return Hash<Alt>()(e.template get<i>());
+            }
+        };
+    };
+}  // namespace detail
+
+template<typename A, size_t n, size_t align>
+struct Hash<Array<A, n, align>>: detail::SequenceHash {};
+
+template<typename A, size_t n, size_t align>
+struct Hash<ArrVec<A, n, align>>: detail::SequenceHash {};
+
+template<typename A, typename Allocator, typename Traits, typename B>
+struct Hash<Vector<A, Allocator, Traits, B>>: detail::SequenceHashOf<A> {};
+
+template<typename A, size_t n>
+struct Hash<ArrayView<A, n>>: detail::SequenceHash {};
+
+template<typename A, size_t n>
+struct Hash<ArrVecView<A, n>>: detail::SequenceHash {};
+
+template<typename A, typename Traits, typename B>
+struct Hash<VectorView<A, Traits, B>>: detail::SequenceHashOf<A> {};
+
+// Mixes the index with the hash of the active alternative
+template<typename... As>
+struct Hash<Enum<As...>> {
+    size_t operator()(const Enum<As...>& e) const {
+        const uint64_t h = detail::EnumSwitch<
+            sizeof...(As),
+            detail::EnumHash<As...>::template Case,
+            const Enum<As...>&>::call(e.index(), e);
+
+        return static_cast<size_t>(detail::hash_combine(e.index(), h));
+    }
+};
+
+}  // namespace efp
+
+// std::hash for efp types, so that they could be keys of standard unordered containers
+#if defined(__STDC_HOSTED__) && __STDC_HOSTED__ == 1
+namespace std {
+template<typename A, size_t n, size_t align>
+struct hash<efp::Array<A, n, align>>: efp::Hash<efp::Array<A, n, align>> {};
+
+template<typename A, size_t n, size_t align>
+struct hash<efp::ArrVec<A, n, align>>: efp::Hash<efp::ArrVec<A, n, align>> {};
+
+template<typename A, typename Allocator, typename Traits, typename B>
+struct hash<efp::Vector<A, Allocator, Traits, B>>:
+    efp::Hash<efp::Vector<A, Allocator, Traits, B>> {};
+
+template<typename A, typename Traits, typename B>
+struct hash<efp::VectorView<A, Traits, B>>: efp::Hash<efp::VectorView<A, Traits, B>> {};
+
+template<typename... As>
+struct hash<efp::Enum<As...>>: efp::Hash<efp::Enum<As...>> {};
+}  // namespace std
+#endif
+
+#endif
@@ -0,0 +1,814 @@
+#ifndef EFP_HASH_MAP_HPP_
+#define EFP_HASH_MAP_HPP_
+
+#include "efp/cpp_core.hpp"
+#include "efp/meta.hpp"
+#include "efp/trait.hpp"
+#include "efp/allocator.hpp"
+#include "efp/sequence.hpp"
+#include "efp/maybe.hpp"
+#include "efp/hash.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define EFP_HASH_GROUP_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    #include <arm_neon.h>
+    #define EFP_HASH_GROUP_NEON
+#endif
+
+namespace efp {
+
+// Swiss table style hash tables.
+// Each slot has a control byte, which is empty, deleted or the 7 bit fragment of the hash (H2) of
+// the entry in the slot. Lookup probes a group of 16 control bytes at once with SIMD, and compares
+// keys only for the slots of which H2 matches. Entries are stored densely in insertion order,
+// separately from the slots, so iteration is a linear scan and rehashing never moves entries.
+// Erase moves the last entry into the hole, and changes the order.
+
+namespace detail {
+    using HashCtrl = int8_t;
+
+    constexpr HashCtrl hash_ctrl_empty = -128;
+    constexpr HashCtrl hash_ctrl_deleted = -2;
+    constexpr size_t hash_group_width = 16;
+
+    inline size_t hash_lowest_bit(uint32_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<size_t>(__builtin_ctz(mask));
+#else
+        size_t i = 0;
+        while (!(mask & 1u)) {
+            mask >>= 1;
+            ++i;
+        }
+        return i;
+#endif
+    }
+
+    // HashGroup
+    // 16 control bytes. Each match returns the bit mask of the matching slots of the group
+    class HashGroup {
+    public:
+#if defined(EFP_HASH_GROUP_SSE2)
+        explicit HashGroup(const HashCtrl* ctrl)
+            : _ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl))) {}
+
+        uint32_t match(HashCtrl h2) const {
+            return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), _ctrl))
+            );
+        }
+
+        uint32_t match_empty() const {
+            return match(hash_ctrl_empty);
+        }
+
+        // Empty and deleted are the only negative control bytes
+        uint32_t match_empty_or_deleted() const {
+            return static_cast<uint32_t>(_mm_movemask_epi8(_ctrl));
+        }
+
+    private:
+        __m128i _ctrl;
+
+#elif defined(EFP_HASH_GROUP_NEON)
+        explicit HashGroup(const HashCtrl* ctrl) : _ctrl(vld1q_s8(ctrl)) {}
+
+        uint32_t match(HashCtrl h2) const {
+            return _movemask(vceqq_s8(vdupq_n_s8(h2), _ctrl));
+        }
+
+        uint32_t match_empty() const {
+            return match(hash_ctrl_empty);
+        }
+
+        uint32_t match_empty_or_deleted() const {
+            return _movemask(vcltzq_s8(_ctrl));
+        }
+
+    private:
+        static uint32_t _movemask(uint8x16_t eq) {
+            static const uint8_t bits[16] =
+                {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+            const uint8x16_t masked = vandq_u8(eq, vld1q_u8(bits));
+            return static_cast<uint32_t>(vaddv_u8(vget_low_u8(masked)))
+                | (static_cast<uint32_t>(vaddv_u8(vget_high_u8(masked))) << 8);
+        }
+
+        int8x16_t _ctrl;
+
+#else
+        explicit HashGroup(const HashCtrl* ctrl) {
+            for (size_t i = 0; i < hash_group_width; ++i) {
+                _ctrl[i] = ctrl[i];
+            }
+        }
+
+        uint32_t match(HashCtrl h2) const {
+            uint32_t mask = 0;
+            for (size_t i = 0; i < hash_group_width; ++i) {
+                mask |= static_cast<uint32_t>(_ctrl[i] == h2) << i;
+            }
+            return mask;
+        }
+
+        uint32_t match_empty() const {
+            return match(hash_ctrl_empty);
+        }
+
+        uint32_t match_empty_or_deleted() const {
+            uint32_t mask = 0;
+            for (size_t i = 0; i < hash_group_width; ++i) {
+                mask |= static_cast<uint32_t>(_ctrl[i] < 0) << i;
+            }
+            return mask;
+        }
+
+    private:
+        HashCtrl _ctrl[hash_group_width];
+#endif
+    };
+
+    // Number of slots to hold n entries under the maximum load factor of 7/8
+    constexpr size_t hash_slot_count(size_t n, size_t slots = hash_group_width) {
+        return slots - slots / 8 >= n ? slots : hash_slot_count(n, slots * 2);
+    }
+
+    // Key comparison of the lookup. Strings are compared by content, whether owning or view
+    template<typename A, typename B, typename = void>
+    struct HashKeyEqual {
+        static bool call(const A& a, const B& b) {
+            return a == b;
+        }
+    };
+
+    template<typename A, typename B>
+    struct HashKeyEqual<A, B, EnableIf<IsStringLike<A>::value && IsStringLike<B>::value>> {
+        static bool call(const A& a, const B& b) {
+            const size_t len = length(a);
+            if (len != static_cast<size_t>(length(b))) {
+                return false;
+            }
+
+            const auto* a_data = data(a);
+            const auto* b_data = data(b);
+            for (size_t i = 0; i < len; ++i) {
+                if (a_data[i] != b_data[i]) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+
+    template<typename Hasher, typename = void>
+    struct HashIsTransparent: False {};
+
+    template<typename Hasher>
+    struct HashIsTransparent<Hasher, Void<typename Hasher::is_transparent>>: True {};
+
+    // Lookup by a key type other than the key of the table requires transparent hasher
+    template<typename Hasher, typename K, typename Q>
+    using IsHashLookupKey = Bool<IsSame<K, Q>::value || HashIsTransparent<Hasher>::value>;
+
+    // Storage of dynamic hash table
+    template<typename Entry, typename Allocator>
+    struct DynHashStorage {
+        using Entries = Vector<Entry, Allocator>;
+        using Ctrls =
+            Vector<HashCtrl, typename AllocatorTraits<Allocator>::template rebind_alloc<HashCtrl>>;
+        using Indices =
+            Vector<uint32_t, typename AllocatorTraits<Allocator>::template rebind_alloc<uint32_t>>;
+
+        static constexpr size_t ct_capacity = dyn;
+        static constexpr size_t ct_slot_count = dyn;
+    };
+
+    // Storage of fixed capacity hash table without allocation
+    template<typename Entry, size_t n>
+    struct ArrHashStorage {
+        static constexpr size_t ct_capacity = n;
+        static constexpr size_t ct_slot_count = hash_slot_count(n);
+
+        using Entries = ArrVec<Entry, n>;
+        using Ctrls = Array<HashCtrl, ct_slot_count>;
+        using Indices = Array<uint32_t, ct_slot_count>;
+    };
+
+    // HashTable
+    // Common implementation of hash maps and sets. KeyOf projects the key out of an entry
+    template<typename Key, typename Entry, typename KeyOf, typename Hasher, typename Storage>
+    class HashTable {
+    public:
+        using Entries = typename Storage::Entries;
+        using Ctrls = typename Storage::Ctrls;
+        using Indices = typename Storage::Indices;
+
+        HashTable() : _hasher(), _entries(), _ctrl(), _index(), _slot_count(0), _growth_left(0) {
+            _init_slots();
+        }
+
+        template<typename Allocator>
+        explicit HashTable(const Allocator& alloc)
+            : _hasher(), _entries(alloc), _ctrl(alloc), _index(alloc), _slot_count(0),
+              _growth_left(0) {
+            _init_slots();
+        }
+
+        size_t size() const {
+            return _entries.size();
+        }
+
+        bool empty() const {
+            return _entries.size() == 0;
+        }
+
+        // Number of entries the table could hold without rehashing
+        size_t capacity() const {
+            return _entries.size() + _growth_left;
+        }
+
+        void clear() {
+            _entries.clear();
+            _reset_slots(_slot_count);
+        }
+
+        // Make room for n entries without rehashing
+        void reserve(size_t n) {
+            if (Storage::ct_capacity != dyn) {
+                if (n > Storage::ct_capacity) {
+                    throw RuntimeError("HashTable::reserve: exceeds the static capacity");
+                }
+                return;
+            }
+
+            _entries.reserve(n);
+
+            const size_t slot_count = hash_slot_count(n);
+            if (slot_count > _slot_count) {
+                _rehash(slot_count);
+            }
+        }
+
+        const Entry* begin() const {
+            return _entries.data();
+        }
+
+        const Entry* end() const {
+            return _entries.data() + _entries.size();
+        }
+
+        const Entry* data() const {
+            return _entries.data();
+        }
+
+    protected:
+        static constexpr size_t npos = size_t(-1);
+
+        template<typename Q>
+        size_t _hash(const Q& key) const {
+            return _hasher(key);
+        }
+
+        static size_t _h1(size_t hash) {
+            return hash >> 7;
+        }
+
+        static HashCtrl _h2(size_t hash) {
+            return static_cast<HashCtrl>(hash & 0x7f);
+        }
+
+        // Index of the entry of the key. npos if not found
+        template<typename Q>
+        size_t _find(const Q& key, size_t hash) const {
+            if (_slot_count == 0) {
+                return npos;
+            }
+
+            const size_t group_mask = _slot_count / hash_group_width - 1;
+            const HashCtrl h2 = _h2(hash);
+            size_t group = _h1(hash) & group_mask;
+
+            for (size_t step = 0; step <= group_mask; ++step) {
+                const size_t base = group * hash_group_width;
+                const HashGroup g(_ctrl.data() + base);
+
+                for (uint32_t m = g.match(h2); m != 0; m &= m - 1) {
+                    const size_t i = _index[base + hash_lowest_bit(m)];
+                    if (HashKeyEqual<Key, Q>::call(KeyOf::get(_entries[i]), key)) {
+                        return i;
+                    }
+                }
+
+                if (g.match_empty() != 0) {
+                    return npos;
+                }
+
+                // Triangular probing visits every group once for power of two group count
+                group = (group + step + 1) & group_mask;
+            }
+
+            return npos;
+        }
+
+        template<typename Q>
+        size_t _find(const Q& key) const {
+            return _find(key, _hash(key));
+        }
+
+        // Append the entry of which key is known to be absent
+        template<typename... Args>
+        size_t _insert_new(size_t hash, Args&&... args) {
+            if (Storage::ct_capacity != dyn && _entries.size() == Storage::ct_capacity) {
+                throw RuntimeError("HashTable::insert: exceeds the static capacity");
+            }
+
+            if (_slot_count == 0) {
+                _grow();
+            }
+
+            size_t slot = _find_insert_slot(hash);
+
+            // Using an empty slot consumes the growth. Deleted one could be reused for free
+            if (_growth_left == 0 && _ctrl[slot] == hash_ctrl_empty) {
+                _grow();
+                slot = _find_insert_slot(hash);
+            }
+
+            if (_ctrl[slot] == hash_ctrl_empty) {
+                --_growth_left;
+            }
+
+            const size_t i = _entries.size();
+            _entries.push_back(Entry(efp::forward<Args>(args)...));
+            _ctrl[slot] = _h2(hash);
+            _index[slot] = static_cast<uint32_t>(i);
+            return i;
+        }
+
+        template<typename Q>
+        bool _erase(const Q& key) {
+            const size_t hash = _hash(key);
+            const size_t i = _find(key, hash);
+
+            if (i == npos) {
+                return false;
+            }
+
+            _release_slot(_slot_of(hash, i));
+
+            // Fill the hole with the last entry
+            const size_t last = _entries.size() - 1;
+            if (i != last) {
+                const size_t last_slot = _slot_of(_hash(KeyOf::get(_entries[last])), last);
+                _entries[i] = efp::move(_entries[last]);
+                _index[last_slot] = static_cast<uint32_t>(i);
+            }
+            _entries.pop_back();
+
+            return true;
+        }
+
+        Hasher _hasher;
+        Entries _entries;
+        Ctrls _ctrl;
+        Indices _index;
+        size_t _slot_count;
+        size_t _growth_left;
+
+    private:
+        void _init_slots() {
+            if (Storage::ct_slot_count != dyn) {
+                _reset_slots(Storage::ct_slot_count);
+            }
+        }
+
+        void _reset_slots(size_t slot_count) {
+            _slot_count = slot_count;
+
+            if (Storage::ct_slot_count == dyn) {
+                _ctrl.resize(slot_count);
+                _index.resize(slot_count);
+            }
+
+            for (size_t i = 0; i < slot_count; ++i) {
+                _ctrl[i] = hash_ctrl_empty;
+            }
+
+            _growth_left = slot_count - slot_count / 8 - _entries.size();
+        }
+
+        size_t _find_insert_slot(size_t hash) const {
+            const size_t group_mask = _slot_count / hash_group_width - 1;
+            size_t group = _h1(hash) & group_mask;
+
+            for (size_t step = 0;; ++step) {
+                const size_t base = group * hash_group_width;
+                const uint32_t m = HashGroup(_ctrl.data() + base).match_empty_or_deleted();
+
+                if (m != 0) {
+                    return base + hash_lowest_bit(m);
+                }
+
+                group = (group + step + 1) & group_mask;
+            }
+        }
+
+        // Slot pointing the entry i
+        size_t _slot_of(size_t hash, size_t i) const {
+            const size_t group_mask = _slot_count / hash_group_width - 1;
+            const HashCtrl h2 = _h2(hash);
+            size_t group = _h1(hash) & group_mask;
+
+            for (size_t step = 0;; ++step) {
+                const size_t base = group * hash_group_width;
+
+                for (uint32_t m = HashGroup(_ctrl.data() + base).match(h2); m != 0; m &= m - 1) {
+                    const size_t slot = base + hash_lowest_bit(m);
+                    if (_index[slot] == i) {
+                        return slot;
+                    }
+                }
+
+                group = (group + step + 1) & group_mask;
+            }
+        }
+
+        void _release_slot(size_t slot) {
+            // If the group has an empty slot, no probe has ever passed through the group.
+            // Then the slot could be empty again instead of leaving a tombstone.
+            const size_t base = slot - slot % hash_group_width;
+            if (HashGroup(_ctrl.data() + base).match_empty() != 0) {
+                _ctrl[slot] = hash_ctrl_empty;
+                ++_growth_left;
+            } else {
+                _ctrl[slot] = hash_ctrl_deleted;
+            }
+        }
+
+        void _grow() {
+            // Many tombstones. Rehashing at the same size is enough
+            if (_slot_count != 0 && _entries.size() * 2 <= _slot_count - _slot_count / 8) {
+                _rehash(_slot_count);
+            } else if (Storage::ct_slot_count != dyn) {
+                _rehash(_slot_count);
+            } else {
+                _rehash(_slot_count == 0 ? hash_group_width : _slot_count * 2);
+            }
+        }
+
+        // Rebuild the slots from the entries. Entries are not moved.
+        void _rehash(size_t slot_count) {
+            _reset_slots(slot_count);
+
+            for (size_t i = 0; i < _entries.size(); ++i) {
+                const size_t hash = _hash(KeyOf::get(_entries[i]));
+                const size_t slot = _find_insert_slot(hash);
+
+                _ctrl[slot] = _h2(hash);
+                _index[slot] = static_cast<uint32_t>(i);
+            }
+        }
+    };
+
+    struct HashMapKeyOf {
+        template<typename K, typename V>
+        static const K& get(const Pair<K, V>& entry) {
+            return fst(entry);
+        }
+    };
+
+    struct HashSetKeyOf {
+        template<typename K>
+        static const K& get(const K& entry) {
+            return entry;
+        }
+    };
+
+    // HashMapBase
+    template<typename K, typename V, typename Hasher, typename Storage>
+    class HashMapBase: public HashTable<K, Pair<K, V>, HashMapKeyOf, Hasher, Storage> {
+    public:
+        using Base = HashTable<K, Pair<K, V>, HashMapKeyOf, Hasher, Storage>;
+        using Base::Base;
+
+        using Element = Pair<K, V>;
+        using Key = K;
+        using Value = V;
+
+        template<typename Q, typename = EnableIf<IsHashLookupKey<Hasher, K, Q>::value>>
+        const V* find(const Q& key) const {
+            const size_t i = Base::_find(key);
+            return i == Base::npos ? nullptr : &snd(Base::_entries[i]);
+        }
+
+        template<typename Q, typename = EnableIf<IsHashLookupKey<Hasher, K, Q>::value>>
+        V* find(const Q& key) {
+            const size_t i = Base::_find(key);
+            return i == Base::npos ? nullptr : &snd(Base::_entries[i]);
+        }
+
+        template<typename Q, typename = EnableIf<IsHashLookupKey<Hasher, K, Q>::value>>
+        Maybe<V> get(const Q& key) const {
+            const V* v = find(key);
+            if (v) {
+                return *v;
+            }
+            return nothing;
+        }
+
+        template<typename Q, typename = EnableIf<IsHashLookupKey<Hasher, K, Q>::value>>
+        bool contains(const Q& key) const {
+            return Base::_find(key) != Base::npos;
+        }
+
+        // Insert if the key is absent. Returns whether inserted
+        bool insert(const K& key, const V& value) {
+            const size_t hash = Base::_hash(key);
+            if (Base::_find(key, hash) != Base::npos) {
+                return false;
+            }
+
+            Base::_insert_new(hash, key, value);
+            return true;
+        }
+
+        void insert_or_assign(const K& key, const V& value) {
+            const size_t hash = Base::_hash(key);
+            const size_t i = Base::_find(key, hash);
+
+            if (i == Base::npos) {
+                Base::_insert_new(hash, key, value);
+            } else {
+                snd(Base::_entries[i]) = value;
+            }
+        }
+
+        // Insert a sequence of Pair<K, V>. Existing keys are not overwritten
+        template<typename As>
+        void insert_bulk(const As& entries) {
+            const size_t len = length(entries);
+            Base::reserve(Base::size() + len);
+
+            for (size_t i = 0; i < len; ++i) {
+                const Element& e = nth(i, entries);
+                insert(fst(e), snd(e));
+            }
+        }
+
+        // Default construct the value if the key is absent
+        V& operator[](const K& key) {
+            const size_t hash = Base::_hash(key);
+            size_t i = Base::_find(key, hash);
+
+            if (i == Base::npos) {
+                i = Base::_insert_new(hash, key, V {});
+            }
+
+            return snd(Base::_entries[i]);
+        }
+
+        template<typename Q, typename = EnableIf<IsHashLookupKey<Hasher, K, Q>::value>>
+        bool erase(const Q& key) {
+            return Base::_erase(key);
+        }
+    };
+
+    // HashSetBase
+    template<typename K, typename Hasher, typename Storage>
+    class HashSetBase: public HashTable<K, K, HashSetKeyOf, Hasher, Storage> {
+    public:
+        using Base = HashTable<K, K, HashSetKeyOf, Hasher, Storage>;
+        using Base::Base;
+
+        using Element = K;
+        using Key = K;
+
+        template<typename Q, typename = EnableIf<IsHashLookupKey<Hasher, K, Q>::value>>
+        bool contains(const Q& key) const {
+            return Base::_find(key) != Base::npos;
+        }
+
+        // Returns whether inserted
+        bool insert(const K& key) {
+            const size_t hash = Base::_hash(key);
+            if (Base::_find(key, hash) != Base::npos) {
+                return false;
+            }
+
+            Base::_insert_new(hash, key);
+            return true;
+        }
+
+        template<typename As>
+        void insert_bulk(const As& keys) {
+            const size_t len = length(keys);
+            Base::reserve(Base::size() + len);
+
+            for (size_t i = 0; i < len; ++i) {
+                insert(nth(i, keys));
+            }
+        }
+
+        template<typename Q, typename = EnableIf<IsHashLookupKey<Hasher, K, Q>::value>>
+        bool erase(const Q& key) {
+            return Base::_erase(key);
+        }
+    };
+}  // namespace detail
+
+// HashMap
+template<
+    typename K,
+    typename V,
+    typename Hasher = Hash<K>,
+    typename Allocator = detail::DefaultAllocator<Pair<K, V>>>
+class HashMap:
+    public detail::HashMapBase<K, V, Hasher, detail::DynHashStorage<Pair<K, V>, Allocator>> {
+public:
+    using Base = detail::HashMapBase<K, V, Hasher, detail::DynHashStorage<Pair<K, V>, Allocator>>;
+    HashMap() : Base() {}
+
+    explicit HashMap(const Allocator& alloc) : Base(alloc) {}
+
+    HashMap(InitializerList<Pair<K, V>> il) : Base() {
+        Base::reserve(il.size());
+        for (const auto& e : il) {
+            Base::insert(fst(e), snd(e));
+        }
+    }
+};
+
+// ArrHashMap
+// Fixed capacity of n entries without allocation
+template<typename K, typename V, size_t n, typename Hasher = Hash<K>>
+class ArrHashMap: public detail::HashMapBase<K, V, Hasher, detail::ArrHashStorage<Pair<K, V>, n>> {
+public:
+    using Base = detail::HashMapBase<K, V, Hasher, detail::ArrHashStorage<Pair<K, V>, n>>;
+    ArrHashMap() : Base() {}
+
+    ArrHashMap(InitializerList<Pair<K, V>> il) : Base() {
+        for (const auto& e : il) {
+            Base::insert(fst(e), snd(e));
+        }
+    }
+};
+
+// HashSet
+template<typename K, typename Hasher = Hash<K>, typename Allocator = detail::DefaultAllocator<K>>
+class HashSet: public detail::HashSetBase<K, Hasher, detail::DynHashStorage<K, Allocator>> {
+public:
+    using Base = detail::HashSetBase<K, Hasher, detail::DynHashStorage<K, Allocator>>;
+    HashSet() : Base() {}
+
+    explicit HashSet(const Allocator& alloc) : Base(alloc) {}
+
+    HashSet(InitializerList<K> il) : Base() {
+        Base::reserve(il.size());
+        for (const auto& k : il) {
+            Base::insert(k);
+        }
+    }
+};
+
+// ArrHashSet
+// Fixed capacity of n keys without allocation
+template<typename K, size_t n, typename Hasher = Hash<K>>
+class ArrHashSet: public detail::HashSetBase<K, Hasher, detail::ArrHashStorage<K, n>> {
+public:
+    using Base = detail::HashSetBase<K, Hasher, detail::ArrHashStorage<K, n>>;
+    ArrHashSet() : Base() {}
+
+    ArrHashSet(InitializerList<K> il) : Base() {
+        for (const auto& k : il) {
+            Base::insert(k);
+        }
+    }
+};
+
+// Sequence traits over the entries in the order of storage.
+// Entries are read only, since changing the keys breaks the table.
+
+template<typename K, typename V, typename Hasher, typename Allocator>
+struct ElementImpl<HashMap<K, V, Hasher, Allocator>> {
+    using Type = Pair<K, V>;
+};
+
+template<typename K, typename V, typename Hasher, typename Allocator>
+struct CtSizeImpl<HashMap<K, V, Hasher, Allocator>> {
+    using Type = Size<dyn>;
+};
+
+template<typename K, typename V, typename Hasher, typename Allocator>
+struct CtCapacityImpl<HashMap<K, V, Hasher, Allocator>> {
+    using Type = Size<dyn>;
+};
+
+template<typename K, typename V, typename Hasher, typename Allocator>
+constexpr auto length(const HashMap<K, V, Hasher, Allocator>& as) -> size_t {
+    return as.size();
+}
+
+template<typename K, typename V, typename Hasher, typename Allocator>
+constexpr auto nth(size_t i, const HashMap<K, V, Hasher, Allocator>& as) -> const Pair<K, V>& {
+    return as.data()[i];
+}
+
+template<typename K, typename V, typename Hasher, typename Allocator>
+constexpr auto nth(size_t i, HashMap<K, V, Hasher, Allocator>& as) -> const Pair<K, V>& {
+    return as.data()[i];
+}
+
+template<typename K, typename V, size_t n, typename Hasher>
+struct ElementImpl<ArrHashMap<K, V, n, Hasher>> {
+    using Type = Pair<K, V>;
+};
+
+template<typename K, typename V, size_t n, typename Hasher>
+struct CtSizeImpl<ArrHashMap<K, V, n, Hasher>> {
+    using Type = Size<dyn>;
+};
+
+template<typename K, typename V, size_t n, typename Hasher>
+struct CtCapacityImpl<ArrHashMap<K, V, n, Hasher>> {
+    using Type = Size<n>;
+};
+
+template<typename K, typename V, size_t n, typename Hasher>
+constexpr auto length(const ArrHashMap<K, V, n, Hasher>& as) -> size_t {
+    return as.size();
+}
+
+template<typename K, typename V, size_t n, typename Hasher>
+constexpr auto nth(size_t i, const ArrHashMap<K, V, n, Hasher>& as) -> const Pair<K, V>& {
+    return as.data()[i];
+}
+
+template<typename K, typename V, size_t n, typename Hasher>
+constexpr auto nth(size_t i, ArrHashMap<K, V, n, Hasher>& as) -> const Pair<K, V>& {
+    return as.data()[i];
+}
+
+template<typename K, typename Hasher, typename Allocator>
+struct ElementImpl<HashSet<K, Hasher, Allocator>> {
+    using Type = K;
+};
+
+template<typename K, typename Hasher, typename Allocator>
+struct CtSizeImpl<HashSet<K, Hasher, Allocator>> {
+    using Type = Size<dyn>;
+};
+
+template<typename K, typename Hasher, typename Allocator>
+struct CtCapacityImpl<HashSet<K, Hasher, Allocator>> {
+    using Type = Size<dyn>;
+};
+
+template<typename K, typename Hasher, typename Allocator>
+constexpr auto length(const HashSet<K, Hasher, Allocator>& as) -> size_t {
+    return as.size();
+}
+
+template<typename K, typename Hasher, typename Allocator>
+constexpr auto nth(size_t i, const HashSet<K, Hasher, Allocator>& as) -> const K& {
+    return as.data()[i];
+}
+
+template<typename K, typename Hasher, typename Allocator>
+constexpr auto nth(size_t i, HashSet<K, Hasher, Allocator>& as) -> const K& {
+    return as.data()[i];
+}
+
+template<typename K, size_t n, typename Hasher>
+struct ElementImpl<ArrHashSet<K, n, Hasher>> {
+    using Type = K;
+};
+
+template<typename K, size_t n, typename Hasher>
+struct CtSizeImpl<ArrHashSet<K, n, Hasher>> {
+    using Type = Size<dyn>;
+};
+
+template<typename K, size_t n, typename Hasher>
+struct CtCapacityImpl<ArrHashSet<K, n, Hasher>> {
+    using Type = Size<n>;
+};
+
+template<typename K, size_t n, typename Hasher>
+constexpr auto length(const ArrHashSet<K, n, Hasher>& as) -> size_t {
+    return as.size();
+}
+
+template<typename K, size_t n, typename Hasher>
+constexpr auto nth(size_t i, const ArrHashSet<K, n, Hasher>& as) -> const K& {
+    return as.data()[i];
+}
+
+template<typename K, size_t n, typename Hasher>
+constexpr auto nth(size_t i, ArrHashSet<K, n, Hasher>& as) -> const K& {
+    return as.data()[i];
+}
+
+}  // namespace efp
+
+#endif
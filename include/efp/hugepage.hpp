@@ -0,0 +1,186 @@
+#ifndef EFP_HUGEPAGE_HPP_
+#define EFP_HUGEPAGE_HPP_
+
+// ! Not for freestanding environments
+#if defined(__STDC_HOSTED__) && __STDC_HOSTED__ == 1
+
+    #include "efp/cpp_core.hpp"
+    #include "efp/allocator.hpp"
+
+    #if defined(__linux__)
+        #include <sys/mman.h>
+    #endif
+
+namespace efp {
+
+// Size of the default huge page of x86-64 and AArch64 with 4 KiB base pages
+constexpr size_t huge_page_size = 2 * 1024 * 1024;
+
+// HugePageMode
+// How the memory of an allocation is backed.
+// - None: Regular pages. Below the threshold, or huge pages are not available.
+// - Explicit: Pages from the reserved huge page pool with MAP_HUGETLB.
+// - Transparent: Huge page aligned mapping advised with MADV_HUGEPAGE. The kernel backs it with
+//   transparent huge pages if possible.
+enum class HugePageMode {
+    None,
+    Explicit,
+    Transparent,
+};
+
+namespace detail {
+    inline size_t round_up_to_huge_page(size_t bytes) {
+        return (bytes + huge_page_size - 1) & ~(huge_page_size - 1);
+    }
+
+    #if defined(__linux__)
+
+    // Map with MAP_HUGETLB first, then fall back to transparent huge page
+    inline void* huge_page_map(size_t bytes, HugePageMode& mode) {
+        const size_t size = round_up_to_huge_page(bytes);
+
+        #if defined(MAP_HUGETLB)
+        void* p = mmap(
+            nullptr,
+            size,
+            PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+            -1,
+            0
+        );
+
+        if (p != MAP_FAILED) {
+            mode = HugePageMode::Explicit;
+            return p;
+        }
+        #endif
+
+        // Over-map and trim, so that the mapping is aligned to the huge page
+        const size_t padded_size = size + huge_page_size;
+        void* raw =
+            mmap(nullptr, padded_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+        if (raw == MAP_FAILED) {
+            throw RuntimeError("HugePageAllocator::allocate: mmap failed");
+        }
+
+        char* begin = static_cast<char*>(raw);
+        char* aligned =
+            reinterpret_cast<char*>(round_up_to_huge_page(reinterpret_cast<uintptr_t>(raw)));
+        char* end = begin + padded_size;
+
+        if (aligned != begin) {
+            munmap(begin, static_cast<size_t>(aligned - begin));
+        }
+        if (aligned + size != end) {
+            munmap(aligned + size, static_cast<size_t>(end - (aligned + size)));
+        }
+
+        #if defined(MADV_HUGEPAGE)
+        mode = madvise(aligned, size, MADV_HUGEPAGE) == 0 ? HugePageMode::Transparent
+                                                          : HugePageMode::None;
+        #else
+        mode = HugePageMode::None;
+        #endif
+
+        return aligned;
+    }
+
+    inline void huge_page_unmap(void* p, size_t bytes) {
+        munmap(p, round_up_to_huge_page(bytes));
+    }
+
+    #endif
+}  // namespace detail
+
+// HugePageAllocator
+// Backs allocations of at least threshold bytes with huge pages to reduce TLB misses when scanning
+// very large buffers. Smaller allocations go to the global heap, so growing Vector starts on
+// regular pages and moves to huge pages once it gets large.
+// mode() reports the backing of the last allocation made through this instance, which is the
+// current buffer for an allocator obtained by Vector::get_allocator.
+// Falls back to the global heap on platforms other than Linux.
+template<typename A, size_t threshold = huge_page_size>
+class HugePageAllocator {
+public:
+    using value_type = A;
+    using pointer = A*;
+    using const_pointer = const A*;
+    using reference = A&;
+    using const_reference = const A&;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+
+    template<typename B>
+    struct rebind {
+        using other = HugePageAllocator<B, threshold>;
+    };
+
+    HugePageAllocator() noexcept : _mode(HugePageMode::None) {}
+
+    template<typename B>
+    HugePageAllocator(const HugePageAllocator<B, threshold>&) noexcept
+        : _mode(HugePageMode::None) {}
+
+    pointer allocate(size_type n) {
+        const size_t bytes = n * sizeof(A);
+
+    #if defined(__linux__)
+        if (bytes >= threshold) {
+            return static_cast<pointer>(detail::huge_page_map(bytes, _mode));
+        }
+    #endif
+
+        _mode = HugePageMode::None;
+        return static_cast<pointer>(::operator new(bytes));
+    }
+
+    void deallocate(pointer p, size_type n) {
+        const size_t bytes = n * sizeof(A);
+
+    #if defined(__linux__)
+        if (bytes >= threshold) {
+            detail::huge_page_unmap(p, bytes);
+            return;
+        }
+    #endif
+
+        ::operator delete(p);
+    }
+
+    size_type max_size() const noexcept {
+        return size_type(-1) / sizeof(A);
+    }
+
+    template<typename... Args>
+    void construct(pointer p, Args&&... args) {
+        new (p) A(efp::forward<Args>(args)...);
+    }
+
+    void destroy(pointer p) {
+        p->~A();
+    }
+
+    HugePageMode mode() const noexcept {
+        return _mode;
+    }
+
+private:
+    HugePageMode _mode;
+};
+
+template<typename A, typename B, size_t threshold>
+bool operator==(const HugePageAllocator<A, threshold>&, const HugePageAllocator<B, threshold>&) {
+    return true;
+}
+
+template<typename A, typename B, size_t threshold>
+bool operator!=(const HugePageAllocator<A, threshold>&, const HugePageAllocator<B, threshold>&) {
+    return false;
+}
+
+}  // namespace efp
+
+#endif  // __STDC_HOSTED__ && __STDC_HOSTED__ == 1
+
+#endif
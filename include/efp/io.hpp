@@ -17,7 +17,7 @@ public:
         FILE* file = std::fopen(path, mode);
 
         if (file) {
-            return efp::move(File {file, mode});
+            return efp::move(File {file});
         }
 
         return nothing;
@@ -27,7 +27,7 @@ public:
         FILE* file = std::fopen(path.c_str(), mode);
 
         if (file) {
-            return efp::move(File {file, mode});
+            return efp::move(File {file});
         }
 
         return nothing;
@@ -57,14 +57,39 @@ public:
     Maybe<String> read_line() {
         if (_file) {
             String buffer {};
-            int ch;
+            char chunk[256];
 
-            while ((ch = std::fgetc(_file)) != '\n' && ch != EOF) {
-                buffer.push_back(static_cast<char>(ch));
+            // fgets stops after a newline, so the stream is left right past the line. The chunk
+            // is filled with newlines first, so the end of what was read is found even past
+            // a NUL in the line: a read newline is followed by the terminator, and a filled one
+            // is preceded by it
+            while (true) {
+                std::memset(chunk, '\n', sizeof(chunk));
+
+                if (!std::fgets(chunk, sizeof(chunk), _file)) {
+                    break;
+                }
+
+                const char* newline =
+                    static_cast<const char*>(std::memchr(chunk, '\n', sizeof(chunk)));
+
+                if (newline == nullptr) {
+                    buffer.append(chunk, sizeof(chunk) - 1);
+                    continue;
+                }
+
+                const size_t position = newline - chunk;
+
+                if (position + 1 < sizeof(chunk) && chunk[position + 1] == '\0') {
+                    buffer.append(chunk, position);
+                    return buffer;
+                }
+
+                buffer.append(chunk, position - 1);
             }
 
             // Check for EOF condition
-            if (ch == EOF && buffer.empty())
+            if (buffer.empty())
                 return nothing;
 
             return buffer;
@@ -73,63 +98,30 @@ public:
         return nothing;
     }
 
-    Vector<String> read_lines() {
-        Vector<String> lines {};
-
-        bool keep_read = true;
+    Vector<String> read_lines();
 
-        while (keep_read) {
-            const auto maybe_line = read_line();
-
-            if (maybe_line) {
-                lines.push_back(maybe_line.value());
-            } else {
-                keep_read = false;
-            }
-        }
+    // Reads up to n bytes, returning the number read
+    size_t read(char* buffer, size_t n) {
+        if (_file == nullptr)
+            return 0;
 
-        return lines;
+        return std::fread(buffer, sizeof(char), n, _file);
     }
 
+    // fwrite translates the newlines of a text stream the same as fputc
     bool write(const char* data, size_t length = dyn) {
         if (_file == nullptr)
             return false;
 
-        if (std::strchr(_mode, 'b')) {
-            // Write binary data
-            if (length == dyn) {
-                length = std::strlen(data);
-            }
-
-            size_t written = std::fwrite(data, sizeof(char), length, _file);
-
-            return written == length;
-        } else {
-            // Write text data
-            if (length == dyn) {
-                length = std::strlen(data);
-            }
-
-            for (size_t i = 0; i < length; ++i) {
-                if (std::fputc(data[i], _file) == EOF)
-                    return false;
-            }
-
-            return true;
+        if (length == dyn) {
+            length = std::strlen(data);
         }
+
+        return std::fwrite(data, sizeof(char), length, _file) == length;
     }
 
     bool write(const String& data) {
-        if (_file == nullptr)
-            return false;
-
-        if (std::strchr(_mode, 'b')) {
-            // Write binary data
-            size_t written = std::fwrite(data.data(), sizeof(char), data.size(), _file);
-            return written == data.size();
-        } else {
-            return std::fputs(data.c_str(), _file) != EOF;
-        }
+        return write(data.data(), data.size());
     }
 
     int flush() {
@@ -154,15 +146,352 @@ public:
     }
 
 private:
-    explicit File(FILE* file, const char* mode) : _file(file) {
-        std::strncpy(_mode, mode, sizeof(_mode) - 1);
-        _mode[sizeof(_mode) - 1] = '\0';
-    }
+    explicit File(FILE* file) : _file(file) {}
 
     FILE* _file;
-    char _mode[8];
 };
 
+// LineReader
+// Reads lines of a File in large blocks, returning views into its buffer instead of a String per
+// line. Newlines are found with memchr over the block, and a line crossing the end of a block is
+// moved to the front before the next read. The buffer grows for a line longer than itself.
+// A view stays valid until the next call of next.
+//
+//     LineReader reader {file};
+//     while (const auto line = reader.next()) {
+//         consume(line.value());
+//     }
+class LineReader {
+public:
+    explicit LineReader(File& file, size_t block_size = 1 << 16)
+        : _file(file), _buffer(), _begin(0), _end(0), _eof(false) {
+        _buffer.resize(block_size == 0 ? 1 : block_size);
+    }
+
+    // Next line without the newline, nothing at the end of the file
+    Maybe<StringView> next() {
+        while (true) {
+            const char* begin = _buffer.data() + _begin;
+            const void* newline = std::memchr(begin, '\n', _end - _begin);
+
+            if (newline) {
+                const size_t length = static_cast<const char*>(newline) - begin;
+                _begin += length + 1;
+                return StringView(begin, length);
+            }
+
+            if (_eof) {
+                if (_begin == _end) {
+                    return nothing;
+                }
+
+                // Last line without a newline
+                const size_t length = _end - _begin;
+                _begin = _end;
+                return StringView(begin, length);
+            }
+
+            _fill();
+        }
+    }
+
+private:
+    // Moves the partial line to the front and reads the next block after it
+    void _fill() {
+        const size_t partial = _end - _begin;
+
+        if (_begin != 0) {
+            std::memmove(_buffer.data(), _buffer.data() + _begin, partial);
+        } else if (partial == _buffer.size()) {
+            _buffer.resize(2 * _buffer.size());
+        }
+
+        _begin = 0;
+        _end = partial;
+
+        const size_t read = _file.read(_buffer.data() + _end, _buffer.size() - _end);
+        _end += read;
+        _eof = read == 0;
+    }
+
+    File& _file;
+    Vector<char> _buffer;
+    size_t _begin;
+    size_t _end;
+    bool _eof;
+};
+
+// FlushPolicy
+// When a BufWriter hands its buffer to the File and flushes the File.
+// - Full: Only when the buffer is full, on flush, and on destruction. For throughput.
+// - Line: Also after a write containing a newline. For logs read while written.
+// - Always: After every write. For latency.
+enum class FlushPolicy {
+    Full,
+    Line,
+    Always,
+};
+
+// BufWriter
+// Buffers writes to a File, so that many small writes become a few large ones. Writes larger
+// than the buffer go to the File directly. format_to formats into the free space of the buffer,
+// without an intermediate String. The buffer is flushed on destruction.
+//
+//     BufWriter out {file, 1 << 16};
+//     out.write_all(name, ",", value, "\n");
+//     format_to(out, "{},{}\n", id, price);
+class BufWriter {
+public:
+    explicit BufWriter(
+        File& file,
+        size_t capacity = 1 << 16,
+        FlushPolicy policy = FlushPolicy::Full
+    )
+        : _file(file), _buffer(), _size(0), _policy(policy) {
+        _buffer.resize(capacity < min_capacity ? min_capacity : capacity);
+    }
+
+    BufWriter(const BufWriter&) = delete;
+
+    BufWriter& operator=(const BufWriter&) = delete;
+
+    ~BufWriter() {
+        flush();
+    }
+
+    bool write(const char* data, size_t n) {
+        return _write(data, n) && _apply_policy(data, n);
+    }
+
+    bool write(const StringView& s) {
+        return write(s.data(), s.size());
+    }
+
+    bool write(const char* c_str) {
+        return write(c_str, std::strlen(c_str));
+    }
+
+    bool write(char c) {
+        return write(&c, 1);
+    }
+
+    // Writes the views in order, applying the flush policy once at the end
+    template<typename View, typename... Views>
+    bool write_all(const View& view, const Views&... views) {
+        const StringView all[] = {StringView(view), StringView(views)...};
+        const size_t n = 1 + sizeof...(Views);
+
+        bool has_newline = false;
+        for (size_t i = 0; i < n; ++i) {
+            if (!_write(all[i].data(), all[i].size())) {
+                return false;
+            }
+            has_newline = has_newline || _has_newline(all[i].data(), all[i].size());
+        }
+
+        return _policy == FlushPolicy::Full
+            || (_policy == FlushPolicy::Line && !has_newline)
+            || flush();
+    }
+
+    // Space for n bytes in the buffer, to be written in place and then committed. Drains the
+    // buffer if it has less room. Null if n exceeds the capacity or draining failed
+    char* reserve(size_t n) {
+        if (n > _buffer.size()) {
+            return nullptr;
+        }
+
+        if (n > _buffer.size() - _size && !_drain()) {
+            return nullptr;
+        }
+
+        return _buffer.data() + _size;
+    }
+
+    // Appends n bytes written to the space given by reserve, applying the flush policy
+    bool commit(size_t n) {
+        _size += n;
+        return _apply_policy(_buffer.data() + _size - n, n);
+    }
+
+    // Hands the buffer to the File and flushes the File
+    bool flush() {
+        return _drain() && _file.flush() == 0;
+    }
+
+    // Number of bytes not yet handed to the File
+    size_t buffered() const {
+        return _size;
+    }
+
+    size_t capacity() const {
+        return _buffer.size();
+    }
+
+    FlushPolicy policy() const {
+        return _policy;
+    }
+
+private:
+    template<typename... Args>
+    friend bool format_to(BufWriter& writer, FormatString<Args...> fmt, Args&&... args);
+
+    #if __cplusplus >= 201402L
+    template<typename S, typename... Args>
+    friend bool format_to(BufWriter& writer, const CompiledFormat<S>& fmt, const Args&... args);
+    #endif
+
+    // Lets fmt write into the free space of the buffer, draining it when full
+    class FormatBuffer final: public efp_fmt::detail::buffer<char> {
+    public:
+        explicit FormatBuffer(BufWriter& writer)
+            : efp_fmt::detail::buffer<char>(
+                writer._buffer.data() + writer._size,
+                0,
+                writer._buffer.size() - writer._size
+            ),
+              _writer(writer), _ok(true), _has_newline(false) {}
+
+        // Commits the formatted bytes to the writer
+        bool finish() {
+            _commit();
+            return _ok;
+        }
+
+        bool has_newline() const {
+            return _has_newline;
+        }
+
+    protected:
+        void grow(size_t) override {
+            _commit();
+            _ok = _ok && _writer._drain();
+
+            // Keep formatting into the buffer even on failure, which is reported by finish
+            _writer._size = 0;
+            set(_writer._buffer.data(), _writer._buffer.size());
+        }
+
+    private:
+        void _commit() {
+            _has_newline = _has_newline || BufWriter::_has_newline(data(), size());
+            _writer._size += size();
+            clear();
+            set(_writer._buffer.data() + _writer._size, _writer._buffer.size() - _writer._size);
+        }
+
+        BufWriter& _writer;
+        bool _ok;
+        bool _has_newline;
+    };
+
+    static constexpr size_t min_capacity = 64;
+
+    static bool _has_newline(const char* data, size_t n) {
+        return n != 0 && std::memchr(data, '\n', n) != nullptr;
+    }
+
+    bool _write(const char* data, size_t n) {
+        if (n <= _buffer.size() - _size) {
+            _memcpy(_buffer.data() + _size, data, n);
+            _size += n;
+            return true;
+        }
+
+        if (!_drain()) {
+            return false;
+        }
+
+        if (n >= _buffer.size()) {
+            return _file.write(data, n);
+        }
+
+        _memcpy(_buffer.data(), data, n);
+        _size = n;
+        return true;
+    }
+
+    // Commits the output of format_to and applies the policy to it
+    bool _finish_format(FormatBuffer& buffer) {
+        if (!buffer.finish()) {
+            return false;
+        }
+
+        switch (_policy) {
+            case FlushPolicy::Always:
+                return flush();
+            case FlushPolicy::Line:
+                return !buffer.has_newline() || flush();
+            default:
+                return true;
+        }
+    }
+
+    bool _apply_policy(const char* data, size_t n) {
+        switch (_policy) {
+            case FlushPolicy::Always:
+                return flush();
+            case FlushPolicy::Line:
+                return !_has_newline(data, n) || flush();
+            default:
+                return true;
+        }
+    }
+
+    // Hands the buffered bytes to the File
+    bool _drain() {
+        if (_size == 0) {
+            return true;
+        }
+
+        const bool ok = _file.write(_buffer.data(), _size);
+        _size = 0;
+        return ok;
+    }
+
+    File& _file;
+    Vector<char> _buffer;
+    size_t _size;
+    FlushPolicy _policy;
+};
+
+// format_to
+// Formats into the buffer of the writer. Returns false if handing the buffer to the File failed
+template<typename... Args>
+inline bool format_to(BufWriter& writer, FormatString<Args...> fmt, Args&&... args) {
+    BufWriter::FormatBuffer buffer {writer};
+    efp_fmt::detail::vformat_to<char>(buffer, fmt, efp_fmt::make_format_args(args...), {});
+    return writer._finish_format(buffer);
+}
+
+    #if __cplusplus >= 201402L
+template<typename S, typename... Args>
+inline bool format_to(BufWriter& writer, const CompiledFormat<S>&, const Args&... args) {
+    BufWriter::FormatBuffer buffer {writer};
+    CompiledFormat<S>::write(buffer, args...);
+    return writer._finish_format(buffer);
+}
+    #endif
+
+// File::read_lines
+// Copies each line once, out of the buffer of a LineReader
+inline Vector<String> File::read_lines() {
+    Vector<String> lines {};
+    LineReader reader {*this};
+
+    while (true) {
+        const Maybe<StringView> line = reader.next();
+        if (!line) {
+            break;
+        }
+
+        const StringView& view = line.value();
+        lines.push_back(String(view.data(), view.size()));
+    }
+
+    return lines;
+}
+
 };  // namespace efp
 
 #endif  // __STDC_HOSTED__ == 1
@@ -0,0 +1,532 @@
+#ifndef EFP_LOGGER_HPP_
+#define EFP_LOGGER_HPP_
+
+// ! Not for freestanding environments
+#if defined(__STDC_HOSTED__) && __STDC_HOSTED__ == 1
+
+    #include <atomic>
+    #include <chrono>
+    #include <condition_variable>
+    #include <exception>
+    #include <mutex>
+    #include <thread>
+
+    #include "efp/cpp_core.hpp"
+    #include "efp/meta.hpp"
+    #include "efp/sequence.hpp"
+    #include "efp/string.hpp"
+    #include "efp/hash.hpp"
+    #include "efp/format.hpp"
+    #include "efp/io.hpp"
+
+namespace efp {
+
+// OverflowPolicy
+// What AsyncLogger::log does when the ring of the calling thread is full.
+// - Block: Waits for the background thread to make room.
+// - Drop: Discards the message.
+// - Count: Discards the message, and the background thread logs how many were discarded.
+enum class OverflowPolicy {
+    Block,
+    Drop,
+    Count,
+};
+
+namespace detail {
+    // How an argument is copied into a ring and read back for formatting. Values are copied as
+    // bytes, so they must be trivially copyable
+    template<typename A, typename = void>
+    struct LogArg {
+        static_assert(
+            std::is_trivially_copyable<A>::value,
+            "AsyncLogger: arguments must be trivially copyable or strings"
+        );
+
+        using Decoded = A;
+
+        static size_t size(const A&) {
+            return sizeof(A);
+        }
+
+        static char* encode(char* out, const A& a) {
+            _memcpy(out, &a, sizeof(A));
+            return out + sizeof(A);
+        }
+
+        static A decode(const char*& in) {
+            A a;
+            _memcpy(&a, in, sizeof(A));
+            in += sizeof(A);
+            return a;
+        }
+    };
+
+    // Strings are copied as the length followed by the characters, and read back as views
+    struct LogStringArg {
+        using Decoded = efp_fmt::string_view;
+
+        static size_t size(const char*, size_t length) {
+            return sizeof(size_t) + length;
+        }
+
+        static char* encode(char* out, const char* data, size_t length) {
+            _memcpy(out, &length, sizeof(size_t));
+            _memcpy(out + sizeof(size_t), data, length);
+            return out + sizeof(size_t) + length;
+        }
+
+        static Decoded decode(const char*& in) {
+            size_t length;
+            _memcpy(&length, in, sizeof(size_t));
+
+            const Decoded result {in + sizeof(size_t), length};
+            in += sizeof(size_t) + length;
+            return result;
+        }
+    };
+
+    template<typename A>
+    struct LogArg<A, EnableIf<IsStringLike<A>::value>>: LogStringArg {
+        static size_t size(const A& s) {
+            return LogStringArg::size(s.data(), s.size());
+        }
+
+        static char* encode(char* out, const A& s) {
+            return LogStringArg::encode(out, s.data(), s.size());
+        }
+    };
+
+    template<>
+    struct LogArg<const char*>: LogStringArg {
+        static size_t size(const char* s) {
+            return LogStringArg::size(s, std::strlen(s));
+        }
+
+        static char* encode(char* out, const char* s) {
+            return LogStringArg::encode(out, s, std::strlen(s));
+        }
+    };
+
+    template<>
+    struct LogArg<char*>: LogArg<const char*> {};
+
+    template<size_t n>
+    struct LogArg<char[n]>: LogArg<const char*> {};
+
+    inline size_t log_args_size() {
+        return 0;
+    }
+
+    template<typename A, typename... As>
+    inline size_t log_args_size(const A& a, const As&... as) {
+        return LogArg<A>::size(a) + log_args_size(as...);
+    }
+
+    inline void log_encode(char*) {}
+
+    template<typename A, typename... As>
+    inline void log_encode(char* out, const A& a, const As&... as) {
+        log_encode(LogArg<A>::encode(out, a), as...);
+    }
+
+    template<typename Values, int... is>
+    inline void log_format_values(
+        BufWriter& out,
+        efp_fmt::string_view fmt,
+        const Values& values,
+        IndexSequence<is...>
+    ) {
+        format_to(out, efp_fmt::runtime(fmt), values.template get<is>()...);
+    }
+
+    // Decodes the arguments of a record and formats them as a line
+    template<typename... Args>
+    inline void log_format(BufWriter& out, efp_fmt::string_view fmt, const char* in) {
+        // Braced initialization decodes in order
+        const Tuple<typename LogArg<Args>::Decoded...> values {LogArg<Args>::decode(in)...};
+        (void)in;  // Without arguments
+
+        log_format_values(out, fmt, values, IndexSequenceFor<Args...> {});
+        out.write('\n');
+    }
+
+    // Header of a record in a ring, followed by the encoded arguments
+    struct LogRecord {
+        // Null for the padding up to the end of the ring
+        void (*format)(BufWriter&, efp_fmt::string_view, const char*);
+        const char* fmt;
+        size_t fmt_size;
+        // Of the whole record, a multiple of the alignment of the header
+        size_t size;
+    };
+
+    // Single producer single consumer ring of records. A record is never split across the end,
+    // the producer pads up to the end instead. A record takes at most half the ring, so the
+    // padding and the record together always fit once the consumer catches up. A larger one
+    // would overlap the padding it leaves behind and could never be reserved
+    class LogRing {
+    public:
+        LogRing(size_t capacity, std::thread::id owner)
+            : _data(), _mask(capacity - 1), _owner(owner), _tail(0), _reserved(0), _head_cache(0),
+              _head(0) {
+            _data.resize(capacity);
+        }
+
+        LogRing(const LogRing&) = delete;
+
+        LogRing& operator=(const LogRing&) = delete;
+
+        size_t capacity() const {
+            return _mask + 1;
+        }
+
+        std::thread::id owner() const {
+            return _owner;
+        }
+
+        size_t max_record_size() const {
+            return capacity() / 2;
+        }
+
+        // Space for a record of the size, at most max_record_size, null if the ring is full.
+        // Producer only
+        char* reserve(size_t size) {
+            const uint64_t tail = _tail.load(std::memory_order_relaxed);
+            const size_t offset = static_cast<size_t>(tail) & _mask;
+            const size_t to_end = capacity() - offset;
+            const size_t total = size <= to_end ? size : to_end + size;
+
+            if (tail + total - _head_cache > capacity()) {
+                _head_cache = _head.load(std::memory_order_acquire);
+
+                if (tail + total - _head_cache > capacity()) {
+                    return nullptr;
+                }
+            }
+
+            _reserved = tail + total;
+
+            if (size <= to_end) {
+                return _data.data() + offset;
+            }
+
+            // The consumer skips a tail shorter than a header without reading it
+            if (to_end >= sizeof(LogRecord)) {
+                const LogRecord padding {nullptr, nullptr, 0, to_end};
+                _memcpy(_data.data() + offset, &padding, sizeof(LogRecord));
+            }
+            return _data.data();
+        }
+
+        // Publishes the reserved record. Producer only
+        void commit() {
+            _tail.store(_reserved, std::memory_order_release);
+        }
+
+        // Formats the published records into the writer. Returns the number of them. Consumer
+        // only
+        size_t drain(BufWriter& out) {
+            uint64_t head = _head.load(std::memory_order_relaxed);
+            const uint64_t tail = _tail.load(std::memory_order_acquire);
+            size_t count = 0;
+
+            while (head != tail) {
+                const size_t offset = static_cast<size_t>(head) & _mask;
+                const size_t to_end = capacity() - offset;
+
+                LogRecord record;
+                if (to_end >= sizeof(LogRecord)) {
+                    _memcpy(&record, _data.data() + offset, sizeof(LogRecord));
+                }
+
+                if (to_end < sizeof(LogRecord) || record.format == nullptr) {
+                    head += to_end;
+                    continue;
+                }
+
+                _format(out, record, _data.data() + offset + sizeof(LogRecord));
+
+                head += record.size;
+                _head.store(head, std::memory_order_release);
+                ++count;
+            }
+
+            _head.store(head, std::memory_order_release);
+            return count;
+        }
+
+    private:
+        // A bad format string is reported in the log, rather than ending the background thread
+        static void _format(BufWriter& out, const LogRecord& record, const char* args) {
+            try {
+                record.format(out, efp_fmt::string_view(record.fmt, record.fmt_size), args);
+            } catch (const std::exception& e) {
+                out.write_all("AsyncLogger: ", StringView {e.what()}, "\n");
+            }
+        }
+
+        Vector<char> _data;
+        size_t _mask;
+        std::thread::id _owner;
+        char _shared_pad[64];
+
+        // Producer side
+        std::atomic<uint64_t> _tail;
+        uint64_t _reserved;
+        uint64_t _head_cache;
+        char _producer_pad[64];
+
+        // Consumer side
+        std::atomic<uint64_t> _head;
+    };
+
+    // Ring of the logger last used by the thread
+    struct LogRingCache {
+        uint64_t logger;
+        LogRing* ring;
+    };
+
+    inline LogRingCache& log_ring_cache() {
+        static thread_local LogRingCache cache {0, nullptr};
+        return cache;
+    }
+
+    // Ids are never reused, unlike addresses, so a cache never matches a later logger
+    inline uint64_t next_logger_id() {
+        static std::atomic<uint64_t> next {1};
+        return next.fetch_add(1, std::memory_order_relaxed);
+    }
+}  // namespace detail
+
+// AsyncLogger
+// Logs lines to a File from a background thread. log only copies the argument values and the
+// pointer to the format string into a ring of the calling thread, and the background thread
+// formats them with efp::format into a BufWriter. Strings are copied, other arguments must be
+// trivially copyable. The format string must outlive the logger, as a literal does.
+// Lines of a thread keep their order, while lines of different threads are interleaved by
+// batches. Everything logged is written and flushed on destruction. A line with its arguments
+// takes at most half the ring, a longer one throws under Block and is discarded otherwise.
+//
+//     AsyncLogger logger {file};
+//     logger.log("order {} filled at {:.2f}", id, price);
+class AsyncLogger {
+public:
+    explicit AsyncLogger(
+        File& file,
+        size_t ring_capacity = 1 << 16,
+        OverflowPolicy policy = OverflowPolicy::Block
+    )
+        : _id(detail::next_logger_id()), _ring_capacity(_ring_size(ring_capacity)),
+          _policy(policy), _writer(file), _rings(), _ring_count(0), _dropped(0),
+          _flush_requested(0), _flushed(0), _stopping(false) {
+        _thread = std::thread([this] { _run(); });
+    }
+
+    AsyncLogger(const AsyncLogger&) = delete;
+
+    AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+    ~AsyncLogger() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stopping.store(true, std::memory_order_release);
+        }
+        _wake.notify_one();
+        _thread.join();
+
+        for (size_t i = 0; i < _rings.size(); ++i) {
+            delete _rings[i];
+        }
+    }
+
+    // Queues a line. Returns false if it was discarded by the overflow policy
+    template<typename... Args>
+    bool log(FormatString<Args...> fmt, const Args&... args) {
+        const efp_fmt::string_view f = fmt;
+        const size_t size =
+            _record_size(sizeof(detail::LogRecord) + detail::log_args_size(args...));
+
+        detail::LogRing& ring = _ring();
+
+        char* p = size <= ring.max_record_size() ? ring.reserve(size) : nullptr;
+        if (p == nullptr) {
+            p = _overflow(ring, size);
+
+            if (p == nullptr) {
+                return false;
+            }
+        }
+
+        const detail::LogRecord record {&detail::log_format<Args...>, f.data(), f.size(), size};
+        _memcpy(p, &record, sizeof(detail::LogRecord));
+        detail::log_encode(p + sizeof(detail::LogRecord), args...);
+
+        ring.commit();
+        return true;
+    }
+
+    // Waits until the lines logged before are written and the File is flushed
+    void flush() {
+        std::unique_lock<std::mutex> lock(_mutex);
+        const uint64_t ticket = _flush_requested.fetch_add(1) + 1;
+
+        _wake.notify_one();
+        _flushed_cv.wait(lock, [&] { return _flushed >= ticket; });
+    }
+
+    // Number of lines discarded by the overflow policy
+    size_t dropped() const {
+        return _dropped.load(std::memory_order_relaxed);
+    }
+
+    OverflowPolicy policy() const {
+        return _policy;
+    }
+
+    // Capacity in bytes of the ring of each thread
+    size_t ring_capacity() const {
+        return _ring_capacity;
+    }
+
+private:
+    static constexpr size_t min_ring_capacity = 256;
+
+    static size_t _ring_size(size_t capacity) {
+        size_t size = min_ring_capacity;
+        while (size < capacity) {
+            size *= 2;
+        }
+        return size;
+    }
+
+    static size_t _record_size(size_t size) {
+        const size_t align = alignof(detail::LogRecord);
+        return (size + align - 1) / align * align;
+    }
+
+    // The ring of the calling thread, made on the first use
+    detail::LogRing& _ring() {
+        detail::LogRingCache& cache = detail::log_ring_cache();
+        if (cache.logger == _id) {
+            return *cache.ring;
+        }
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        const std::thread::id self = std::this_thread::get_id();
+
+        // A thread with the id of an exited one takes over its ring
+        detail::LogRing* ring = nullptr;
+        for (size_t i = 0; i < _rings.size() && ring == nullptr; ++i) {
+            if (_rings[i]->owner() == self) {
+                ring = _rings[i];
+            }
+        }
+
+        if (ring == nullptr) {
+            ring = new detail::LogRing(_ring_capacity, self);
+            _rings.push_back(ring);
+            _ring_count.store(_rings.size(), std::memory_order_release);
+        }
+
+        cache = detail::LogRingCache {_id, ring};
+        return *ring;
+    }
+
+    char* _overflow(detail::LogRing& ring, size_t size) {
+        if (_policy != OverflowPolicy::Block) {
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        if (size > ring.max_record_size()) {
+            throw RuntimeError("AsyncLogger::log: line larger than half the ring");
+        }
+
+        _wake.notify_one();
+
+        char* p;
+        while ((p = ring.reserve(size)) == nullptr) {
+            std::this_thread::yield();
+        }
+        return p;
+    }
+
+    // Background thread
+    void _run() {
+        Vector<detail::LogRing*> rings {};
+        size_t reported = 0;
+
+        while (true) {
+            // Read before draining, so that the lines logged before a request are drained
+            const uint64_t requested = _flush_requested.load(std::memory_order_acquire);
+            const bool stopping = _stopping.load(std::memory_order_acquire);
+
+            if (_ring_count.load(std::memory_order_acquire) != rings.size()) {
+                std::lock_guard<std::mutex> lock(_mutex);
+                rings = _rings;
+            }
+
+            size_t count = 0;
+            for (size_t i = 0; i < rings.size(); ++i) {
+                count += rings[i]->drain(_writer);
+            }
+
+            if (_policy == OverflowPolicy::Count) {
+                const size_t dropped = _dropped.load(std::memory_order_relaxed);
+
+                if (dropped != reported) {
+                    format_to(_writer, "AsyncLogger: {} lines dropped\n", dropped - reported);
+                    reported = dropped;
+                }
+            }
+
+            if (stopping) {
+                _writer.flush();
+                return;
+            }
+
+            if (count == 0 || requested != _flushed) {
+                _writer.flush();
+            }
+
+            std::unique_lock<std::mutex> lock(_mutex);
+
+            if (requested != _flushed) {
+                _flushed = requested;
+                _flushed_cv.notify_all();
+            }
+
+            if (count == 0) {
+                _wake.wait_for(lock, std::chrono::milliseconds(1), [&] {
+                    return _stopping.load(std::memory_order_relaxed)
+                        || _flush_requested.load(std::memory_order_relaxed) != requested;
+                });
+            }
+        }
+    }
+
+    const uint64_t _id;
+    const size_t _ring_capacity;
+    const OverflowPolicy _policy;
+    BufWriter _writer;
+
+    Vector<detail::LogRing*> _rings;
+    std::atomic<size_t> _ring_count;
+    std::atomic<size_t> _dropped;
+
+    std::mutex _mutex;
+    std::condition_variable _wake;
+    std::condition_variable _flushed_cv;
+    std::atomic<uint64_t> _flush_requested;
+    // Last flush request done, guarded by the mutex
+    uint64_t _flushed;
+    std::atomic<bool> _stopping;
+
+    std::thread _thread;
+};
+
+}  // namespace efp
+
+#endif  // __STDC_HOSTED__ && __STDC_HOSTED__ == 1
+
+#endif
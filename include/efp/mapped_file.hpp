@@ -0,0 +1,201 @@
+#ifndef EFP_MAPPED_FILE_HPP_
+#define EFP_MAPPED_FILE_HPP_
+
+// ! Not for freestanding environments
+#if defined(__STDC_HOSTED__) && __STDC_HOSTED__ == 1
+
+    #include "efp/cpp_core.hpp"
+    #include "efp/maybe.hpp"
+    #include "efp/sequence.hpp"
+    #include "efp/string.hpp"
+
+    #if defined(__unix__) || defined(__APPLE__)
+        #include <fcntl.h>
+        #include <sys/mman.h>
+        #include <sys/stat.h>
+        #include <unistd.h>
+    #endif
+
+namespace efp {
+
+    #if defined(__unix__) || defined(__APPLE__)
+
+// MapAdvice
+// Expected access pattern of a mapping, passed on to madvise.
+// - Normal: No particular pattern.
+// - Sequential: Read ahead aggressively and drop the pages behind.
+// - Random: Do not read ahead.
+// - WillNeed: Read the range ahead of the access.
+// - DontNeed: The range will not be accessed soon.
+enum class MapAdvice {
+    Normal,
+    Sequential,
+    Random,
+    WillNeed,
+    DontNeed,
+};
+
+// MappedFile
+// Read only memory mapping of a whole file, unmapped on destruction. The contents are exposed as
+// views, so the sequence functions run over the file without copying it into memory first.
+//
+//     const auto file = MappedFile::open("data.csv").move();
+//     file.advise(MapAdvice::Sequential);
+//     foldl([](size_t acc, char c) { return acc + (c == '\n'); }, size_t(0), file.chars());
+class MappedFile {
+public:
+    static Maybe<MappedFile> open(const char* path) {
+        const int fd = ::open(path, O_RDONLY);
+        if (fd < 0) {
+            return nothing;
+        }
+
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            return nothing;
+        }
+
+        const size_t size = static_cast<size_t>(st.st_size);
+        void* data = nullptr;
+
+        // An empty mapping is not allowed, hence an empty file is an empty view
+        if (size != 0) {
+            data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+
+        // The mapping keeps the file referenced
+        ::close(fd);
+
+        if (data == MAP_FAILED) {
+            return nothing;
+        }
+
+        return MappedFile {data, size};
+    }
+
+    static Maybe<MappedFile> open(const String& path) {
+        return open(path.c_str());
+    }
+
+    MappedFile(const MappedFile&) = delete;
+
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept : _data(other._data), _size(other._size) {
+        other._data = nullptr;
+        other._size = 0;
+    }
+
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            _unmap();
+
+            _data = other._data;
+            _size = other._size;
+
+            other._data = nullptr;
+            other._size = 0;
+        }
+        return *this;
+    }
+
+    ~MappedFile() {
+        _unmap();
+    }
+
+    // Size of the file in bytes
+    size_t size() const {
+        return _size;
+    }
+
+    bool empty() const {
+        return _size == 0;
+    }
+
+    const uint8_t* data() const {
+        return static_cast<const uint8_t*>(_data);
+    }
+
+    VectorView<const char> chars() const {
+        return VectorView<const char>(static_cast<const char*>(_data), _size);
+    }
+
+    VectorView<const uint8_t> bytes() const {
+        return VectorView<const uint8_t>(data(), _size);
+    }
+
+    // The file as an array of trivially copyable records. The size must be a multiple of the
+    // record size. The mapping is page aligned, so the records are aligned
+    template<typename A>
+    VectorView<const A> view() const {
+        static_assert(
+            std::is_trivially_copyable<A>::value,
+            "MappedFile::view: records must be trivially copyable"
+        );
+
+        if (_size % sizeof(A) != 0) {
+            throw RuntimeError("MappedFile::view: size is not a multiple of the record size");
+        }
+
+        return VectorView<const A>(static_cast<const A*>(_data), _size / sizeof(A));
+    }
+
+    // Advises the access pattern of the byte range, the whole file by default
+    bool advise(MapAdvice advice, size_t offset = 0, size_t length = dyn) const {
+        if (offset >= _size) {
+            return _size == 0;
+        }
+
+        if (length > _size - offset) {
+            length = _size - offset;
+        }
+
+        // madvise takes a page aligned address
+        const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+        const size_t aligned_offset = offset / page * page;
+
+        return ::madvise(
+                   static_cast<char*>(_data) + aligned_offset,
+                   length + (offset - aligned_offset),
+                   _madvise_flag(advice)
+               )
+            == 0;
+    }
+
+private:
+    MappedFile(void* data, size_t size) : _data(data), _size(size) {}
+
+    static int _madvise_flag(MapAdvice advice) {
+        switch (advice) {
+            case MapAdvice::Sequential:
+                return MADV_SEQUENTIAL;
+            case MapAdvice::Random:
+                return MADV_RANDOM;
+            case MapAdvice::WillNeed:
+                return MADV_WILLNEED;
+            case MapAdvice::DontNeed:
+                return MADV_DONTNEED;
+            default:
+                return MADV_NORMAL;
+        }
+    }
+
+    void _unmap() {
+        if (_data != nullptr) {
+            ::munmap(_data, _size);
+            _data = nullptr;
+        }
+    }
+
+    void* _data;
+    size_t _size;
+};
+
+    #endif  // __unix__ || __APPLE__
+
+}  // namespace efp
+
+#endif  // __STDC_HOSTED__ && __STDC_HOSTED__ == 1
+
+#endif
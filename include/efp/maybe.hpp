@@ -11,6 +11,15 @@ struct Nothing {};
 
 constexpr Nothing nothing;
 
+// All Nothings are equal, so that Maybe could be compared and hashed
+constexpr bool operator==(const Nothing&, const Nothing&) {
+    return true;
+}
+
+constexpr bool operator!=(const Nothing&, const Nothing&) {
+    return false;
+}
+
 // Specialization of Enum for Maybe
 
 template<typename A>
@@ -516,8 +516,6 @@ public:
     // Rvalue constructor, using efp::move to ensure the object is moved
     TupleLeaf(A&& value) : _value(move(value)) {}
 
-    ~TupleLeaf() {}
-
     const A& get() const {
         return _value;
     }
@@ -859,11 +857,14 @@ using IsConstructible = Bool<std::is_constructible<A, Args...>::value>;
 // };
 
 // RawStorage
-template<typename A, size_t n>
+// Alignment could be raised above alignof(A), e.g. to the cache line or SIMD register width
+template<typename A, size_t n, size_t align = alignof(A)>
 struct RawStorage {
     static_assert(sizeof(A) % alignof(A) == 0, "Size of A must be a multiple of its alignment");
+    static_assert((align & (align - 1)) == 0, "Alignment must be a power of two");
+    static_assert(align >= alignof(A), "Alignment must not be weaker than alignof(A)");
 
-    alignas(alignof(A)) char _data[n * sizeof(A)];
+    alignas(align) char _data[n * sizeof(A)];
 
     inline const A& operator[](size_t i) const {
         return reinterpret_cast<const A*>(_data)[i];
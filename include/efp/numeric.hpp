@@ -126,14 +126,59 @@ constexpr Element<As> max_min(const As& as) {
     return max_elem(as) - min_elem(as);
 }
 
+// IsOverAligned
+// True if the storage of the sequence is known to be aligned beyond the element alignment
+template<typename As>
+using IsOverAligned = Bool<(CtAlign<As>::value > alignof(Element<As>))>;
+
+namespace detail {
+    // Fallback for the sequences without alignment guarantee
+    template<typename As>
+    Element<As> sum_impl(const As& as, False) {
+        return foldl(op_add, static_cast<Element<As>>(0), as);
+    }
+
+    // Alignment hint lets the compiler use aligned vector loads without peeling loop
+    template<typename As>
+    Element<As> sum_impl(const As& as, True) {
+        const auto* p = assume_aligned<CtAlign<As>::value>(data(as));
+        const size_t as_len = length(as);
+
+        Element<As> res = static_cast<Element<As>>(0);
+        for (size_t i = 0; i < as_len; ++i) {
+            res = res + p[i];
+        }
+
+        return res;
+    }
+
+    template<typename As>
+    Element<As> product_impl(const As& as, False) {
+        return foldl(op_mul, static_cast<Element<As>>(1), as);
+    }
+
+    template<typename As>
+    Element<As> product_impl(const As& as, True) {
+        const auto* p = assume_aligned<CtAlign<As>::value>(data(as));
+        const size_t as_len = length(as);
+
+        Element<As> res = static_cast<Element<As>>(1);
+        for (size_t i = 0; i < as_len; ++i) {
+            res = res * p[i];
+        }
+
+        return res;
+    }
+}  // namespace detail
+
 template<typename As>
 constexpr Element<As> sum(const As& as) {
-    return foldl(op_add, static_cast<Element<As>>(0), as);
+    return detail::sum_impl(as, IsOverAligned<As> {});
 }
 
 template<typename As>
 constexpr Element<As> product(const As& as) {
-    return foldl(op_mul, static_cast<Element<As>>(1), as);
+    return detail::product_impl(as, IsOverAligned<As> {});
 }
 
 }  // namespace efp
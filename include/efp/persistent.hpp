@@ -0,0 +1,395 @@
+#ifndef EFP_PERSISTENT_HPP_
+#define EFP_PERSISTENT_HPP_
+
+#include "efp/cpp_core.hpp"
+#include "efp/meta.hpp"
+#include "efp/trait.hpp"
+
+namespace efp {
+
+// PVector
+// Persistent vector implemented as 32-way trie with structural sharing between versions.
+// set, push_back are O(log32 n) path copies. pop_back and slice are O(1) and share the whole trie.
+// Nodes are reference counted, and a node exclusively owned by a vector is mutated in place, which
+// makes batch updates through PVector::Transient cheap.
+
+template<typename A>
+class PVector {
+public:
+    using Element = A;
+    using CtSize = Size<dyn>;
+    using CtCapacity = Size<dyn>;
+
+    // STL compatible types
+    using value_type = Element;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using const_reference = const value_type&;
+
+    class Transient;
+
+    PVector() : _root(nullptr), _shift(0), _offset(0), _size(0) {}
+
+    PVector(const PVector& other)
+        : _root(_retain(other._root)), _shift(other._shift), _offset(other._offset),
+          _size(other._size) {}
+
+    PVector& operator=(const PVector& other) {
+        if (this != &other) {
+            Node* root = _retain(other._root);
+            _release(_root);
+
+            _root = root;
+            _shift = other._shift;
+            _offset = other._offset;
+            _size = other._size;
+        }
+
+        return *this;
+    }
+
+    PVector(PVector&& other) noexcept
+        : _root(other._root), _shift(other._shift), _offset(other._offset), _size(other._size) {
+        other._root = nullptr;
+        other._shift = 0;
+        other._offset = 0;
+        other._size = 0;
+    }
+
+    PVector& operator=(PVector&& other) noexcept {
+        if (this != &other) {
+            _release(_root);
+
+            _root = other._root;
+            _shift = other._shift;
+            _offset = other._offset;
+            _size = other._size;
+
+            other._root = nullptr;
+            other._shift = 0;
+            other._offset = 0;
+            other._size = 0;
+        }
+
+        return *this;
+    }
+
+    PVector(InitializerList<Element> il) : _root(nullptr), _shift(0), _offset(0), _size(0) {
+        for (const auto& e : il) {
+            _push_back(e);
+        }
+    }
+
+    ~PVector() {
+        _release(_root);
+    }
+
+    const Element& operator[](size_t index) const {
+        const size_t idx = _offset + index;
+        const Node* node = _root;
+
+        for (size_t shift = _shift; shift > 0; shift -= _bits) {
+            node = node->children[(idx >> shift) & _mask];
+        }
+
+        return node->elems[idx & _mask];
+    }
+
+    bool operator==(const PVector& other) const {
+        if (_size != other._size) {
+            return false;
+        }
+
+        for (size_t i = 0; i < _size; ++i) {
+            if ((*this)[i] != other[i]) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool operator!=(const PVector& other) const {
+        return !(*this == other);
+    }
+
+    size_t size() const {
+        return _size;
+    }
+
+    bool empty() const {
+        return _size == 0;
+    }
+
+    // ! Partial function. Make sure non-empty
+    const Element& back() const {
+        return (*this)[_size - 1];
+    }
+
+    // set :: Int -> A -> PVector A
+    PVector set(size_t index, const Element& value) const {
+        if (index >= _size) {
+            throw RuntimeError("PVector::set: index must be less than size");
+        }
+
+        PVector res = *this;
+        res._assoc(res._offset + index, value);
+        return res;
+    }
+
+    // push_back :: A -> PVector A
+    PVector push_back(const Element& value) const {
+        PVector res = *this;
+        res._push_back(value);
+        return res;
+    }
+
+    // pop_back :: PVector A
+    PVector pop_back() const {
+        if (_size == 0) {
+            throw RuntimeError("PVector::pop_back: size must be greater than 0");
+        }
+
+        PVector res = *this;
+        --res._size;
+        return res;
+    }
+
+    // slice :: Int -> Int -> PVector A
+    // Shares the whole trie. The elements out of the slice are kept alive until all versions die.
+    PVector slice(size_t start, size_t end) const {
+        if (start > end || end > _size) {
+            throw RuntimeError("PVector::slice: start <= end <= size must hold");
+        }
+
+        PVector res = *this;
+        res._offset += start;
+        res._size = end - start;
+        return res;
+    }
+
+    // concat :: PVector A -> PVector A
+    // O(m log32 n) with m the length of the other. Appended path is exclusive after the first copy.
+    PVector concat(const PVector& other) const {
+        PVector res = *this;
+
+        for (size_t i = 0; i < other._size; ++i) {
+            res._push_back(other[i]);
+        }
+
+        return res;
+    }
+
+    Transient transient() const {
+        return Transient(*this);
+    }
+
+    // Transient
+    // Mutable handle for batch updates. Nodes exclusively owned by the transient are updated in
+    // place, so only the first write on a path copies it.
+    class Transient {
+    public:
+        explicit Transient(const PVector& pv) : _pv(pv) {}
+
+        const Element& operator[](size_t index) const {
+            return _pv[index];
+        }
+
+        size_t size() const {
+            return _pv.size();
+        }
+
+        bool empty() const {
+            return _pv.empty();
+        }
+
+        Transient& set(size_t index, const Element& value) {
+            if (index >= _pv._size) {
+                throw RuntimeError("PVector::Transient::set: index must be less than size");
+            }
+
+            _pv._assoc(_pv._offset + index, value);
+            return *this;
+        }
+
+        Transient& push_back(const Element& value) {
+            _pv._push_back(value);
+            return *this;
+        }
+
+        Transient& pop_back() {
+            if (_pv._size == 0) {
+                throw RuntimeError("PVector::Transient::pop_back: size must be greater than 0");
+            }
+
+            --_pv._size;
+            return *this;
+        }
+
+        PVector persistent() const {
+            return _pv;
+        }
+
+    private:
+        PVector _pv;
+    };
+
+private:
+    static constexpr size_t _bits = 5;
+    static constexpr size_t _width = 1 << _bits;
+    static constexpr size_t _mask = _width - 1;
+
+    struct Node {
+        std::atomic<size_t> ref_count;
+        bool is_leaf;
+        size_t len;  // Number of constructed elements of the leaf
+
+        union {
+            Node* children[_width];
+            RawStorage<Element, _width> elems;
+        };
+
+        explicit Node(bool leaf) : ref_count(1), is_leaf(leaf), len(0) {
+            if (!leaf) {
+                for (size_t i = 0; i < _width; ++i) {
+                    children[i] = nullptr;
+                }
+            }
+        }
+
+        ~Node() {}
+    };
+
+    static Node* _retain(Node* node) {
+        if (node) {
+            node->ref_count.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        return node;
+    }
+
+    static void _release(Node* node) {
+        if (node == nullptr || node->ref_count.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+            return;
+        }
+
+        if (node->is_leaf) {
+            for (size_t i = 0; i < node->len; ++i) {
+                (node->elems + i)->~Element();
+            }
+        } else {
+            for (size_t i = 0; i < _width; ++i) {
+                _release(node->children[i]);
+            }
+        }
+
+        delete node;
+    }
+
+    static Node* _copy(const Node* node) {
+        Node* res = new Node(node->is_leaf);
+
+        if (node->is_leaf) {
+            for (size_t i = 0; i < node->len; ++i) {
+                new (res->elems + i) Element(node->elems[i]);
+            }
+            res->len = node->len;
+        } else {
+            for (size_t i = 0; i < _width; ++i) {
+                res->children[i] = _retain(node->children[i]);
+            }
+        }
+
+        return res;
+    }
+
+    // Returns the node to replace the given one. Shared nodes are copied, exclusive ones are updated in place
+    static Node* _assoc_node(Node* node, size_t shift, size_t idx, const Element& value) {
+        Node* res = node == nullptr
+            ? new Node(shift == 0)
+            : (node->ref_count.load(std::memory_order_acquire) > 1 ? _copy(node) : node);
+
+        if (res->is_leaf) {
+            const size_t i = idx & _mask;
+
+            if (i < res->len) {
+                res->elems[i] = value;
+            } else {
+                new (res->elems + i) Element(value);
+                ++res->len;
+            }
+        } else {
+            const size_t i = (idx >> shift) & _mask;
+            Node* child = res->children[i];
+            Node* new_child = _assoc_node(child, shift - _bits, idx, value);
+
+            if (new_child != child) {
+                _release(child);
+                res->children[i] = new_child;
+            }
+        }
+
+        return res;
+    }
+
+    void _assoc(size_t idx, const Element& value) {
+        // Grow the trie if the index is out of the current depth
+        while (_shift < sizeof(size_t) * 8 - _bits && (idx >> (_shift + _bits)) != 0) {
+            Node* root = new Node(false);
+            root->children[0] = _root;
+            _root = root;
+            _shift += _bits;
+        }
+
+        Node* root = _assoc_node(_root, _shift, idx, value);
+
+        if (root != _root) {
+            _release(_root);
+            _root = root;
+        }
+    }
+
+    void _push_back(const Element& value) {
+        _assoc(_offset + _size, value);
+        ++_size;
+    }
+
+    Node* _root;
+    size_t _shift;
+    size_t _offset;
+    size_t _size;
+};
+
+template<typename A>
+struct ElementImpl<PVector<A>> {
+    using Type = A;
+};
+
+template<typename A>
+struct CtSizeImpl<PVector<A>> {
+    using Type = Size<dyn>;
+};
+
+template<typename A>
+struct CtCapacityImpl<PVector<A>> {
+    using Type = Size<dyn>;
+};
+
+template<typename A>
+constexpr auto length(const PVector<A>& as) -> size_t {
+    return as.size();
+}
+
+template<typename A>
+constexpr auto nth(size_t i, const PVector<A>& as) -> const A& {
+    return as[i];
+}
+
+template<typename A>
+constexpr auto nth(size_t i, PVector<A>& as) -> const A& {
+    return as[i];
+}
+
+}  // namespace efp
+
+#endif
@@ -0,0 +1,309 @@
+#ifndef EFP_POOL_HPP_
+#define EFP_POOL_HPP_
+
+// ! Not for freestanding environments
+#if defined(__STDC_HOSTED__) && __STDC_HOSTED__ == 1
+
+    #include <mutex>
+
+    #include "efp/cpp_core.hpp"
+    #include "efp/allocator.hpp"
+
+namespace efp {
+
+// BlockPool
+// Fixed-size block pool. Blocks are carved out of chunks of blocks_per_chunk blocks and recycled
+// through intrusive free lists, so the global heap is hit once per chunk.
+// - deallocate pushes to the global return list without lock from any thread.
+// - allocate takes a lock only to refill from the return list or to add a chunk.
+// - With thread_cache, each thread keeps its own free list and touches the shared state only once
+//   per batch. Thread indices are not reused, and blocks cached by an exited thread are reclaimed
+//   only on destruction of the pool.
+// All the chunks are freed on destruction of the pool. Every block must be returned before that.
+template<size_t blocks_per_chunk = 256>
+class BlockPool {
+public:
+    static_assert(blocks_per_chunk > 0, "blocks_per_chunk must be greater than 0");
+
+    // Number of threads which could have their own cache. Threads beyond it use the shared path.
+    static constexpr size_t max_thread_caches = 64;
+
+    // Blocks kept in a thread cache before returning to the global list
+    static constexpr size_t thread_cache_size = blocks_per_chunk < 64 ? blocks_per_chunk : 64;
+
+    explicit BlockPool(
+        size_t block_size,
+        size_t block_align = alignof(std::max_align_t),
+        bool thread_cache = false
+    )
+        : _block_align(block_align < alignof(Block) ? alignof(Block) : block_align),
+          _block_size(
+              _round_up(block_size < sizeof(Block) ? sizeof(Block) : block_size, _block_align)
+          ),
+          _thread_cache(thread_cache), _chunks(nullptr), _chunk_count(0), _free(nullptr),
+          _returned(nullptr) {
+        if ((block_align & (block_align - 1)) != 0) {
+            throw RuntimeError("BlockPool::BlockPool: alignment must be a power of two");
+        }
+
+        for (size_t i = 0; i < max_thread_caches; ++i) {
+            _caches[i].head = nullptr;
+            _caches[i].count = 0;
+        }
+    }
+
+    BlockPool(const BlockPool&) = delete;
+
+    BlockPool& operator=(const BlockPool&) = delete;
+
+    ~BlockPool() {
+        while (_chunks) {
+            Chunk* next = _chunks->next;
+            ::operator delete(_chunks->raw);
+            _chunks = next;
+        }
+    }
+
+    void* allocate() {
+        ThreadCache* cache = _local_cache();
+
+        if (cache) {
+            if (cache->head == nullptr) {
+                _refill(*cache);
+            }
+
+            Block* block = cache->head;
+            cache->head = block->next;
+            --cache->count;
+            return block;
+        }
+
+        std::lock_guard<std::mutex> lock(_m);
+        if (_free == nullptr) {
+            _replenish();
+        }
+
+        Block* block = _free;
+        _free = block->next;
+        return block;
+    }
+
+    void deallocate(void* p) noexcept {
+        Block* block = static_cast<Block*>(p);
+        ThreadCache* cache = _local_cache();
+
+        if (cache && cache->count < thread_cache_size) {
+            block->next = cache->head;
+            cache->head = block;
+            ++cache->count;
+            return;
+        }
+
+        // Lock-free push. Poping is done only by exchanging the whole list, so there is no ABA.
+        Block* head = _returned.load(std::memory_order_relaxed);
+        do {
+            block->next = head;
+        } while (!_returned.compare_exchange_weak(
+            head,
+            block,
+            std::memory_order_release,
+            std::memory_order_relaxed
+        ));
+    }
+
+    size_t block_size() const {
+        return _block_size;
+    }
+
+    size_t block_align() const {
+        return _block_align;
+    }
+
+    size_t chunk_count() const {
+        std::lock_guard<std::mutex> lock(_m);
+        return _chunk_count;
+    }
+
+    // Total number of blocks owned by the pool, whether in use or not
+    size_t capacity() const {
+        return chunk_count() * blocks_per_chunk;
+    }
+
+private:
+    struct Block {
+        Block* next;
+    };
+
+    struct Chunk {
+        Chunk* next;
+        void* raw;
+    };
+
+    // Padded to a cache line, so that caches of different threads do not share the line
+    struct ThreadCache {
+        Block* head;
+        size_t count;
+        char _padding[cache_line_size - sizeof(Block*) - sizeof(size_t)];
+    };
+
+    static size_t _round_up(size_t n, size_t align) {
+        return (n + align - 1) & ~(align - 1);
+    }
+
+    static size_t _thread_index() {
+        static std::atomic<size_t> next_index {0};
+        thread_local size_t index = next_index.fetch_add(1, std::memory_order_relaxed);
+        return index;
+    }
+
+    ThreadCache* _local_cache() {
+        if (!_thread_cache) {
+            return nullptr;
+        }
+
+        const size_t index = _thread_index();
+        return index < max_thread_caches ? &_caches[index] : nullptr;
+    }
+
+    // Move a batch of blocks to the thread cache
+    void _refill(ThreadCache& cache) {
+        std::lock_guard<std::mutex> lock(_m);
+
+        for (size_t i = 0; i < thread_cache_size; ++i) {
+            if (_free == nullptr) {
+                if (i > 0) {
+                    break;
+                }
+                _replenish();
+            }
+
+            Block* block = _free;
+            _free = block->next;
+
+            block->next = cache.head;
+            cache.head = block;
+            ++cache.count;
+        }
+    }
+
+    // Fill the shared free list from the return list or from a new chunk. Must hold the lock.
+    void _replenish() {
+        _free = _returned.exchange(nullptr, std::memory_order_acquire);
+        if (_free) {
+            return;
+        }
+
+        // Chunk header followed by the aligned blocks
+        const size_t header = _round_up(sizeof(Chunk), _block_align);
+        void* raw = ::operator new(header + _block_size * blocks_per_chunk + _block_align);
+        char* base = reinterpret_cast<char*>(
+            _round_up(reinterpret_cast<uintptr_t>(raw), _block_align)
+        );
+
+        Chunk* chunk = reinterpret_cast<Chunk*>(base);
+        chunk->next = _chunks;
+        chunk->raw = raw;
+        _chunks = chunk;
+        ++_chunk_count;
+
+        char* blocks = base + header;
+        for (size_t i = blocks_per_chunk; i-- > 0;) {
+            Block* block = reinterpret_cast<Block*>(blocks + i * _block_size);
+            block->next = _free;
+            _free = block;
+        }
+    }
+
+    const size_t _block_align;
+    const size_t _block_size;
+    const bool _thread_cache;
+
+    mutable std::mutex _m;
+    Chunk* _chunks;
+    size_t _chunk_count;
+    Block* _free;
+    std::atomic<Block*> _returned;
+    ThreadCache _caches[max_thread_caches];
+};
+
+// PoolAllocator
+// Stateful allocator serving single element allocations from a BlockPool.
+// Requests not fitting in a block (arrays, or larger types after rebind) fall back to the global
+// heap, so it could be used with any container. Node based containers and std::allocate_shared
+// get the full benefit.
+template<typename A, size_t blocks_per_chunk = 256>
+class PoolAllocator {
+public:
+    using value_type = A;
+    using pointer = A*;
+    using const_pointer = const A*;
+    using reference = A&;
+    using const_reference = const A&;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+
+    template<typename B>
+    struct rebind {
+        using other = PoolAllocator<B, blocks_per_chunk>;
+    };
+
+    PoolAllocator(BlockPool<blocks_per_chunk>& pool) noexcept : _pool(&pool) {}
+
+    template<typename B>
+    PoolAllocator(const PoolAllocator<B, blocks_per_chunk>& other) noexcept
+        : _pool(other.pool()) {}
+
+    pointer allocate(size_type n) {
+        return static_cast<pointer>(
+            _fits(n) ? _pool->allocate() : ::operator new(n * sizeof(A))
+        );
+    }
+
+    void deallocate(pointer p, size_type n) {
+        if (_fits(n)) {
+            _pool->deallocate(p);
+        } else {
+            ::operator delete(p);
+        }
+    }
+
+    size_type max_size() const noexcept {
+        return size_type(-1) / sizeof(A);
+    }
+
+    template<typename... Args>
+    void construct(pointer p, Args&&... args) {
+        new (p) A(efp::forward<Args>(args)...);
+    }
+
+    void destroy(pointer p) {
+        p->~A();
+    }
+
+    BlockPool<blocks_per_chunk>* pool() const noexcept {
+        return _pool;
+    }
+
+private:
+    bool _fits(size_type n) const {
+        return n == 1 && sizeof(A) <= _pool->block_size() && alignof(A) <= _pool->block_align();
+    }
+
+    BlockPool<blocks_per_chunk>* _pool;
+};
+
+template<typename A, typename B, size_t n>
+bool operator==(const PoolAllocator<A, n>& lhs, const PoolAllocator<B, n>& rhs) {
+    return lhs.pool() == rhs.pool();
+}
+
+template<typename A, typename B, size_t n>
+bool operator!=(const PoolAllocator<A, n>& lhs, const PoolAllocator<B, n>& rhs) {
+    return lhs.pool() != rhs.pool();
+}
+
+}  // namespace efp
+
+#endif  // __STDC_HOSTED__ && __STDC_HOSTED__ == 1
+
+#endif
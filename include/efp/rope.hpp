@@ -0,0 +1,500 @@
+#ifndef EFP_ROPE_HPP_
+#define EFP_ROPE_HPP_
+
+#include "efp/cpp_core.hpp"
+#include "efp/sequence.hpp"
+#include "efp/string.hpp"
+#include "efp/io.hpp"
+
+namespace efp {
+
+// Rope
+// Text as an implicit treap of leaves holding up to leaf_capacity characters, ordered by
+// position and balanced by random priorities. insert, erase and concatenation split and merge
+// the tree in expected O(log n), and a short insert into a leaf with room is done in place.
+// Reading out walks the leaves in order, so writing to a File does not flatten the text.
+//
+//     Rope text {"hello world"};
+//     text.insert(5, ",");
+//     text.erase(0, 1);
+//     text.to_string();  // "ello, world"
+class Rope {
+public:
+    using Element = char;
+
+    static constexpr size_t leaf_capacity = 512;
+
+    Rope() : _root(nullptr), _seed(_new_seed()) {}
+
+    Rope(const char* c_str) : _root(nullptr), _seed(_new_seed()) {
+        append(c_str);
+    }
+
+    Rope(const StringView& s) : _root(nullptr), _seed(_new_seed()) {
+        append(s);
+    }
+
+    // The seed stays with the Rope, copies and moves take only the nodes
+    Rope(const Rope& other) : _root(_clone(other._root)), _seed(_new_seed()) {}
+
+    Rope& operator=(const Rope& other) {
+        if (this != &other) {
+            Node* root = _clone(other._root);
+            _free(_root);
+            _root = root;
+        }
+        return *this;
+    }
+
+    Rope(Rope&& other) noexcept : _root(other._root), _seed(_new_seed()) {
+        other._root = nullptr;
+    }
+
+    Rope& operator=(Rope&& other) noexcept {
+        if (this != &other) {
+            _free(_root);
+            _root = other._root;
+            other._root = nullptr;
+        }
+        return *this;
+    }
+
+    ~Rope() {
+        _free(_root);
+    }
+
+    size_t size() const {
+        return _weight(_root);
+    }
+
+    bool empty() const {
+        return _root == nullptr;
+    }
+
+    // Levels of the tree, expected O(log n) in the number of leaves
+    size_t depth() const {
+        return _depth(_root);
+    }
+
+    char operator[](size_t index) const {
+        const Node* node = _root;
+
+        while (true) {
+            const size_t left = _weight(node->left);
+
+            if (index < left) {
+                node = node->left;
+            } else if (index < left + node->length) {
+                return node->text[index - left];
+            } else {
+                index -= left + node->length;
+                node = node->right;
+            }
+        }
+    }
+
+    char at(size_t index) const {
+        if (index >= size()) {
+            throw RuntimeError("Rope::at: index out of range");
+        }
+        return (*this)[index];
+    }
+
+    Rope& insert(size_t pos, const char* s, size_t n) {
+        if (pos > size()) {
+            throw RuntimeError("Rope::insert: position out of range");
+        }
+
+        if (n == 0 || _insert_in_leaf(_root, pos, s, n)) {
+            return *this;
+        }
+
+        Node* left;
+        Node* right;
+        _split(_root, pos, left, right);
+        _root = _join(_join(left, _build(s, n)), right);
+
+        return *this;
+    }
+
+    Rope& insert(size_t pos, const StringView& s) {
+        return insert(pos, s.data(), s.size());
+    }
+
+    Rope& insert(size_t pos, const char* c_str) {
+        return insert(pos, c_str, String::traits_type::length(c_str));
+    }
+
+    Rope& append(const char* s, size_t n) {
+        return insert(size(), s, n);
+    }
+
+    Rope& append(const StringView& s) {
+        return insert(size(), s.data(), s.size());
+    }
+
+    Rope& append(const char* c_str) {
+        return append(c_str, String::traits_type::length(c_str));
+    }
+
+    // Concatenation taking over the nodes of other
+    Rope& append(Rope&& other) {
+        if (this != &other) {
+            _root = _join(_root, other._root);
+            other._root = nullptr;
+        }
+        return *this;
+    }
+
+    // Erases up to len characters from pos
+    Rope& erase(size_t pos, size_t len) {
+        const size_t n = size();
+        if (pos > n) {
+            throw RuntimeError("Rope::erase: position out of range");
+        }
+
+        if (len > n - pos) {
+            len = n - pos;
+        }
+
+        if (len == 0) {
+            return *this;
+        }
+
+        Node* left;
+        Node* rest;
+        Node* middle;
+        Node* right;
+        _split(_root, pos, left, rest);
+        _split(rest, len, middle, right);
+        _free(middle);
+        _root = _join(left, right);
+
+        return *this;
+    }
+
+    // Calls f(const char* data, size_t length) on each leaf in order
+    template<typename F>
+    void for_each_chunk(const F& f) const {
+        _for_each(_root, f);
+    }
+
+    String substr(size_t pos, size_t len) const {
+        const size_t n = size();
+        if (pos > n) {
+            throw RuntimeError("Rope::substr: position out of range");
+        }
+
+        if (len > n - pos) {
+            len = n - pos;
+        }
+
+        String result {};
+        result.resize(len);
+        _copy(_root, pos, len, result.data());
+        return result;
+    }
+
+    String to_string() const {
+        return substr(0, size());
+    }
+
+    bool operator==(const StringView& s) const {
+        if (size() != s.size()) {
+            return false;
+        }
+
+        size_t offset = 0;
+        bool equal = true;
+        for_each_chunk([&](const char* data, size_t length) {
+            equal = equal && std::memcmp(data, s.data() + offset, length) == 0;
+            offset += length;
+        });
+        return equal;
+    }
+
+#if defined(__STDC_HOSTED__) && __STDC_HOSTED__ == 1
+    bool write_to(File& file) const {
+        bool ok = true;
+        for_each_chunk([&](const char* data, size_t length) {
+            ok = ok && file.write(data, length);
+        });
+        return ok;
+    }
+#endif
+
+private:
+    struct Node {
+        Node* left;
+        Node* right;
+        uint32_t priority;
+        size_t weight;
+        size_t length;
+        char text[leaf_capacity];
+    };
+
+    static constexpr uint32_t default_seed = 0x9e3779b9u;
+
+    // Each Rope draws priorities from its own seed. With a shared first priority, ties in
+    // concatenation would all go left and leave a chain of the leaves
+    static uint32_t _new_seed() {
+        static std::atomic<uint32_t> counter {0};
+        uint32_t x = counter.fetch_add(1, std::memory_order_relaxed) * default_seed + default_seed;
+
+        // Finalizer of MurmurHash3, a bijection, so only zero maps to zero
+        x ^= x >> 16;
+        x *= 0x85ebca6bu;
+        x ^= x >> 13;
+        x *= 0xc2b2ae35u;
+        x ^= x >> 16;
+        return x != 0 ? x : default_seed;
+    }
+
+    static size_t _weight(const Node* node) {
+        return node ? node->weight : 0;
+    }
+
+    static void _update(Node* node) {
+        node->weight = _weight(node->left) + node->length + _weight(node->right);
+    }
+
+    // xorshift32
+    uint32_t _next_priority() {
+        _seed ^= _seed << 13;
+        _seed ^= _seed >> 17;
+        _seed ^= _seed << 5;
+        return _seed;
+    }
+
+    Node* _new_node(const char* s, size_t n, uint32_t priority) {
+        Node* node = new Node;
+        node->left = nullptr;
+        node->right = nullptr;
+        node->priority = priority;
+        node->length = n;
+        _memcpy(node->text, s, n);
+        _update(node);
+        return node;
+    }
+
+    // Balanced treap of the text in full leaves
+    Node* _build(const char* s, size_t n) {
+        Node* root = nullptr;
+        for (size_t i = 0; i < n; i += leaf_capacity) {
+            const size_t length = n - i < leaf_capacity ? n - i : leaf_capacity;
+            root = _merge(root, _new_node(s + i, length, _next_priority()));
+        }
+        return root;
+    }
+
+    // Splits into the first pos characters and the rest. A leaf crossing pos is cut in two
+    void _split(Node* node, size_t pos, Node*& left, Node*& right) {
+        Node* tail = nullptr;
+        _split(node, pos, left, right, tail);
+        right = _merge(tail, right);
+    }
+
+    // The tail of a leaf crossing pos is a new node with a priority of its own, merged in by
+    // the caller. Reusing the priority of the leaf would pile up equal priorities, which merge
+    // into a chain
+    void _split(Node* node, size_t pos, Node*& left, Node*& right, Node*& tail) {
+        if (node == nullptr) {
+            left = nullptr;
+            right = nullptr;
+            return;
+        }
+
+        const size_t left_weight = _weight(node->left);
+
+        if (pos <= left_weight) {
+            _split(node->left, pos, left, node->left, tail);
+            right = node;
+        } else if (pos >= left_weight + node->length) {
+            _split(node->right, pos - left_weight - node->length, node->right, right, tail);
+            left = node;
+        } else {
+            const size_t cut = pos - left_weight;
+            tail = _new_node(node->text + cut, node->length - cut, _next_priority());
+
+            node->length = cut;
+            right = node->right;
+            node->right = nullptr;
+            left = node;
+        }
+
+        _update(node);
+    }
+
+    static Node* _merge(Node* left, Node* right) {
+        if (left == nullptr) {
+            return right;
+        }
+
+        if (right == nullptr) {
+            return left;
+        }
+
+        if (left->priority >= right->priority) {
+            left->right = _merge(left->right, right);
+            _update(left);
+            return left;
+        }
+
+        right->left = _merge(left, right->left);
+        _update(right);
+        return right;
+    }
+
+    // Merges, first joining the last leaf of left and the first of right if they fit in one,
+    // so that cutting and erasing do not leave a trail of small leaves
+    static Node* _join(Node* left, Node* right) {
+        if (left != nullptr && right != nullptr) {
+            const Node* first = right;
+            while (first->left != nullptr) {
+                first = first->left;
+            }
+
+            if (_last_length(left) + first->length <= leaf_capacity) {
+                _append_to_last(left, first->text, first->length);
+                right = _erase_first(right);
+            }
+        }
+
+        return _merge(left, right);
+    }
+
+    static size_t _last_length(const Node* node) {
+        while (node->right != nullptr) {
+            node = node->right;
+        }
+        return node->length;
+    }
+
+    static void _append_to_last(Node* node, const char* s, size_t n) {
+        if (node->right != nullptr) {
+            _append_to_last(node->right, s, n);
+        } else {
+            _memcpy(node->text + node->length, s, n);
+            node->length += n;
+        }
+        node->weight += n;
+    }
+
+    // Frees the first leaf, returning the tree without it
+    static Node* _erase_first(Node* node) {
+        if (node->left == nullptr) {
+            Node* right = node->right;
+            delete node;
+            return right;
+        }
+
+        node->left = _erase_first(node->left);
+        _update(node);
+        return node;
+    }
+
+    // Inserts into the leaf at pos if it has room, updating the weights on the way back
+    static bool _insert_in_leaf(Node* node, size_t pos, const char* s, size_t n) {
+        if (node == nullptr) {
+            return false;
+        }
+
+        const size_t left_weight = _weight(node->left);
+        bool inserted;
+
+        if (pos < left_weight) {
+            inserted = _insert_in_leaf(node->left, pos, s, n);
+        } else if (pos <= left_weight + node->length) {
+            if (node->length + n > leaf_capacity) {
+                return false;
+            }
+
+            const size_t offset = pos - left_weight;
+            std::memmove(node->text + offset + n, node->text + offset, node->length - offset);
+            _memcpy(node->text + offset, s, n);
+            node->length += n;
+            inserted = true;
+        } else {
+            inserted = _insert_in_leaf(node->right, pos - left_weight - node->length, s, n);
+        }
+
+        if (inserted) {
+            node->weight += n;
+        }
+        return inserted;
+    }
+
+    static void _copy(const Node* node, size_t pos, size_t len, char* out) {
+        if (node == nullptr || len == 0) {
+            return;
+        }
+
+        const size_t left_weight = _weight(node->left);
+
+        if (pos < left_weight) {
+            const size_t from_left = left_weight - pos < len ? left_weight - pos : len;
+            _copy(node->left, pos, from_left, out);
+            out += from_left;
+            len -= from_left;
+            pos = left_weight;
+        }
+
+        if (len != 0 && pos < left_weight + node->length) {
+            const size_t offset = pos - left_weight;
+            const size_t from_node = node->length - offset < len ? node->length - offset : len;
+            _memcpy(out, node->text + offset, from_node);
+            out += from_node;
+            len -= from_node;
+            pos += from_node;
+        }
+
+        if (len != 0) {
+            _copy(node->right, pos - left_weight - node->length, len, out);
+        }
+    }
+
+    template<typename F>
+    static void _for_each(const Node* node, const F& f) {
+        if (node != nullptr) {
+            _for_each(node->left, f);
+            f(static_cast<const char*>(node->text), node->length);
+            _for_each(node->right, f);
+        }
+    }
+
+    static size_t _depth(const Node* node) {
+        if (node == nullptr) {
+            return 0;
+        }
+
+        const size_t left = _depth(node->left);
+        const size_t right = _depth(node->right);
+        return 1 + (left > right ? left : right);
+    }
+
+    static Node* _clone(const Node* node) {
+        if (node == nullptr) {
+            return nullptr;
+        }
+
+        Node* result = new Node(*node);
+        result->left = _clone(node->left);
+        result->right = _clone(node->right);
+        return result;
+    }
+
+    static void _free(Node* node) {
+        if (node != nullptr) {
+            _free(node->left);
+            _free(node->right);
+            delete node;
+        }
+    }
+
+    Node* _root;
+    uint32_t _seed;
+};
+
+}  // namespace efp
+
+#endif
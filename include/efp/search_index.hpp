@@ -0,0 +1,213 @@
+#ifndef EFP_SEARCH_INDEX_HPP_
+#define EFP_SEARCH_INDEX_HPP_
+
+#include "efp/cpp_core.hpp"
+#include "efp/meta.hpp"
+#include "efp/trait.hpp"
+#include "efp/allocator.hpp"
+#include "efp/sequence.hpp"
+
+namespace efp {
+
+namespace detail {
+    constexpr size_t search_cache_line = 64;
+
+    // Number of trailing zero bits. Undefined for 0
+    inline size_t search_ctz(size_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<size_t>(__builtin_ctzll(static_cast<unsigned long long>(x)));
+#else
+        size_t i = 0;
+        while (!(x & 1)) {
+            x >>= 1;
+            ++i;
+        }
+        return i;
+#endif
+    }
+
+    // Prefetching past the end is harmless, but forming such a pointer is not, hence the integer
+    inline void search_prefetch(const void* base, size_t offset) {
+#if defined(__GNUC__) || defined(__clang__)
+        const uintptr_t address = reinterpret_cast<uintptr_t>(base) + offset;
+        __builtin_prefetch(reinterpret_cast<const void*>(address));
+#else
+        (void)base;
+        (void)offset;
+#endif
+    }
+}  // namespace detail
+
+// SearchIndex
+// Read only index of a sorted sequence in Eytzinger layout, which is the breadth first order of
+// the implicit binary search tree. The first levels of every search share the same few cache
+// lines, and the descendants of a node some levels below are contiguous, so they are prefetched
+// one cache line at a time while the comparisons run.
+// The descent is branchless and has the same number of steps for any key. lower_bound_many
+// interleaves the descents of a batch of keys, so that their cache misses overlap.
+//
+//     const SearchIndex<uint64_t> index {sorted};
+//     index.lower_bound(x);  // Same as the lower bound over sorted
+template<typename A>
+class SearchIndex {
+public:
+    using Element = A;
+
+    // Number of queries descending together in lower_bound_many
+    static constexpr size_t batch_size = 16;
+
+    SearchIndex() : _tree(), _rank(), _size(0), _levels(0) {}
+
+    // The sequence must be sorted in ascending order
+    template<typename As>
+    explicit SearchIndex(const As& sorted) : _tree(), _rank(), _size(length(sorted)), _levels(0) {
+        for (size_t i = 1; i < _size; ++i) {
+            if (nth(i, sorted) < nth(i - 1, sorted)) {
+                throw RuntimeError("SearchIndex::SearchIndex: sequence must be sorted");
+            }
+        }
+
+        if (_size == 0) {
+            return;
+        }
+
+        // Levels of the complete part of the tree
+        while ((size_t(2) << _levels) - 1 <= _size) {
+            ++_levels;
+        }
+
+        // Pad up to the last level, so that the last step could read without a bound check
+        const size_t padded = size_t(2) << _levels;
+
+        _rank.resize(padded);
+        _rank[0] = _size;
+        _fill_rank(0, 1);
+
+        _tree.reserve(padded);
+        _tree.push_back(nth(0, sorted));
+        for (size_t k = 1; k < padded; ++k) {
+            _tree.push_back(nth(k <= _size ? _rank[k] : _size - 1, sorted));
+        }
+    }
+
+    size_t size() const {
+        return _size;
+    }
+
+    bool empty() const {
+        return _size == 0;
+    }
+
+    // Index of the first element not less than the key in the sorted sequence. size() if none
+    size_t lower_bound(const A& key) const {
+        return _size == 0 ? 0 : _rank[_descend(key)];
+    }
+
+    bool contains(const A& key) const {
+        if (_size == 0) {
+            return false;
+        }
+
+        const size_t k = _descend(key);
+        return k != 0 && !(key < _tree[k]);
+    }
+
+    // lower_bound_many
+    // Lower bounds of n keys into out
+    void lower_bound_many(const A* keys, size_t n, size_t* out) const {
+        if (_size == 0) {
+            for (size_t i = 0; i < n; ++i) {
+                out[i] = 0;
+            }
+            return;
+        }
+
+        const A* tree = _tree.data();
+
+        for (size_t begin = 0; begin < n; begin += batch_size) {
+            const size_t m = n - begin < batch_size ? n - begin : batch_size;
+            const A* batch_keys = keys + begin;
+
+            size_t ks[batch_size];
+            for (size_t j = 0; j < m; ++j) {
+                ks[j] = 1;
+            }
+
+            for (size_t level = 0; level < _levels; ++level) {
+                for (size_t j = 0; j < m; ++j) {
+                    detail::search_prefetch(tree, ks[j] * prefetch_stride);
+                    ks[j] = 2 * ks[j] + (tree[ks[j]] < batch_keys[j]);
+                }
+            }
+
+            for (size_t j = 0; j < m; ++j) {
+                out[begin + j] = _rank[_decode(_last_step(tree, ks[j], batch_keys[j]))];
+            }
+        }
+    }
+
+    template<typename As>
+    Vector<size_t> lower_bound_many(const As& keys) const {
+        const size_t n = length(keys);
+
+        Vector<size_t> out {};
+        out.resize(n);
+        lower_bound_many(data(keys), n, out.data());
+        return out;
+    }
+
+private:
+    // Byte offset per node index of the cache line holding the descendants some levels below
+    static constexpr size_t prefetch_stride =
+        sizeof(A) >= detail::search_cache_line ? sizeof(A)
+                                               : detail::search_cache_line / sizeof(A) * sizeof(A);
+
+    // Tree position of the lower bound, 0 if none
+    size_t _descend(const A& key) const {
+        const A* tree = _tree.data();
+        size_t k = 1;
+
+        for (size_t level = 0; level < _levels; ++level) {
+            detail::search_prefetch(tree, k * prefetch_stride);
+            k = 2 * k + (tree[k] < key);
+        }
+
+        return _decode(_last_step(tree, k, key));
+    }
+
+    // In order traversal assigning the sorted ranks to the tree positions
+    size_t _fill_rank(size_t i, size_t k) {
+        if (k <= _size) {
+            i = _fill_rank(i, 2 * k);
+            _rank[k] = i++;
+            i = _fill_rank(i, 2 * k + 1);
+        }
+        return i;
+    }
+
+    // Descend into the partial last level, if the node exists
+    size_t _last_step(const A* tree, size_t k, const A& key) const {
+        const size_t next = 2 * k + (tree[k] < key);
+        return k <= _size ? next : k;
+    }
+
+    // The last node where the search went left is the lower bound. 0 if none, ranked as size
+    static size_t _decode(size_t k) {
+        return k >> (detail::search_ctz(~k) + 1);
+    }
+
+    Vector<A, AlignedAllocator<A, detail::search_cache_line>> _tree;
+    Vector<size_t> _rank;
+    size_t _size;
+    size_t _levels;
+};
+
+template<typename A>
+constexpr size_t SearchIndex<A>::batch_size;
+
+template<typename A>
+constexpr size_t SearchIndex<A>::prefetch_stride;
+
+}  // namespace efp
+
+#endif
@@ -4,6 +4,9 @@
 #include "efp/meta.hpp"
 #include "efp/trait.hpp"
 
+#include "efp/allocator.hpp"
+#include "efp/tlsf.hpp"
+
 #if defined(__STDC_HOSTED__) && __STDC_HOSTED__ == 1
     #include <string>
     #include <memory>
@@ -11,17 +14,9 @@
     #include <array>
     #include <vector>
 
-namespace efp {
-// Use std::allocator_traits if available
-template<typename A>
-using AllocatorTraits = std::allocator_traits<A>;
-
-}  // namespace efp
-
 #else
     // todo remove STL
     #include <string>
-    #include "efp/allocator.hpp"
 
 #endif
 
@@ -29,12 +24,13 @@ using AllocatorTraits = std::allocator_traits<A>;
 
 namespace efp {
 
-template<typename A, size_t ct_size>
+template<typename A, size_t ct_size, size_t ct_align = alignof(A)>
 class Array {
 public:
     using Element = A;
     using CtSize = Size<ct_size>;
     using CtCapacity = Size<ct_size>;
+    using CtAlign = Size<ct_align>;
 
     // STL compatible types
     using value_type = Element;
@@ -183,55 +179,61 @@ private:
         new (_data + index) Element {last};
     }
 
-    RawStorage<A, ct_size> _data;
+    RawStorage<A, ct_size, ct_align> _data;
 };
 
-template<typename A, size_t n>
-struct ElementImpl<Array<A, n>> {
+template<typename A, size_t n, size_t align>
+struct ElementImpl<Array<A, n, align>> {
     using Type = A;
 };
 
-template<typename A, size_t n>
-struct CtSizeImpl<Array<A, n>> {
+template<typename A, size_t n, size_t align>
+struct CtSizeImpl<Array<A, n, align>> {
     using Type = Size<n>;
 };
 
-template<typename A, size_t n>
-struct CtCapacityImpl<Array<A, n>> {
+template<typename A, size_t n, size_t align>
+struct CtCapacityImpl<Array<A, n, align>> {
     using Type = Size<n>;
 };
 
-template<typename A, size_t n>
-constexpr auto length(const Array<A, n>&) -> Size<n> {
+template<typename A, size_t n, size_t align>
+struct CtAlignImpl<Array<A, n, align>> {
+    using Type = Size<align>;
+};
+
+template<typename A, size_t n, size_t align>
+constexpr auto length(const Array<A, n, align>&) -> Size<n> {
     return Size<n> {};
 }
 
-template<typename A, size_t n>
-constexpr auto nth(size_t i, const Array<A, n>& as) -> const A& {
+template<typename A, size_t n, size_t align>
+constexpr auto nth(size_t i, const Array<A, n, align>& as) -> const A& {
     return as[i];
 }
 
-template<typename A, size_t n>
-constexpr auto nth(size_t i, Array<A, n>& as) -> A& {
+template<typename A, size_t n, size_t align>
+constexpr auto nth(size_t i, Array<A, n, align>& as) -> A& {
     return as[i];
 }
 
-template<typename A, size_t n>
-constexpr auto data(const Array<A, n>& as) -> const A* {
+template<typename A, size_t n, size_t align>
+constexpr auto data(const Array<A, n, align>& as) -> const A* {
     return as.data();
 }
 
-template<typename A, size_t n>
-constexpr auto data(Array<A, n>& as) -> A* {
+template<typename A, size_t n, size_t align>
+constexpr auto data(Array<A, n, align>& as) -> A* {
     return as.data();
 }
 
-template<typename A, size_t ct_capacity>
+template<typename A, size_t ct_capacity, size_t ct_align = alignof(A)>
 class ArrVec {
 public:
     using Element = A;
     using CtSize = Size<dyn>;
     using CtCapacity = Size<ct_capacity>;
+    using CtAlign = Size<ct_align>;
 
     // STL compatible types
     using value_type = Element;
@@ -305,9 +307,12 @@ public:
     }
 
     // Constructor from array
-    template<size_t ct_size_, typename = EnableIf<ct_capacity >= ct_size_, void>>
-    ArrVec(const ArrVec<Element, ct_size_>& as) : _size(ct_size_) {
-        for (size_t i = 0; i < ct_size_; ++i) {
+    template<
+        size_t ct_size_,
+        size_t ct_align_,
+        typename = EnableIf<ct_capacity >= ct_size_, void>>
+    ArrVec(const ArrVec<Element, ct_size_, ct_align_>& as) : _size(as.size()) {
+        for (size_t i = 0; i < _size; ++i) {
             new (_data + i) Element {as[i]};
         }
     }
@@ -473,47 +478,52 @@ private:
     }
 
     // Element _data[ct_capacity];
-    RawStorage<Element, ct_capacity> _data;
+    RawStorage<Element, ct_capacity, ct_align> _data;
     size_t _size;
 };
 
-template<typename A, size_t n>
-struct ElementImpl<ArrVec<A, n>> {
+template<typename A, size_t n, size_t align>
+struct ElementImpl<ArrVec<A, n, align>> {
     using Type = A;
 };
 
-template<typename A, size_t n>
-struct CtSizeImpl<ArrVec<A, n>> {
+template<typename A, size_t n, size_t align>
+struct CtSizeImpl<ArrVec<A, n, align>> {
     using Type = Size<dyn>;
 };
 
-template<typename A, size_t n>
-struct CtCapacityImpl<ArrVec<A, n>> {
+template<typename A, size_t n, size_t align>
+struct CtCapacityImpl<ArrVec<A, n, align>> {
     using Type = Size<n>;
 };
 
-template<typename A, size_t n>
-constexpr auto length(const ArrVec<A, n>& as) -> size_t {
+template<typename A, size_t n, size_t align>
+struct CtAlignImpl<ArrVec<A, n, align>> {
+    using Type = Size<align>;
+};
+
+template<typename A, size_t n, size_t align>
+constexpr auto length(const ArrVec<A, n, align>& as) -> size_t {
     return as.size();
 }
 
-template<typename A, size_t n>
-constexpr auto nth(size_t i, const ArrVec<A, n>& as) -> const A& {
+template<typename A, size_t n, size_t align>
+constexpr auto nth(size_t i, const ArrVec<A, n, align>& as) -> const A& {
     return as[i];
 }
 
-template<typename A, size_t n>
-constexpr auto nth(size_t i, ArrVec<A, n>& as) -> A& {
+template<typename A, size_t n, size_t align>
+constexpr auto nth(size_t i, ArrVec<A, n, align>& as) -> A& {
     return as[i];
 }
 
-template<typename A, size_t n>
-constexpr auto data(const ArrVec<A, n>& as) -> const A* {
+template<typename A, size_t n, size_t align>
+constexpr auto data(const ArrVec<A, n, align>& as) -> const A* {
     return as.data();
 }
 
-template<typename A, size_t n>
-constexpr auto data(ArrVec<A, n>& as) -> A* {
+template<typename A, size_t n, size_t align>
+constexpr auto data(ArrVec<A, n, align>& as) -> A* {
     return as.data();
 }
 
@@ -524,6 +534,12 @@ namespace detail {
     template<typename A>
     using DefaultAllocator = std::allocator<A>;
 
+#elif defined(EFP_DEFAULT_ALLOCATOR_TLSF)
+
+    // Deterministic allocation from the region given to default_tlsf()
+    template<typename A>
+    using DefaultAllocator = efp::TlsfAllocator<A>;
+
 #else
 
     // #include "efp/allocator.hpp"
@@ -556,8 +572,13 @@ namespace detail {
 
         VectorBase() : _allocator(Allocator()), _data(nullptr), _size(0), _capacity(0) {}
 
+        // Stateful allocator instance will be used for all the allocations of the vector
+        explicit VectorBase(const Allocator& alloc)
+            : _allocator(alloc), _data(nullptr), _size(0), _capacity(0) {}
+
         VectorBase(const VectorBase& other)
-            : _allocator(other._allocator), _size(other._size), _capacity(other._capacity) {
+            : _allocator(other._allocator), _data(nullptr), _size(other._size),
+              _capacity(other._capacity) {
             if (other._data) {
                 // Member function call in not allowed in member initializer list
                 // _data = _allocator.allocate(_capacity);
@@ -571,21 +592,29 @@ namespace detail {
         }
 
         // todo copy_and_swap
-        VectorBase& operator=(const VectorBase& other) noexcept {
+        // Allocator is not propagated on copy assignment. The storage stays in this allocator
+        VectorBase& operator=(const VectorBase& other) {
             if (this != &other) {
                 for (size_t i = 0; i < _size; ++i) {
                     // _allocator.destroy(_data + i);
                     AllocatorTraits<Allocator>::destroy(_allocator, _data + i);
                 }
+                _size = 0;
 
                 if (_capacity < other._size + 1) {
-                    resize(other._size);
+                    if (_data) {
+                        AllocatorTraits<Allocator>::deallocate(_allocator, _data, _capacity);
+                    }
+
+                    _capacity = other._size + 1;
+                    _data = AllocatorTraits<Allocator>::allocate(_allocator, _capacity);
                 }
 
                 for (size_t i = 0; i < other._size; ++i) {
                     // _allocator.construct(_data + i, other._data[i]);
                     AllocatorTraits<Allocator>::construct(_allocator, _data + i, other._data[i]);
                 }
+                _size = other._size;
             }
 
             return *this;
@@ -599,6 +628,7 @@ namespace detail {
             other._size = 0;
         }
 
+        // Allocator is propagated on move assignment, since the storage is taken over
         VectorBase& operator=(VectorBase&& other) noexcept {
             if (this != &other) {
                 for (size_t i = 0; i < _size; ++i) {
@@ -608,6 +638,7 @@ namespace detail {
                 // _allocator.deallocate(_data, _capacity);
                 AllocatorTraits<Allocator>::deallocate(_allocator, _data, _capacity);
 
+                _allocator = other._allocator;
                 _data = other._data;
                 _size = other._size;
                 _capacity = other._capacity;
@@ -620,8 +651,8 @@ namespace detail {
             return *this;
         }
 
-        VectorBase(InitializerList<Element> il)
-            : _allocator(Allocator()), _size(il.size()), _capacity(il.size() + 1) {
+        VectorBase(InitializerList<Element> il, const Allocator& alloc = Allocator())
+            : _allocator(alloc), _size(il.size()), _capacity(il.size() + 1) {
             // _data = _allocator.allocate(_capacity);
             _data = AllocatorTraits<Allocator>::allocate(_allocator, _capacity);
 
@@ -632,9 +663,12 @@ namespace detail {
             }
         }
 
-        template<size_t ct_size_>
-        VectorBase(const Array<Element, ct_size_>& as)
-            : _allocator(Allocator()), _size(ct_size_), _capacity(ct_size_ + 1) {
+        template<size_t ct_size_, size_t ct_align_>
+        VectorBase(
+            const Array<Element, ct_size_, ct_align_>& as,
+            const Allocator& alloc = Allocator()
+        )
+            : _allocator(alloc), _size(ct_size_), _capacity(ct_size_ + 1) {
             // _data = _allocator.allocate(_capacity);
             _data = AllocatorTraits<Allocator>::allocate(_allocator, _capacity);
 
@@ -644,9 +678,12 @@ namespace detail {
             }
         }
 
-        template<size_t ct_cap_>
-        VectorBase(const ArrVec<Element, ct_cap_>& as)
-            : _allocator(Allocator()), _size(as.size()), _capacity(as.size() + 1) {
+        template<size_t ct_cap_, size_t ct_align_>
+        VectorBase(
+            const ArrVec<Element, ct_cap_, ct_align_>& as,
+            const Allocator& alloc = Allocator()
+        )
+            : _allocator(alloc), _size(as.size()), _capacity(as.size() + 1) {
             // _data = _allocator.allocate(_capacity);
             _data = AllocatorTraits<Allocator>::allocate(_allocator, _capacity);
 
@@ -699,6 +736,10 @@ namespace detail {
             return _capacity;
         }
 
+        Allocator get_allocator() const {
+            return _allocator;
+        }
+
         size_t max_size() const {
             // return _allocator.max_size();
             return AllocatorTraits<Allocator>::max_size(_allocator);
@@ -732,8 +773,10 @@ namespace detail {
                     AllocatorTraits<Allocator>::destroy(_allocator, _data + i);
                 }
 
-                // _allocator.deallocate(_data, _capacity);
-                AllocatorTraits<Allocator>::deallocate(_allocator, _data, _capacity);
+                if (_data) {
+                    // _allocator.deallocate(_data, _capacity);
+                    AllocatorTraits<Allocator>::deallocate(_allocator, _data, _capacity);
+                }
 
                 _data = new_data;
                 _capacity = new_capacity;
@@ -743,7 +786,7 @@ namespace detail {
         void shrink_to_fit() {
             if (_size < _capacity + 1) {
                 // Allocate new storage with exactly _size capacity
-                Element* new_data = _allocator.allocate(_size + 1);
+                Element* new_data = AllocatorTraits<Allocator>::allocate(_allocator, _size + 1);
 
                 // Move existing elements to the new storage
                 for (size_t i = 0; i < _size; ++i) {
@@ -822,12 +865,23 @@ namespace detail {
                 reserve(_capacity == 0 ? 2 : 2 * _capacity);
             }
 
-            for (size_t i = _size; i > index; --i) {
-                _data[i] = efp::move(_data[i - 1]);
+            if (index == _size) {
+                AllocatorTraits<Allocator>::construct(_allocator, _data + index, value);
+            } else {
+                // The slot past the end is raw storage, hence constructed rather than assigned
+                AllocatorTraits<Allocator>::construct(
+                    _allocator,
+                    _data + _size,
+                    efp::move(_data[_size - 1])
+                );
+
+                for (size_t i = _size - 1; i > index; --i) {
+                    _data[i] = efp::move(_data[i - 1]);
+                }
+
+                _data[index] = value;
             }
 
-            // _allocator.construct(_data + index, value);
-            AllocatorTraits<Allocator>::construct(_allocator, _data + index, value);
             ++_size;
         }
 
@@ -836,13 +890,12 @@ namespace detail {
                 throw RuntimeError("VectorBase::erase: index must be less than or equal to size");
             }
 
-            // _allocator.destroy(_data + index);
-            AllocatorTraits<Allocator>::destroy(_allocator, _data + index);
-
             for (size_t i = index; i < _size - 1; ++i) {
                 _data[i] = efp::move(_data[i + 1]);
             }
 
+            // _allocator.destroy(_data + _size - 1);
+            AllocatorTraits<Allocator>::destroy(_allocator, _data + _size - 1);
             --_size;
         }
 
@@ -960,7 +1013,7 @@ template<
     typename = void>
 class Vector: public detail::VectorBase<A, Allocator> {
 public:
-    using Base = detail::VectorBase<A>;
+    using Base = detail::VectorBase<A, Allocator>;
     using Base::Base;
 
     bool operator==(const Vector& other) const {
@@ -983,6 +1036,11 @@ struct CtCapacityImpl<Vector<A, Allocator, CharTraits>> {
     using Type = Size<dyn>;
 };
 
+template<typename A, typename Allocator, typename CharTraits>
+struct CtAlignImpl<Vector<A, Allocator, CharTraits>> {
+    using Type = AllocatorAlign<Allocator>;
+};
+
 template<typename A, typename Allocator, typename CharTraits>
 constexpr auto length(const Vector<A, Allocator, CharTraits>& as) -> size_t {
     return as.size();
@@ -1438,6 +1496,8 @@ constexpr auto data(VectorView<A>& as) -> const A* {
 
 // #endif
 
+#if defined(__STDC_HOSTED__) && __STDC_HOSTED__ == 1
+
 // Sequence trait implementation for std::array
 
 template<typename A, size_t n>
@@ -1521,6 +1581,8 @@ constexpr auto data(std::vector<A>& as) -> A* {
     return as.data();
 }
 
+#endif
+
 // Sequence trait implementation for std::basic_string
 template<typename A>
 struct ElementImpl<std::basic_string<A>> {
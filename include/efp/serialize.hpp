@@ -0,0 +1,566 @@
+#ifndef EFP_SERIALIZE_HPP_
+#define EFP_SERIALIZE_HPP_
+
+#include "efp/cpp_core.hpp"
+#include "efp/meta.hpp"
+#include "efp/enum.hpp"
+#include "efp/maybe.hpp"
+#include "efp/sequence.hpp"
+#include "efp/string.hpp"
+
+namespace efp {
+
+namespace detail {
+
+    // Stream header: magic, format version and the version of the caller
+    constexpr char serial_magic[8] = {'E', 'F', 'P', 'S', 'E', 'R', '\0', '\0'};
+    constexpr uint32_t serial_format_version = 1;
+    constexpr size_t serial_header_size = 16;
+
+    #if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    constexpr bool serial_little_endian = false;
+    #else
+    constexpr bool serial_little_endian = true;
+    #endif
+
+    // Arithmetic types and enums are stored little endian. Other records keep the layout of the
+    // host
+    template<typename A>
+    using IsSerialScalar = Bool<
+        (std::is_arithmetic<A>::value || std::is_enum<A>::value) && sizeof(A) != 1
+        && !serial_little_endian>;
+
+    template<typename A>
+    inline A serial_swap(A a) {
+        char bytes[sizeof(A)];
+        _memcpy(bytes, &a, sizeof(A));
+
+        for (size_t i = 0; i < sizeof(A) / 2; ++i) {
+            const char c = bytes[i];
+            bytes[i] = bytes[sizeof(A) - 1 - i];
+            bytes[sizeof(A) - 1 - i] = c;
+        }
+
+        _memcpy(&a, bytes, sizeof(A));
+        return a;
+    }
+
+    // Bytes to a sink with write(const char*, size_t), like File and BufWriter
+    template<typename Sink>
+    inline bool serial_sink_write(Sink& sink, const char* data, size_t n) {
+        return sink.write(data, n);
+    }
+
+    template<typename Allocator, typename Traits, typename B>
+    inline bool serial_sink_write(
+        Vector<char, Allocator, Traits, B>& sink,
+        const char* data,
+        size_t n
+    ) {
+        sink.append(data, n);
+        return true;
+    }
+
+    // Base of the encodings which are the bytes of the value, hence read and written in bulk
+    struct SerialBlock {};
+}  // namespace detail
+
+template<typename Sink>
+class SerialWriter;
+
+class SerialReader;
+
+// Serial
+// Binary encoding of A for SerialWriter and SerialReader. Trivially copyable types are their bytes,
+// aligned to their alignment. Specialize for other types, writing and reading the fields in order.
+//
+//     template<>
+//     struct Serial<Quote> {
+//         template<typename Sink>
+//         static void write(SerialWriter<Sink>& out, const Quote& q) {
+//             out.write(q.symbol);
+//             out.write(q.prices);
+//         }
+//
+//         static Quote read(SerialReader& in) {
+//             auto symbol = in.read<String>();
+//             return Quote {efp::move(symbol), in.read<Vector<double>>()};
+//         }
+//     };
+template<typename A, typename = void>
+struct Serial: detail::SerialBlock {
+    static_assert(
+        std::is_trivially_copyable<A>::value,
+        "Serial: specialize Serial for a type which is not trivially copyable"
+    );
+
+    template<typename Sink>
+    static void write(SerialWriter<Sink>& out, const A& a) {
+        out.write_block(&a, 1);
+    }
+
+    static A read(SerialReader& in);
+};
+
+// Elements of which the encoding is their bytes, so that a sequence of them is a single block
+template<typename A>
+using IsSerialBlock = Bool<std::is_base_of<detail::SerialBlock, Serial<A>>::value>;
+
+// SerialWriter
+// Writes values to a sink in the serial format: a header with a format version and the version
+// given by the caller, followed by the values in order. Everything is aligned from the start of
+// the stream, so that a reader over a suitably aligned buffer, like a MappedFile, views the
+// sequences in place. A sequence of trivially copyable elements is written as a single block.
+// The sink needs write(const char*, size_t) returning bool, like File and BufWriter, or is a
+// String to which the bytes are appended.
+//
+//     BufWriter out {file, 1 << 20};
+//     SerialWriter<BufWriter> writer {out, 2};
+//     writer.write(prices);
+//     writer.write(names);
+template<typename Sink>
+class SerialWriter {
+public:
+    explicit SerialWriter(Sink& sink, uint32_t version = 0)
+        : _sink(sink), _offset(0), _ok(true) {
+        write_bytes(detail::serial_magic, sizeof(detail::serial_magic));
+
+        const uint32_t versions[2] = {detail::serial_format_version, version};
+        write_block(versions, 2);
+    }
+
+    SerialWriter(const SerialWriter&) = delete;
+
+    SerialWriter& operator=(const SerialWriter&) = delete;
+
+    // Writes the value, returning false once a write to the sink has failed
+    template<typename A>
+    bool write(const A& a) {
+        Serial<A>::write(*this, a);
+        return _ok;
+    }
+
+    // Bytes written so far, including the header
+    size_t offset() const {
+        return _offset;
+    }
+
+    bool ok() const {
+        return _ok;
+    }
+
+    // Building blocks of Serial specializations
+
+    void write_bytes(const void* data, size_t n) {
+        _ok = detail::serial_sink_write(_sink, static_cast<const char*>(data), n) && _ok;
+        _offset += n;
+    }
+
+    // Zeros up to the next multiple of the alignment
+    void align(size_t alignment) {
+        static const char zeros[64] = {};
+
+        size_t padding = (alignment - _offset % alignment) % alignment;
+        while (padding != 0) {
+            const size_t n = padding < sizeof(zeros) ? padding : sizeof(zeros);
+            write_bytes(zeros, n);
+            padding -= n;
+        }
+    }
+
+    // The elements as one block, aligned to their alignment
+    template<typename A>
+    void write_block(const A* data, size_t n) {
+        align(alignof(A));
+
+        if (!detail::IsSerialScalar<A>::value) {
+            write_bytes(data, n * sizeof(A));
+            return;
+        }
+
+        for (size_t i = 0; i < n; ++i) {
+            const A swapped = detail::serial_swap(data[i]);
+            write_bytes(&swapped, sizeof(A));
+        }
+    }
+
+    // Length of a sequence, as 64 bits
+    void write_size(size_t n) {
+        const uint64_t size = n;
+        write_block(&size, 1);
+    }
+
+private:
+    Sink& _sink;
+    size_t _offset;
+    bool _ok;
+};
+
+// SerialReader
+// Reads the values written by a SerialWriter, in the same order, from bytes in memory such as a
+// MappedFile or a received buffer. read copies into owning values, while view returns the
+// elements of a trivially copyable sequence in place. Views need the bytes aligned as the
+// elements, which mappings and allocations are, and stay valid as long as the bytes. Throws on a
+// stream of another format version, a truncated stream, or a value out of range.
+//
+//     const auto file = MappedFile::open("state.bin").move();
+//     SerialReader reader {file.chars()};
+//     const VectorView<const double> prices = reader.view<double>();
+//     const Vector<String> names = reader.read<Vector<String>>();
+class SerialReader {
+public:
+    SerialReader(const char* data, size_t size) : _data(data), _size(size), _offset(0) {
+        if (size < detail::serial_header_size
+            || std::memcmp(data, detail::serial_magic, sizeof(detail::serial_magic)) != 0) {
+            throw RuntimeError("SerialReader::SerialReader: not a serialized stream");
+        }
+
+        _offset = sizeof(detail::serial_magic);
+        if (read<uint32_t>() != detail::serial_format_version) {
+            throw RuntimeError("SerialReader::SerialReader: unsupported format version");
+        }
+
+        _version = read<uint32_t>();
+    }
+
+    explicit SerialReader(const VectorView<const char>& bytes)
+        : SerialReader(bytes.data(), bytes.size()) {}
+
+    // Version given to the SerialWriter
+    uint32_t version() const {
+        return _version;
+    }
+
+    template<typename A>
+    A read() {
+        return Serial<A>::read(*this);
+    }
+
+    // Elements of a sequence of trivially copyable elements, in place
+    template<typename A>
+    VectorView<const A> view() {
+        static_assert(IsSerialBlock<A>::value, "SerialReader::view: elements must be blocks");
+
+        const size_t n = read_size();
+        return VectorView<const A>(_view_block<A>(n), n);
+    }
+
+    // Elements of a sequence of n trivially copyable elements, in place
+    template<typename A, size_t n>
+    ArrayView<const A, n> array_view() {
+        static_assert(IsSerialBlock<A>::value, "SerialReader::array_view: elements must be blocks");
+
+        if (read_size() != n) {
+            throw RuntimeError("SerialReader::array_view: length mismatch");
+        }
+
+        return ArrayView<const A, n>(_view_block<A>(n));
+    }
+
+    // Bytes read so far, including the header
+    size_t offset() const {
+        return _offset;
+    }
+
+    size_t remaining() const {
+        return _size - _offset;
+    }
+
+    // Building blocks of Serial specializations
+
+    // Next n bytes. Throws if the stream is shorter
+    const char* read_bytes(size_t n) {
+        if (n > _size - _offset) {
+            throw RuntimeError("SerialReader::read_bytes: truncated stream");
+        }
+
+        const char* p = _data + _offset;
+        _offset += n;
+        return p;
+    }
+
+    // Skips to the next multiple of the alignment
+    void align(size_t alignment) {
+        read_bytes((alignment - _offset % alignment) % alignment);
+    }
+
+    // Copies n elements written by write_block
+    template<typename A>
+    void read_block(A* out, size_t n) {
+        align(alignof(A));
+
+        if (n > (_size - _offset) / sizeof(A)) {
+            throw RuntimeError("SerialReader::read_block: truncated stream");
+        }
+
+        _memcpy(out, read_bytes(n * sizeof(A)), n * sizeof(A));
+
+        if (detail::IsSerialScalar<A>::value) {
+            for (size_t i = 0; i < n; ++i) {
+                out[i] = detail::serial_swap(out[i]);
+            }
+        }
+    }
+
+    size_t read_size() {
+        uint64_t size;
+        read_block(&size, 1);
+
+        if (size > _size) {
+            throw RuntimeError("SerialReader::read_size: length out of range");
+        }
+
+        return static_cast<size_t>(size);
+    }
+
+private:
+    template<typename A>
+    const A* _view_block(size_t n) {
+        if (detail::IsSerialScalar<A>::value) {
+            throw RuntimeError("SerialReader::view: stored byte order differs from the host");
+        }
+
+        align(alignof(A));
+
+        if (n > (_size - _offset) / sizeof(A)) {
+            throw RuntimeError("SerialReader::view: truncated stream");
+        }
+
+        const char* p = read_bytes(n * sizeof(A));
+        if (reinterpret_cast<uintptr_t>(p) % alignof(A) != 0) {
+            throw RuntimeError("SerialReader::view: bytes are not aligned");
+        }
+
+        return reinterpret_cast<const A*>(p);
+    }
+
+    const char* _data;
+    size_t _size;
+    size_t _offset;
+    uint32_t _version;
+};
+
+template<typename A, typename B>
+inline A Serial<A, B>::read(SerialReader& in) {
+    A a;
+    in.read_block(&a, 1);
+    return a;
+}
+
+namespace detail {
+
+    template<typename A, typename = void>
+    struct SerialElements;
+
+    // Elements of which the encoding is their bytes, read and written as one block
+    template<typename A>
+    struct SerialElements<A, EnableIf<IsSerialBlock<A>::value>> {
+        template<typename Sink>
+        static void write(SerialWriter<Sink>& out, const A* as, size_t n) {
+            out.write_block(as, n);
+        }
+
+        // Reads into the sequence, resized to n. The length is checked against the stream first,
+        // so a corrupt one throws before allocating
+        template<typename As>
+        static void read_into(SerialReader& in, As& as, size_t n) {
+            if (n > in.remaining() / sizeof(A)) {
+                throw RuntimeError("SerialElements::read_into: truncated stream");
+            }
+
+            as.resize(n);
+            in.read_block(as.data(), n);
+        }
+
+        static void read_over(SerialReader& in, A* as, size_t n) {
+            in.read_block(as, n);
+        }
+    };
+
+    template<typename A>
+    struct SerialElements<A, EnableIf<!IsSerialBlock<A>::value>> {
+        template<typename Sink>
+        static void write(SerialWriter<Sink>& out, const A* as, size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                Serial<A>::write(out, as[i]);
+            }
+        }
+
+        // Appends n elements to the empty sequence. Nothing is reserved, as a corrupt length is
+        // only found when the elements run out
+        template<typename As>
+        static void read_into(SerialReader& in, As& as, size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                as.push_back(Serial<A>::read(in));
+            }
+        }
+
+        // Assigns the n constructed elements
+        static void read_over(SerialReader& in, A* as, size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                as[i] = Serial<A>::read(in);
+            }
+        }
+    };
+
+    // SerialSequence
+    // Length followed by the elements. The encoding depends only on the elements, so a Vector may
+    // be read back as an ArrVec or viewed in place
+    struct SerialSequence {
+        template<typename Sink, typename As>
+        static void write(SerialWriter<Sink>& out, const As& as) {
+            const size_t n = length(as);
+            out.write_size(n);
+            SerialElements<ConstRemoved<Element<As>>>::write(out, data(as), n);
+        }
+
+        template<typename As>
+        static void read_into(SerialReader& in, As& as, size_t n) {
+            SerialElements<Element<As>>::read_into(in, as, n);
+        }
+    };
+
+    template<typename... As>
+    struct SerialEnum {
+        template<uint8_t i>
+        struct Write {
+            template<typename Sink>
+            static void call(SerialWriter<Sink>& out, const Enum<As...>& e) {
+                Serial<PackAt<i, As...>>::write(out, e.template get<i>());
+            }
+        };
+
+        template<uint8_t i>
+        struct Read {
+            static Enum<As...> call(SerialReader& in) {
+                return Enum<As...>(Serial<PackAt<i, As...>>::read(in));
+            }
+        };
+    };
+}  // namespace detail
+
+template<typename A, size_t n, size_t align>
+struct Serial<Array<A, n, align>> {
+    template<typename Sink>
+    static void write(SerialWriter<Sink>& out, const Array<A, n, align>& as) {
+        detail::SerialSequence::write(out, as);
+    }
+
+    static Array<A, n, align> read(SerialReader& in) {
+        if (in.read_size() != n) {
+            throw RuntimeError("Serial<Array>::read: length mismatch");
+        }
+
+        Array<A, n, align> as {};
+        detail::SerialElements<A>::read_over(in, as.data(), n);
+        return as;
+    }
+};
+
+template<typename A, size_t n, size_t align>
+struct Serial<ArrVec<A, n, align>> {
+    template<typename Sink>
+    static void write(SerialWriter<Sink>& out, const ArrVec<A, n, align>& as) {
+        detail::SerialSequence::write(out, as);
+    }
+
+    static ArrVec<A, n, align> read(SerialReader& in) {
+        const size_t size = in.read_size();
+        if (size > n) {
+            throw RuntimeError("Serial<ArrVec>::read: length exceeds the capacity");
+        }
+
+        ArrVec<A, n, align> as {};
+        detail::SerialSequence::read_into(in, as, size);
+        return as;
+    }
+};
+
+// Also String
+template<typename A, typename Allocator, typename Traits, typename B>
+struct Serial<Vector<A, Allocator, Traits, B>> {
+    template<typename Sink>
+    static void write(SerialWriter<Sink>& out, const Vector<A, Allocator, Traits, B>& as) {
+        detail::SerialSequence::write(out, as);
+    }
+
+    static Vector<A, Allocator, Traits, B> read(SerialReader& in) {
+        const size_t size = in.read_size();
+
+        Vector<A, Allocator, Traits, B> as {};
+        detail::SerialSequence::read_into(in, as, size);
+        return as;
+    }
+};
+
+// Views are written as the owning sequences. Reading one views the bytes in place
+template<typename A, typename Traits, typename B>
+struct Serial<VectorView<A, Traits, B>> {
+    template<typename Sink>
+    static void write(SerialWriter<Sink>& out, const VectorView<A, Traits, B>& as) {
+        detail::SerialSequence::write(out, as);
+    }
+
+    static VectorView<A, Traits, B> read(SerialReader& in) {
+        const VectorView<const ConstRemoved<A>> view = in.view<ConstRemoved<A>>();
+        return VectorView<A, Traits, B>(view.data(), view.size());
+    }
+};
+
+template<typename A, size_t n>
+struct Serial<ArrayView<A, n>> {
+    template<typename Sink>
+    static void write(SerialWriter<Sink>& out, const ArrayView<A, n>& as) {
+        detail::SerialSequence::write(out, as);
+    }
+
+    static ArrayView<A, n> read(SerialReader& in) {
+        return ArrayView<A, n>(in.array_view<ConstRemoved<A>, n>().data());
+    }
+};
+
+template<>
+struct Serial<Nothing> {
+    template<typename Sink>
+    static void write(SerialWriter<Sink>&, const Nothing&) {}
+
+    static Nothing read(SerialReader&) {
+        return nothing;
+    }
+};
+
+// The index of the active alternative followed by it. Also Maybe, of which the index tells
+// nothing from a value
+template<typename... As>
+struct Serial<Enum<As...>> {
+    template<typename Sink>
+    static void write(SerialWriter<Sink>& out, const Enum<As...>& e) {
+        const uint8_t index = e.index();
+        out.write_block(&index, 1);
+
+        detail::EnumSwitch<
+            sizeof...(As),
+            detail::SerialEnum<As...>::template Write,
+            SerialWriter<Sink>&,
+            const Enum<As...>&>::call(index, out, e);
+    }
+
+    static Enum<As...> read(SerialReader& in) {
+        uint8_t index;
+        in.read_block(&index, 1);
+
+        // The switch would take an index past the alternatives as the last one
+        if (index >= sizeof...(As)) {
+            throw RuntimeError("Serial<Enum>::read: index out of range");
+        }
+
+        return detail::EnumSwitch<
+            sizeof...(As),
+            detail::SerialEnum<As...>::template Read,
+            SerialReader&>::call(index, in);
+    }
+};
+
+}  // namespace efp
+
+#endif
@@ -151,36 +151,32 @@ void size_trosort_by(Vector<A>& arr, const F& comp) {
 }
 
 // Function to merge two sorted sub-vectors
+// Buffers the left run and merges forward, which is linear and keeps the order of equal elements
 template<typename A, typename F>
 void timsort_merge(Vector<A>& arr, size_t start, size_t mid, size_t end, const F& comp) {
-    size_t start2 = mid + 1;
-
     // If the direct merge is already sorted
-    if (!comp(arr[mid], arr[start2]))
+    if (!comp(arr[mid + 1], arr[mid]))
         return;
 
-    // Two posize_ters to masize_tain start of both arrays to merge
-    while (start <= mid && start2 <= end) {
-        // If element 1 is in right place
-        if (!comp(arr[start2], arr[start])) {
-            start++;
-        } else {
-            A value = arr[start2];
-            size_t index = start2;
+    Vector<A> lefts;
+    lefts.reserve(mid - start + 1);
+    for (size_t i = start; i <= mid; i++)
+        lefts.push_back(efp::move(arr[i]));
 
-            // Shift all the elements between element 1 and element 2, right by 1.
-            while (index != start) {
-                arr[index] = arr[index - 1];
-                index--;
-            }
-            arr[start] = value;
+    const size_t n1 = lefts.size();
+    size_t i = 0, j = mid + 1, k = start;
 
-            // Update all the posize_ters
-            start++;
-            mid++;
-            start2++;
+    // Take from the left run on ties for stability
+    while (i < n1 && j <= end) {
+        if (comp(arr[j], lefts[i])) {
+            arr[k++] = efp::move(arr[j++]);
+        } else {
+            arr[k++] = efp::move(lefts[i++]);
         }
     }
+
+    while (i < n1)
+        arr[k++] = efp::move(lefts[i++]);
 }
 
 // Iterative Timsort function to sort the array[0...n-1] (similar to Python's and Java's)
@@ -15,68 +15,458 @@ namespace efp {
 template<typename Char, typename = EnableIf<detail::IsCharType<Char>::value>>
 using BasicStringView = VectorView<Char>;
 
+namespace detail {
+    // StringBase
+    // Storage of BasicString with small string optimization. Short strings are stored inline, in
+    // the bytes which would otherwise hold the pointer, size and capacity of a heap allocation, so
+    // they neither allocate nor chase a pointer, and moving one copies the inline bytes.
+    // A tag next to the allocator tells the two apart, which fits in the padding of a stateless
+    // allocator. The characters are always null terminated.
+    template<typename Char, typename Traits, typename Allocator>
+    class StringBase {
+    public:
+        using Element = Char;
+        using CtSize = Size<dyn>;
+        using CtCapacity = Size<dyn>;
+
+        // STL compatible types
+        using value_type = Element;
+        using allocator_type = Allocator;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+        using pointer = value_type*;
+        using const_pointer = const value_type*;
+        using iterator = value_type*;
+        using const_iterator = const value_type*;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    private:
+        struct Heap {
+            Char* data;
+            size_t size;
+            size_t capacity;
+        };
+
+    public:
+        // Inline capacity including the null terminator
+        static constexpr size_t local_capacity = sizeof(Heap) / sizeof(Char);
+
+        StringBase() : _allocator(Allocator()), _tag(0) {
+            _storage.local[0] = Char();
+        }
+
+        // Stateful allocator instance will be used for all the allocations of the string
+        explicit StringBase(const Allocator& alloc) : _allocator(alloc), _tag(0) {
+            _storage.local[0] = Char();
+        }
+
+        StringBase(const StringBase& other) : _allocator(other._allocator), _tag(0) {
+            _storage.local[0] = Char();
+            _assign(other.data(), other.size());
+        }
+
+        // Allocator is not propagated on copy assignment. The storage stays in this allocator
+        StringBase& operator=(const StringBase& other) {
+            if (this != &other) {
+                _assign(other.data(), other.size());
+            }
+
+            return *this;
+        }
+
+        // Copies the whole storage, which is either the inline characters or the heap handle
+        StringBase(StringBase&& other) noexcept
+            : _allocator(other._allocator), _tag(other._tag), _storage(other._storage) {
+            other._set_empty();
+        }
+
+        // Allocator is propagated on move assignment, since the storage is taken over
+        StringBase& operator=(StringBase&& other) noexcept {
+            if (this != &other) {
+                _deallocate();
+
+                _allocator = other._allocator;
+                _tag = other._tag;
+                _storage = other._storage;
+
+                other._set_empty();
+            }
+
+            return *this;
+        }
+
+        StringBase(InitializerList<Element> il, const Allocator& alloc = Allocator())
+            : _allocator(alloc), _tag(0) {
+            _storage.local[0] = Char();
+            _assign(il.begin(), il.size());
+        }
+
+        template<size_t ct_size_, size_t ct_align_>
+        StringBase(
+            const Array<Element, ct_size_, ct_align_>& as,
+            const Allocator& alloc = Allocator()
+        )
+            : _allocator(alloc), _tag(0) {
+            _storage.local[0] = Char();
+            _assign(as.data(), ct_size_);
+        }
+
+        template<size_t ct_cap_, size_t ct_align_>
+        StringBase(
+            const ArrVec<Element, ct_cap_, ct_align_>& as,
+            const Allocator& alloc = Allocator()
+        )
+            : _allocator(alloc), _tag(0) {
+            _storage.local[0] = Char();
+            _assign(as.data(), as.size());
+        }
+
+        ~StringBase() {
+            _deallocate();
+        }
+
+        Element& operator[](size_t index) {
+            return data()[index];
+        }
+
+        const Element& operator[](size_t index) const {
+            return data()[index];
+        }
+
+        bool operator==(const StringBase& other) const {
+            const size_t n = size();
+            return n == other.size() && Traits::compare(data(), other.data(), n) == 0;
+        }
+
+        size_t size() const {
+            return _is_local() ? _tag : _storage.heap.size;
+        }
+
+        // Including the null terminator
+        size_t capacity() const {
+            return _is_local() ? local_capacity : _storage.heap.capacity;
+        }
+
+        Allocator get_allocator() const {
+            return _allocator;
+        }
+
+        size_t max_size() const {
+            return AllocatorTraits<Allocator>::max_size(_allocator);
+        }
+
+        // New characters are left unspecified
+        void resize(size_t new_size) {
+            if (new_size + 1 > capacity()) {
+                reserve(new_size + 1);
+            }
+
+            _set_size(new_size);
+        }
+
+        void reserve(size_t new_capacity) {
+            if (new_capacity > capacity()) {
+                _reallocate(new_capacity);
+            }
+        }
+
+        // Moves back inline if the string fits
+        void shrink_to_fit() {
+            if (_is_local()) {
+                return;
+            }
+
+            const size_t n = _storage.heap.size;
+            if (n + 1 <= local_capacity) {
+                Char* heap_data = _storage.heap.data;
+                const size_t heap_capacity = _storage.heap.capacity;
+
+                Traits::copy(_storage.local, heap_data, n);
+                _tag = 0;
+                _set_size(n);
+
+                AllocatorTraits<Allocator>::deallocate(_allocator, heap_data, heap_capacity);
+            } else if (n + 1 < _storage.heap.capacity) {
+                _reallocate(n + 1);
+            }
+        }
+
+        void push_back(Element value) {
+            const size_t n = size();
+            if (n + 1 >= capacity()) {
+                _reallocate(2 * n + 1);
+            }
+
+            data()[n] = value;
+            _set_size(n + 1);
+        }
+
+        template<typename... Args>
+        void emplace_back(Args&&... args) {
+            push_back(Element(efp::forward<Args>(args)...));
+        }
+
+        void pop_back() {
+            const size_t n = size();
+            if (n == 0) {
+                throw RuntimeError("StringBase::pop_back: size must be greater than 0");
+            }
+
+            _set_size(n - 1);
+        }
+
+        void insert(size_t index, Element value) {
+            const size_t n = size();
+            if (index > n) {
+                throw RuntimeError("StringBase::insert: index must be less than or equal to size");
+            }
+
+            if (n + 1 >= capacity()) {
+                _reallocate(2 * n + 1);
+            }
+
+            Char* d = data();
+            Traits::move(d + index + 1, d + index, n - index);
+            d[index] = value;
+            _set_size(n + 1);
+        }
+
+        void erase(size_t index) {
+            const size_t n = size();
+            if (index >= n) {
+                throw RuntimeError("StringBase::erase: index must be less than size");
+            }
+
+            Char* d = data();
+            Traits::move(d + index, d + index + 1, n - index - 1);
+            _set_size(n - 1);
+        }
+
+        void clear() {
+            _set_size(0);
+        }
+
+        const Element* data() const {
+            return _is_local() ? _storage.local : _storage.heap.data;
+        }
+
+        Element* data() {
+            return _is_local() ? _storage.local : _storage.heap.data;
+        }
+
+        Element* begin() {
+            return data();
+        }
+
+        const Element* begin() const {
+            return data();
+        }
+
+        Element* end() {
+            return data() + size();
+        }
+
+        const Element* end() const {
+            return data() + size();
+        }
+
+        bool empty() const {
+            return size() == 0;
+        }
+
+    protected:
+        // Replaces the contents. The source may be a part of this string
+        void _assign(const Char* s, size_t n) {
+            if (n + 1 > capacity()) {
+                Char* new_data = AllocatorTraits<Allocator>::allocate(_allocator, n + 1);
+                Traits::copy(new_data, s, n);
+                _deallocate();
+                _set_heap(new_data, n + 1);
+            } else {
+                Traits::move(data(), s, n);
+            }
+
+            _set_size(n);
+        }
+
+        // Appends n characters. The source may be a part of this string
+        void _append(const Char* s, size_t n) {
+            const size_t old_size = size();
+            if (old_size + n + 1 > capacity()) {
+                const size_t doubled = 2 * capacity();
+                const size_t required = old_size + n + 1;
+                const Char* old_data = data();
+
+                Char* new_data = AllocatorTraits<Allocator>::allocate(
+                    _allocator,
+                    doubled > required ? doubled : required
+                );
+                Traits::copy(new_data, old_data, old_size);
+                Traits::copy(new_data + old_size, s, n);
+
+                _deallocate();
+                _set_heap(new_data, doubled > required ? doubled : required);
+            } else {
+                Traits::move(data() + old_size, s, n);
+            }
+
+            _set_size(old_size + n);
+        }
+
+        // Reserves the required capacity, at least doubling it, so that growing one piece at a
+        // time is amortized constant
+        void _grow(size_t required) {
+            if (required > capacity()) {
+                const size_t doubled = 2 * capacity();
+                _reallocate(doubled > required ? doubled : required);
+            }
+        }
+
+        // Inserts n characters at pos. The source may be a part of this string
+        void _insert(size_t pos, const Char* s, size_t n) {
+            const size_t old_size = size();
+            const bool inside = s >= data() && s < data() + old_size;
+            const size_t offset = inside ? static_cast<size_t>(s - data()) : 0;
+
+            _grow(old_size + n + 1);
+
+            Char* d = data();
+            if (inside) {
+                s = d + offset;
+            }
+
+            Traits::move(d + pos + n, d + pos, old_size - pos);
+
+            if (!inside || offset + n <= pos) {
+                Traits::copy(d + pos, s, n);
+            } else if (offset >= pos) {
+                // The source was moved along with the tail
+                Traits::copy(d + pos, s + n, n);
+            } else {
+                // The source straddles pos, its second part was moved along with the tail
+                const size_t head = pos - offset;
+                Traits::copy(d + pos, s, head);
+                Traits::copy(d + pos + head, d + pos + n, n - head);
+            }
+
+            _set_size(old_size + n);
+        }
+
+        // Sets the size and the null terminator. The capacity must be enough
+        void _set_size(size_t n) {
+            if (_is_local()) {
+                _tag = static_cast<unsigned char>(n);
+                _storage.local[n] = Char();
+            } else {
+                _storage.heap.size = n;
+                _storage.heap.data[n] = Char();
+            }
+        }
+
+        Allocator _allocator;
+
+    private:
+        static constexpr unsigned char heap_tag = 0xff;
+
+        static_assert(local_capacity < heap_tag, "StringBase: inline size must fit in the tag");
+
+        union Storage {
+            Heap heap;
+            Char local[local_capacity];
+        };
+
+        bool _is_local() const {
+            return _tag != heap_tag;
+        }
+
+        // Sets heap storage, keeping the size unset
+        void _set_heap(Char* new_data, size_t new_capacity) {
+            _tag = heap_tag;
+            _storage.heap.data = new_data;
+            _storage.heap.size = 0;
+            _storage.heap.capacity = new_capacity;
+        }
+
+        void _reallocate(size_t new_capacity) {
+            const size_t n = size();
+            Char* new_data = AllocatorTraits<Allocator>::allocate(_allocator, new_capacity);
+            Traits::copy(new_data, data(), n);
+
+            _deallocate();
+            _set_heap(new_data, new_capacity);
+            _set_size(n);
+        }
+
+        void _deallocate() {
+            if (!_is_local()) {
+                AllocatorTraits<Allocator>::deallocate(
+                    _allocator,
+                    _storage.heap.data,
+                    _storage.heap.capacity
+                );
+            }
+        }
+
+        void _set_empty() {
+            _tag = 0;
+            _storage.local[0] = Char();
+        }
+
+        unsigned char _tag;
+        Storage _storage;
+    };
+
+    template<typename Char, typename Traits, typename Allocator>
+    constexpr size_t StringBase<Char, Traits, Allocator>::local_capacity;
+
+    template<typename Char, typename Traits, typename Allocator>
+    constexpr unsigned char StringBase<Char, Traits, Allocator>::heap_tag;
+}  // namespace detail
+
 // BasicString
 
 template<typename Char, typename Traits, typename Allocator>
 class Vector<Char, Allocator, Traits, EnableIf<detail::IsCharType<Char>::value>>:
-    public detail::VectorBase<Char, Allocator> {
+    public detail::StringBase<Char, Traits, Allocator> {
 public:
-    using Base = detail::VectorBase<Char>;
+    using Base = detail::StringBase<Char, Traits, Allocator>;
     using Base::Base;
 
     using traits_type = Traits;
     static const size_t npos = -1;
 
-    Vector(const Char* c_str) {
-        Base::_size = Traits::length(c_str);
-        Base::_capacity = Base::_size + 1;
-        // Base::_data = Base::_allocator.allocate(Base::_capacity);
-        Base::_data = AllocatorTraits<Allocator>::allocate(Base::_allocator, Base::_capacity);
-        _memcpy(Base::_data, c_str, Base::_size * sizeof(Char));
+    Vector(const Char* c_str, const Allocator& alloc = Allocator()) : Base(alloc) {
+        Base::_assign(c_str, Traits::length(c_str));
     }
 
-    Vector(const Char* s, size_t count, const Allocator& alloc = Allocator()) {
-        Base::_size = count;
-        Base::_capacity = Base::_size + 1;
-        // Base::_data = Base::_allocator.allocate(Base::_capacity);
-        Base::_data = AllocatorTraits<Allocator>::allocate(Base::_allocator, Base::_capacity);
-        _memcpy(Base::_data, s, Base::_size * sizeof(Char));
+    Vector(const Char* s, size_t count, const Allocator& alloc = Allocator()) : Base(alloc) {
+        Base::_assign(s, count);
     }
 
-    Vector(size_t size, Char c) {
-        Base::_capacity = size;
-        Base::_data = static_cast<Char*>(::operator new[](Base::_capacity * sizeof(Char)));
-        Base::_size = size;
-        for (size_t i = 0; i < size; ++i) {
-            Base::_data[i] = c;
-        }
+    Vector(size_t size, Char c, const Allocator& alloc = Allocator()) : Base(alloc) {
+        Base::resize(size);
+        Traits::assign(Base::data(), size, c);
     }
 
-    // template<class InputIt>
-    // Vector(InputIt first, InputIt last, const Allocator& alloc = Allocator())
-    //     : allocator_(alloc), size_(std::distance(first, last)), capacity_(size_) {
-    //     data_ = allocator_.allocate(capacity_);
-    //     std::uninitialized_copy(first, last, data_);
-    // }
-
     // Not using iterator
-    template<typename InputIt>
-    Vector(InputIt first, InputIt last, const Allocator& alloc = Allocator())
-        : Base::allocator_(alloc), Base::size_(0), Base::capacity_(0) {
+    template<typename InputIt, typename = EnableIf<!std::is_integral<InputIt>::value>>
+    Vector(InputIt first, InputIt last, const Allocator& alloc = Allocator()) : Base(alloc) {
         // First pass: Count the number of elements to determine size
+        size_t size = 0;
         for (InputIt it = first; it != last; ++it) {
-            ++Base::size_;
+            ++size;
         }
-        Base::capacity_ = Base::size_ + 1;
 
-        // Allocate memory for the elements
-        // Base::data_ = Base::allocator_.allocate(Base::capacity_);
-        Base::data_ = AllocatorTraits<Allocator>::allocate(Base::allocator_, Base::capacity_);
+        Base::resize(size);
 
-        // Second pass: Copy-construct elements from the range
+        // Second pass: Copy the characters from the range
+        Char* d = Base::data();
         size_t i = 0;
         for (InputIt it = first; it != last; ++it, ++i) {
-            Base::allocator_.construct(Base::data_ + i, *it);
+            d[i] = *it;
         }
     }
 
@@ -86,67 +476,61 @@ public:
 
     // Specialized equality comparison operator with const char *
     bool operator==(const Char* c_str) const {
-        if (Base::_data == nullptr && c_str == nullptr) {
-            return true;
-        }
-
-        if (Base::_data == nullptr || c_str == nullptr) {
-            return false;
+        if (c_str == nullptr) {
+            return Base::empty();
         }
 
         size_t c_str_len = Traits::length(c_str);
-        if (Base::_size != c_str_len) {
+        if (Base::size() != c_str_len) {
             return false;
         }
 
-        return Traits::compare(Base::_data, c_str, Base::_size) == 0;
+        return Traits::compare(Base::data(), c_str, c_str_len) == 0;
     }
 
     Char at(size_t pos) const {
-        if (pos >= Base::_size) {
+        if (pos >= Base::size()) {
             throw RuntimeError("Index out of range");
         }
 
-        return Base::_data[pos];
+        return Base::data()[pos];
     }
 
     Char front() const {
-        return Base::_data[0];
+        return Base::data()[0];
     }
 
     Char back() const {
-        return Base::_data[Base::_size - 1];
+        return Base::data()[Base::size() - 1];
     }
 
     Vector& operator+=(const Vector& other) {
-        for (size_t i = 0; i < other.size(); ++i) {
-            Base::push_back(other[i]);
-        }
-
+        Base::_append(other.data(), other.size());
         return *this;
     }
 
     Vector& append(const Char* c_str) {
-        const size_t len = Traits::length(c_str);
-
-        for (size_t i = 0; i < len; ++i) {
-            Base::push_back(c_str[i]);
-        }
+        Base::_append(c_str, Traits::length(c_str));
+        return *this;
+    }
 
+    Vector& append(const Char* s, size_t n) {
+        Base::_append(s, n);
         return *this;
     }
 
     Vector& append(size_t n, Char c) {
-        for (size_t i = 0; i < n; ++i) {
-            Base::push_back(c);
-        }
+        const size_t old_size = Base::size();
+        Base::_grow(old_size + n + 1);
+        Traits::assign(Base::data() + old_size, n, c);
+        Base::_set_size(old_size + n);
 
         return *this;
     }
 
     Vector& assign(const Char* c_str) {
-        Base::clear();
-        return append(c_str);
+        Base::_assign(c_str, Traits::length(c_str));
+        return *this;
     }
 
     Vector& assign(size_t n, Char c) {
@@ -155,44 +539,16 @@ public:
     }
 
     Vector& insert(size_t pos, const Char* c_str) {
-        if (pos > Base::_size) {
-            throw RuntimeError("Index out of range");
-        }
-
-        const size_t len = Traits::length(c_str);
-        Base::reserve(Base::_size + len);
-
-        for (size_t i = Base::_size; i > pos; --i) {
-            Base::_data[i + len - 1] = Base::_data[i - 1];
-        }
-
-        for (size_t i = 0; i < len; ++i) {
-            Base::_data[pos + i] = c_str[i];
-        }
-
-        Base::_size += len;
-
-        return *this;
+        return insert(pos, c_str, Traits::length(c_str));
     }
 
     Vector& insert(size_t pos, const Char* c_str, size_t n) {
-        if (pos > Base::_size) {
+        const size_t old_size = Base::size();
+        if (pos > old_size) {
             throw RuntimeError("Index out of range");
         }
 
-        // Always reserve one extra space for the null character
-        Base::reserve(Base::_size + n + 1);
-
-        for (size_t i = Base::_size; i > pos; --i) {
-            Base::_data[i + n - 1] = Base::_data[i - 1];
-        }
-
-        for (size_t i = 0; i < n; ++i) {
-            Base::_data[pos + i] = c_str[i];
-        }
-
-        Base::_size += n;
-
+        Base::_insert(pos, c_str, n);
         return *this;
     }
 
@@ -201,62 +557,60 @@ public:
     // todo replace(size_type pos, size_type len, const CharT* s, size_type n)
 
     Vector substr(size_t pos = 0, size_t len = npos) const {
-        if (pos > Base::_size) {
+        const size_t size = Base::size();
+        if (pos > size) {
             throw RuntimeError("Index out of range");
         }
 
-        if (len > Base::_size - pos) {
-            len = Base::_size - pos;
+        if (len > size - pos) {
+            len = size - pos;
         }
 
-        return Vector(Base::_data + pos, len);
+        return Vector(Base::data() + pos, len, Base::_allocator);
     }
 
     // The resulting character string is not null-terminated.
     // https://en.cppreference.com/w/cpp/string/basic_string/copy
     size_t copy(Char* dest, size_t count, size_t pos = 0) const {
-        if (pos > Base::_size) {
+        const size_t size = Base::size();
+        if (pos > size) {
             throw RuntimeError("Index out of range");
         }
 
-        if (count > Base::_size - pos) {
-            count = Base::_size - pos;
+        if (count > size - pos) {
+            count = size - pos;
         }
 
-        _memcpy(dest, Base::_data + pos, count * sizeof(Char));
+        _memcpy(dest, Base::data() + pos, count * sizeof(Char));
         return count;
     }
 
     // todo find, rfind, find_first_of, find_last_of, find_first_not_of, find_last_not_of
 
     int compare(const Vector& other) const {
-        return Traits::compare(Base::_data, other.data(), Base::_size);
+        return Traits::compare(Base::data(), other.data(), Base::size());
     }
 
     int compare(size_t pos, size_t len, const Vector& other) const {
-        if (pos > Base::_size) {
+        const size_t size = Base::size();
+        if (pos > size) {
             throw RuntimeError("Index out of range");
         }
 
-        if (len > Base::_size - pos) {
-            len = Base::_size - pos;
+        if (len > size - pos) {
+            len = size - pos;
         }
 
-        return Traits::compare(Base::_data + pos, other.data(), len);
+        return Traits::compare(Base::data() + pos, other.data(), len);
     }
 
     const Char* c_str() const {
-        Base::_data[Base::_size] = '\0';
-        return Base::_data;
-    }
-
-    operator BasicStringView<Char, Traits>() const {
-        return BasicStringView<Char, Traits>(Base::_data, Base::_size);
+        return Base::data();
     }
 
 #if defined(__STDC_HOSTED__) && __STDC_HOSTED__ == 1
     operator std::string() const {
-        return std::string(Base::_data, Base::_size);
+        return std::string(Base::data(), Base::size());
     }
 #endif
 };  // class Vector
@@ -291,12 +645,15 @@ public:
 
     VectorView(const Char* c_str) {
         Base::_size = Traits::length(c_str);
+        Base::_capacity = Base::_size;
         Base::_data = c_str;
     }
 
-    // todo basic_string_view(const efp::BasicString<Char>& s) noexcept
-    VectorView(const Vector<Char>& s) noexcept {
+    // Implicit conversion from BasicString of any allocator
+    template<typename Allocator>
+    VectorView(const Vector<Char, Allocator, Traits>& s) noexcept {
         Base::_size = s.size();
+        Base::_capacity = s.size();
         Base::_data = s.data();
     }
 
@@ -0,0 +1,155 @@
+#ifndef EFP_STRING_BUILDER_HPP_
+#define EFP_STRING_BUILDER_HPP_
+
+#include "efp/cpp_core.hpp"
+#include "efp/allocator.hpp"
+#include "efp/sequence.hpp"
+#include "efp/string.hpp"
+#include "efp/io.hpp"
+
+namespace efp {
+
+// StringBuilder
+// Records text as a list of pieces and assembles it once. Owned pieces are copied into arena
+// blocks, and consecutive ones share a block, while borrowed pieces are only referenced, so
+// appending never moves what has been appended before. build makes a String with a single
+// allocation of the exact size, and write_to writes the pieces out without building it.
+//
+//     StringBuilder sb {};
+//     sb.append("id,value\n");
+//     sb.append_borrowed(large_view);  // Must outlive the builder
+//     const String report = sb.build();
+class StringBuilder {
+public:
+    explicit StringBuilder(size_t block_size = 4096)
+        : _pieces(), _size(0), _tail(nullptr), _tail_free(0), _tail_piece(dyn),
+          _block_size(block_size), _arena(block_size) {}
+
+    StringBuilder(const StringBuilder&) = delete;
+
+    StringBuilder& operator=(const StringBuilder&) = delete;
+
+    // Copies the characters
+    StringBuilder& append(const StringView& s) {
+        return append(s.data(), s.size());
+    }
+
+    StringBuilder& append(const char* c_str) {
+        return append(c_str, String::traits_type::length(c_str));
+    }
+
+    StringBuilder& append(const char* s, size_t n) {
+        if (n != 0) {
+            _memcpy(_reserve(n), s, n);
+        }
+        return *this;
+    }
+
+    StringBuilder& append(char c) {
+        *_reserve(1) = c;
+        return *this;
+    }
+
+    StringBuilder& append(size_t n, char c) {
+        if (n != 0) {
+            String::traits_type::assign(_reserve(n), n, c);
+        }
+        return *this;
+    }
+
+    // References the characters, which must stay valid as long as the builder is used
+    StringBuilder& append_borrowed(const StringView& s) {
+        if (s.size() != 0) {
+            _pieces.push_back(s);
+            _size += s.size();
+            // The next owned piece may not extend the one before the borrowed
+            _tail_piece = dyn;
+        }
+        return *this;
+    }
+
+    // Total number of characters
+    size_t size() const {
+        return _size;
+    }
+
+    bool empty() const {
+        return _size == 0;
+    }
+
+    const Vector<StringView>& pieces() const {
+        return _pieces;
+    }
+
+    String build() const {
+        String result {};
+        result.resize(_size);
+
+        char* out = result.data();
+        for (size_t i = 0; i < _pieces.size(); ++i) {
+            _memcpy(out, _pieces[i].data(), _pieces[i].size());
+            out += _pieces[i].size();
+        }
+
+        return result;
+    }
+
+    void clear() {
+        _pieces.clear();
+        _size = 0;
+        _tail = nullptr;
+        _tail_free = 0;
+        _tail_piece = dyn;
+        _arena.release();
+    }
+
+#if defined(__STDC_HOSTED__) && __STDC_HOSTED__ == 1
+    bool write_to(File& file) const {
+        for (size_t i = 0; i < _pieces.size(); ++i) {
+            if (!file.write(_pieces[i].data(), _pieces[i].size())) {
+                return false;
+            }
+        }
+        return true;
+    }
+#endif
+
+private:
+    // Space for n owned characters, extending the last piece if it ends at the tail
+    char* _reserve(size_t n) {
+        if (n > _tail_free) {
+            const size_t block = n > _block_size ? n : _block_size;
+            _tail = static_cast<char*>(_arena.allocate(block, 1));
+            _tail_free = block;
+            _tail_piece = dyn;
+        }
+
+        char* p = _tail;
+        _tail += n;
+        _tail_free -= n;
+        _size += n;
+
+        if (_tail_piece != dyn) {
+            const StringView& last = _pieces[_tail_piece];
+            _pieces[_tail_piece] = StringView(last.data(), last.size() + n);
+        } else {
+            _pieces.push_back(StringView(p, n));
+            _tail_piece = _pieces.size() - 1;
+        }
+
+        return p;
+    }
+
+    Vector<StringView> _pieces;
+    size_t _size;
+    char* _tail;
+    size_t _tail_free;
+    // Index of the piece ending at the tail, dyn if none
+    size_t _tail_piece;
+    size_t _block_size;
+    MonotonicArena _arena;
+};
+
+}  // namespace efp
+
+#endif
@@ -0,0 +1,295 @@
+#ifndef EFP_STRING_POOL_HPP_
+#define EFP_STRING_POOL_HPP_
+
+// ! Not for freestanding environments
+#if defined(__STDC_HOSTED__) && __STDC_HOSTED__ == 1
+
+    #include <mutex>
+
+    #include "efp/cpp_core.hpp"
+    #include "efp/allocator.hpp"
+    #include "efp/maybe.hpp"
+    #include "efp/string.hpp"
+    #include "efp/hash.hpp"
+
+namespace efp {
+
+// Symbol
+// Id of a string interned in a StringPool. Symbols of the same pool are equal if and only if the
+// strings are equal, so comparison and hashing are of the integer. Symbols of different pools are
+// not comparable.
+class Symbol {
+public:
+    constexpr explicit Symbol(uint32_t id) : _id(id) {}
+
+    constexpr uint32_t id() const {
+        return _id;
+    }
+
+    constexpr bool operator==(const Symbol& other) const {
+        return _id == other._id;
+    }
+
+    constexpr bool operator!=(const Symbol& other) const {
+        return _id != other._id;
+    }
+
+    // Order of interning, not of the strings
+    constexpr bool operator<(const Symbol& other) const {
+        return _id < other._id;
+    }
+
+private:
+    uint32_t _id;
+};
+
+template<>
+struct Hash<Symbol> {
+    size_t operator()(const Symbol& s) const {
+        return static_cast<size_t>(detail::hash_mix(s.id()));
+    }
+};
+
+namespace detail {
+    inline size_t string_pool_log2(size_t x) {
+    #if defined(__GNUC__) || defined(__clang__)
+        return static_cast<size_t>(63 - __builtin_clzll(static_cast<unsigned long long>(x)));
+    #else
+        size_t i = 0;
+        while (x >>= 1) {
+            ++i;
+        }
+        return i;
+    #endif
+    }
+}  // namespace detail
+
+// StringPool
+// Interns strings into arena backed storage, returning a Symbol per distinct string. Interned
+// bytes are null terminated and never move nor freed until the pool is destroyed, so the views
+// of the pool stay valid as long as the pool.
+// Lookups, both find and view, are lock free and safe concurrently with each other and with
+// intern. Interning a new string takes a mutex. Interning an existing one is a lock free lookup.
+//
+//     StringPool pool {};
+//     const Symbol a = pool.intern("key");
+//     a == pool.intern(line.substr(0, 3));  // Integer comparison
+//     pool.view(a);                         // "key"
+class StringPool {
+public:
+    explicit StringPool(size_t chunk_size = 4096)
+        : _table(nullptr), _size(0), _arena(chunk_size) {
+        for (size_t i = 0; i < max_segments; ++i) {
+            _segments[i].store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    StringPool(const StringPool&) = delete;
+
+    StringPool& operator=(const StringPool&) = delete;
+
+    template<typename As, typename = EnableIf<detail::IsStringLike<As>::value>>
+    Symbol intern(const As& s) {
+        return _intern(data(s), length(s));
+    }
+
+    Symbol intern(const char* c_str) {
+        return _intern(c_str, std::strlen(c_str));
+    }
+
+    template<typename As, typename = EnableIf<detail::IsStringLike<As>::value>>
+    Maybe<Symbol> find(const As& s) const {
+        return _find(data(s), length(s), detail::hash_bytes(data(s), length(s)));
+    }
+
+    Maybe<Symbol> find(const char* c_str) const {
+        const size_t len = std::strlen(c_str);
+        return _find(c_str, len, detail::hash_bytes(c_str, len));
+    }
+
+    template<typename As>
+    bool contains(const As& s) const {
+        return find(s).has_value();
+    }
+
+    StringView view(Symbol symbol) const {
+        const Entry& e = _entry(symbol);
+        return StringView(e.data, e.length);
+    }
+
+    const char* c_str(Symbol symbol) const {
+        return _entry(symbol).data;
+    }
+
+    // Number of distinct strings
+    size_t size() const {
+        return _size.load(std::memory_order_acquire);
+    }
+
+    // Bytes taken from the arena, including the index
+    size_t allocated() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _arena.allocated();
+    }
+
+private:
+    struct Entry {
+        const char* data;
+        size_t length;
+        uint64_t hash;
+    };
+
+    // Open addressing index of the ids. A slot is 0 if empty, or the upper half of the hash and
+    // id + 1, so that most mismatches are rejected without touching the string
+    struct Table {
+        size_t mask;
+        std::atomic<uint64_t>* slots;
+    };
+
+    // Entries are in segments of doubling sizes, which never move once published
+    static constexpr size_t segment_base_log = 6;
+    static constexpr size_t max_segments = 26;
+    static constexpr uint32_t max_size =
+        static_cast<uint32_t>(((size_t(1) << max_segments) - 1) << segment_base_log);
+
+    Symbol _intern(const char* str, size_t len) {
+        const uint64_t hash = detail::hash_bytes(str, len);
+
+        const Maybe<Symbol> found = _find(str, len, hash);
+        if (found.has_value()) {
+            return found.value();
+        }
+
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        // Another thread could have interned it in the meantime
+        const Maybe<Symbol> raced = _find(str, len, hash);
+        if (raced.has_value()) {
+            return raced.value();
+        }
+
+        const uint32_t id = _size.load(std::memory_order_relaxed);
+        if (id == max_size) {
+            throw RuntimeError("StringPool::intern: too many symbols");
+        }
+
+        char* bytes = static_cast<char*>(_arena.allocate(len + 1, 1));
+        if (len != 0) {
+            _memcpy(bytes, str, len);
+        }
+        bytes[len] = '\0';
+
+        _entry_slot(id) = Entry {bytes, len, hash};
+
+        // Keep the load factor of the table at most a half
+        Table* table = _table.load(std::memory_order_relaxed);
+        if (table == nullptr || (size_t(id) + 1) * 2 > table->mask + 1) {
+            table = _grow(table == nullptr ? 64 : (table->mask + 1) * 2, id);
+        }
+        _insert(table, id, hash, std::memory_order_release);
+
+        _size.store(id + 1, std::memory_order_release);
+        return Symbol(id);
+    }
+
+    Maybe<Symbol> _find(const char* str, size_t len, uint64_t hash) const {
+        const Table* table = _table.load(std::memory_order_acquire);
+        if (table == nullptr) {
+            return nothing;
+        }
+
+        const uint64_t tag = hash >> 32;
+        for (size_t i = static_cast<size_t>(hash) & table->mask;; i = (i + 1) & table->mask) {
+            const uint64_t slot = table->slots[i].load(std::memory_order_acquire);
+            if (slot == 0) {
+                return nothing;
+            }
+
+            if ((slot >> 32) == tag) {
+                const uint32_t id = static_cast<uint32_t>(slot) - 1;
+                const Entry& e = _entry_at(id);
+
+                if (e.length == len && (len == 0 || std::memcmp(e.data, str, len) == 0)) {
+                    return Symbol(id);
+                }
+            }
+        }
+    }
+
+    static size_t _segment_of(uint32_t id) {
+        return detail::string_pool_log2((size_t(id) >> segment_base_log) + 1);
+    }
+
+    static size_t _offset_in_segment(uint32_t id, size_t segment) {
+        return size_t(id) - (((size_t(1) << segment) - 1) << segment_base_log);
+    }
+
+    const Entry& _entry_at(uint32_t id) const {
+        const size_t segment = _segment_of(id);
+        const Entry* entries = _segments[segment].load(std::memory_order_acquire);
+        return entries[_offset_in_segment(id, segment)];
+    }
+
+    const Entry& _entry(Symbol symbol) const {
+        if (symbol.id() >= _size.load(std::memory_order_acquire)) {
+            throw RuntimeError("StringPool: unknown symbol");
+        }
+        return _entry_at(symbol.id());
+    }
+
+    // Entry to be written for a new id. Must hold the mutex
+    Entry& _entry_slot(uint32_t id) {
+        const size_t segment = _segment_of(id);
+        Entry* entries = _segments[segment].load(std::memory_order_relaxed);
+
+        if (entries == nullptr) {
+            const size_t count = size_t(1) << (segment + segment_base_log);
+            entries = static_cast<Entry*>(_arena.allocate(count * sizeof(Entry), alignof(Entry)));
+            _segments[segment].store(entries, std::memory_order_release);
+        }
+
+        return entries[_offset_in_segment(id, segment)];
+    }
+
+    static void _insert(Table* table, uint32_t id, uint64_t hash, std::memory_order order) {
+        size_t i = static_cast<size_t>(hash) & table->mask;
+        while (table->slots[i].load(std::memory_order_relaxed) != 0) {
+            i = (i + 1) & table->mask;
+        }
+        table->slots[i].store(((hash >> 32) << 32) | (uint64_t(id) + 1), order);
+    }
+
+    // Build a larger table of the first n entries and publish it. The old table is left in the
+    // arena, since concurrent lookups could still be reading it.
+    Table* _grow(size_t capacity, uint32_t n) {
+        Table* table = static_cast<Table*>(_arena.allocate(sizeof(Table), alignof(Table)));
+        table->mask = capacity - 1;
+        table->slots = static_cast<std::atomic<uint64_t>*>(_arena.allocate(
+            capacity * sizeof(std::atomic<uint64_t>),
+            alignof(std::atomic<uint64_t>)
+        ));
+
+        for (size_t i = 0; i < capacity; ++i) {
+            new (table->slots + i) std::atomic<uint64_t>(0);
+        }
+
+        for (uint32_t id = 0; id < n; ++id) {
+            _insert(table, id, _entry_at(id).hash, std::memory_order_relaxed);
+        }
+
+        _table.store(table, std::memory_order_release);
+        return table;
+    }
+
+    std::atomic<Entry*> _segments[max_segments];
+    std::atomic<Table*> _table;
+    std::atomic<uint32_t> _size;
+    mutable std::mutex _mutex;
+    MonotonicArena _arena;
+};
+
+}  // namespace efp
+
+#endif  // __STDC_HOSTED__ && __STDC_HOSTED__ == 1
+
+#endif
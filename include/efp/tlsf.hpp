@@ -0,0 +1,498 @@
+#ifndef EFP_TLSF_HPP_
+#define EFP_TLSF_HPP_
+
+#include "efp/cpp_core.hpp"
+#include "efp/meta.hpp"
+
+namespace efp {
+
+namespace detail {
+    // Index of the least significant set bit. Undefined for 0
+    inline size_t tlsf_ffs(uint32_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<size_t>(__builtin_ctz(x));
+#else
+        size_t i = 0;
+        while (!(x & 1u)) {
+            x >>= 1;
+            ++i;
+        }
+        return i;
+#endif
+    }
+
+    // Index of the most significant set bit. Undefined for 0
+    inline size_t tlsf_fls(size_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+        return 63 - static_cast<size_t>(__builtin_clzll(static_cast<unsigned long long>(x)));
+#else
+        size_t i = 0;
+        while (x >>= 1) {
+            ++i;
+        }
+        return i;
+#endif
+    }
+}  // namespace detail
+
+// Tlsf
+// Two-level segregated fit allocator over a single user supplied region.
+// allocate and deallocate are O(1) and do not depend on the number of blocks, which makes the
+// allocation time deterministic for real-time loops. Free blocks are coalesced immediately.
+// Each block carries one word of overhead. Returned memory is aligned to Tlsf::alignment.
+// Not thread-safe.
+class Tlsf {
+public:
+    static constexpr size_t alignment = sizeof(void*);
+
+    constexpr Tlsf()
+        : _fl_bitmap(0), _sl_bitmap {}, _blocks {}, _region_size(0), _used(0),
+          _high_water_mark(0) {}
+
+    Tlsf(void* region, size_t size) : Tlsf() {
+        assign(region, size);
+    }
+
+    Tlsf(const Tlsf&) = delete;
+
+    Tlsf& operator=(const Tlsf&) = delete;
+
+    // Start managing the region. Any previous region is forgotten.
+    // The region must outlive all the allocations from it.
+    void assign(void* region, size_t size) {
+        _reset();
+
+        char* begin = reinterpret_cast<char*>(_align_up(reinterpret_cast<uintptr_t>(region)));
+        const size_t lost = static_cast<size_t>(begin - static_cast<char*>(region));
+
+        if (size < lost + 2 * _overhead + _block_size_min) {
+            throw RuntimeError("Tlsf::assign: region is too small");
+        }
+
+        size_t pool_size = _align_down(size - lost - 2 * _overhead);
+        if (pool_size >= _block_size_max) {
+            pool_size = _block_size_max - alignment;
+        }
+
+        // The first block starts one word before the region. Its prev_phys is never accessed,
+        // since the previous block is marked as used.
+        Block* block = reinterpret_cast<Block*>(begin - _overhead);
+        block->size = pool_size | _free_bit;
+        _insert(block);
+
+        // Zero-sized sentinel block terminating the region
+        Block* sentinel = _link_next(block);
+        sentinel->size = _prev_free_bit;
+
+        _region_size = pool_size;
+    }
+
+    // Returns nullptr if there is no free block large enough
+    void* allocate(size_t bytes) {
+        const size_t size = _adjust(bytes);
+        if (size == 0) {
+            return nullptr;
+        }
+
+        size_t fl, sl;
+        _mapping_search(size, fl, sl);
+
+        Block* block = _find_suitable(fl, sl);
+        if (block == nullptr) {
+            return nullptr;
+        }
+
+        _remove(block, fl, sl);
+        _trim(block, size);
+        _mark_used(block);
+
+        _used += _size_of(block);
+        if (_used > _high_water_mark) {
+            _high_water_mark = _used;
+        }
+
+        return _to_ptr(block);
+    }
+
+    void deallocate(void* p) {
+        if (p == nullptr) {
+            return;
+        }
+
+        Block* block = _from_ptr(p);
+        _used -= _size_of(block);
+
+        _mark_free(block);
+        block = _merge_prev(block);
+        block = _merge_next(block);
+        _insert(block);
+    }
+
+    // Usable bytes of the managed region
+    size_t region_size() const {
+        return _region_size;
+    }
+
+    // Bytes currently allocated, including rounding
+    size_t used() const {
+        return _used;
+    }
+
+    // Peak of used() since assign or reset_high_water_mark
+    size_t high_water_mark() const {
+        return _high_water_mark;
+    }
+
+    void reset_high_water_mark() {
+        _high_water_mark = _used;
+    }
+
+    // Size of the largest free block. Requests are rounded up to the next size class, so the
+    // largest request guaranteed to succeed is somewhat smaller.
+    size_t largest_free_block() const {
+        if (_fl_bitmap == 0) {
+            return 0;
+        }
+
+        const size_t fl = detail::tlsf_fls(_fl_bitmap);
+        const size_t sl = detail::tlsf_fls(_sl_bitmap[fl]);
+
+        size_t largest = 0;
+        for (const Block* b = _blocks[fl][sl]; b; b = b->next_free) {
+            if (_size_of(b) > largest) {
+                largest = _size_of(b);
+            }
+        }
+
+        return largest;
+    }
+
+    // 0 if the free space is a single block, approaching 1 as it is split into small pieces
+    double fragmentation() const {
+        const size_t free_bytes = _free_bytes();
+        return free_bytes == 0
+            ? 0.
+            : 1. - static_cast<double>(largest_free_block()) / static_cast<double>(free_bytes);
+    }
+
+private:
+    struct Block {
+        // Valid only if the previous physical block is free. Overlaps the previous payload.
+        Block* prev_phys;
+        // Payload size. The lowest two bits are the flags
+        size_t size;
+        // Valid only if the block is free
+        Block* next_free;
+        Block* prev_free;
+    };
+
+    static constexpr size_t _sl_log2 = 4;
+    static constexpr size_t _sl_count = 1 << _sl_log2;
+    static constexpr size_t _align_log2 = sizeof(void*) == 8 ? 3 : 2;
+    static constexpr size_t _fl_shift = _sl_log2 + _align_log2;
+    static constexpr size_t _fl_max = sizeof(size_t) == 8 ? 32 : 30;
+    static constexpr size_t _fl_count = _fl_max - _fl_shift + 1;
+    static constexpr size_t _small_block_size = 1 << _fl_shift;
+
+    static constexpr size_t _free_bit = 1;
+    static constexpr size_t _prev_free_bit = 2;
+
+    static constexpr size_t _overhead = sizeof(size_t);
+    static constexpr size_t _block_size_min = sizeof(Block) - sizeof(Block*);
+    static constexpr size_t _block_size_max = size_t(1) << _fl_max;
+
+    void _reset() {
+        _fl_bitmap = 0;
+        for (size_t i = 0; i < _fl_count; ++i) {
+            _sl_bitmap[i] = 0;
+            for (size_t j = 0; j < _sl_count; ++j) {
+                _blocks[i][j] = nullptr;
+            }
+        }
+        _region_size = 0;
+        _used = 0;
+        _high_water_mark = 0;
+    }
+
+    static uintptr_t _align_up(uintptr_t x) {
+        return (x + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+    }
+
+    static size_t _align_down(size_t x) {
+        return x & ~(alignment - 1);
+    }
+
+    static size_t _size_of(const Block* b) {
+        return b->size & ~(_free_bit | _prev_free_bit);
+    }
+
+    static void _set_size(Block* b, size_t size) {
+        b->size = size | (b->size & (_free_bit | _prev_free_bit));
+    }
+
+    static void* _to_ptr(Block* b) {
+        return reinterpret_cast<char*>(b) + offsetof(Block, size) + sizeof(size_t);
+    }
+
+    static Block* _from_ptr(void* p) {
+        return reinterpret_cast<Block*>(
+            static_cast<char*>(p) - offsetof(Block, size) - sizeof(size_t)
+        );
+    }
+
+    static Block* _next(Block* b) {
+        return reinterpret_cast<Block*>(static_cast<char*>(_to_ptr(b)) + _size_of(b) - _overhead);
+    }
+
+    static Block* _link_next(Block* b) {
+        Block* next = _next(b);
+        next->prev_phys = b;
+        return next;
+    }
+
+    static void _mark_free(Block* b) {
+        Block* next = _link_next(b);
+        next->size |= _prev_free_bit;
+        b->size |= _free_bit;
+    }
+
+    static void _mark_used(Block* b) {
+        _next(b)->size &= ~_prev_free_bit;
+        b->size &= ~_free_bit;
+    }
+
+    // Round up the request to the block granularity. Returns 0 for unserviceable requests
+    static size_t _adjust(size_t bytes) {
+        if (bytes == 0 || bytes >= _block_size_max) {
+            return 0;
+        }
+
+        const size_t aligned = static_cast<size_t>(_align_up(bytes));
+        return aligned < _block_size_min ? _block_size_min : aligned;
+    }
+
+    static void _mapping_insert(size_t size, size_t& fl, size_t& sl) {
+        if (size < _small_block_size) {
+            fl = 0;
+            sl = size / (_small_block_size / _sl_count);
+        } else {
+            const size_t f = detail::tlsf_fls(size);
+            sl = (size >> (f - _sl_log2)) ^ _sl_count;
+            fl = f - (_fl_shift - 1);
+        }
+    }
+
+    // Round up to the next list, so that any block of the list found is large enough
+    static void _mapping_search(size_t size, size_t& fl, size_t& sl) {
+        if (size >= _small_block_size) {
+            size += (size_t(1) << (detail::tlsf_fls(size) - _sl_log2)) - 1;
+        }
+        _mapping_insert(size, fl, sl);
+    }
+
+    Block* _find_suitable(size_t& fl, size_t& sl) const {
+        if (fl >= _fl_count) {
+            return nullptr;
+        }
+
+        uint32_t sl_map = _sl_bitmap[fl] & (~uint32_t(0) << sl);
+
+        if (sl_map == 0) {
+            const uint32_t fl_map = fl + 1 < 32 ? _fl_bitmap & (~uint32_t(0) << (fl + 1)) : 0;
+            if (fl_map == 0) {
+                return nullptr;
+            }
+
+            fl = detail::tlsf_ffs(fl_map);
+            sl_map = _sl_bitmap[fl];
+        }
+
+        sl = detail::tlsf_ffs(sl_map);
+        return _blocks[fl][sl];
+    }
+
+    void _insert(Block* b) {
+        size_t fl, sl;
+        _mapping_insert(_size_of(b), fl, sl);
+
+        Block* head = _blocks[fl][sl];
+        b->next_free = head;
+        b->prev_free = nullptr;
+        if (head) {
+            head->prev_free = b;
+        }
+
+        _blocks[fl][sl] = b;
+        _fl_bitmap |= uint32_t(1) << fl;
+        _sl_bitmap[fl] |= uint32_t(1) << sl;
+    }
+
+    void _remove(Block* b, size_t fl, size_t sl) {
+        if (b->next_free) {
+            b->next_free->prev_free = b->prev_free;
+        }
+
+        if (b->prev_free) {
+            b->prev_free->next_free = b->next_free;
+        } else {
+            _blocks[fl][sl] = b->next_free;
+
+            if (b->next_free == nullptr) {
+                _sl_bitmap[fl] &= ~(uint32_t(1) << sl);
+                if (_sl_bitmap[fl] == 0) {
+                    _fl_bitmap &= ~(uint32_t(1) << fl);
+                }
+            }
+        }
+    }
+
+    void _remove(Block* b) {
+        size_t fl, sl;
+        _mapping_insert(_size_of(b), fl, sl);
+        _remove(b, fl, sl);
+    }
+
+    // Split off the remainder of the block as a new free block if it is large enough
+    void _trim(Block* b, size_t size) {
+        if (_size_of(b) < sizeof(Block) + size) {
+            return;
+        }
+
+        Block* rest = reinterpret_cast<Block*>(static_cast<char*>(_to_ptr(b)) + size - _overhead);
+        rest->size = _size_of(b) - (size + _overhead);
+        _set_size(b, size);
+
+        _link_next(b);
+        _mark_free(rest);
+        rest->size |= _prev_free_bit;
+        _insert(rest);
+    }
+
+    Block* _merge_prev(Block* b) {
+        if (!(b->size & _prev_free_bit)) {
+            return b;
+        }
+
+        Block* prev = b->prev_phys;
+        _remove(prev);
+        _set_size(prev, _size_of(prev) + _size_of(b) + _overhead);
+        _link_next(prev);
+        return prev;
+    }
+
+    Block* _merge_next(Block* b) {
+        Block* next = _next(b);
+        if (!(next->size & _free_bit)) {
+            return b;
+        }
+
+        _remove(next);
+        _set_size(b, _size_of(b) + _size_of(next) + _overhead);
+        _link_next(b);
+        return b;
+    }
+
+    size_t _free_bytes() const {
+        size_t free_bytes = 0;
+        for (size_t i = 0; i < _fl_count; ++i) {
+            for (size_t j = 0; j < _sl_count; ++j) {
+                for (const Block* b = _blocks[i][j]; b; b = b->next_free) {
+                    free_bytes += _size_of(b);
+                }
+            }
+        }
+        return free_bytes;
+    }
+
+    uint32_t _fl_bitmap;
+    uint32_t _sl_bitmap[_fl_count];
+    Block* _blocks[_fl_count][_sl_count];
+    size_t _region_size;
+    size_t _used;
+    size_t _high_water_mark;
+};
+
+// default_tlsf
+// Instance used by default constructed TlsfAllocator. Must be given a region by
+// default_tlsf().assign(region, size) before the first allocation.
+// Constant initialized, so there is no static initialization order problem.
+inline Tlsf& default_tlsf() {
+    static Tlsf tlsf;
+    return tlsf;
+}
+
+// TlsfAllocator
+// Allocator adaptor of Tlsf. Default constructed one uses default_tlsf().
+// Define EFP_DEFAULT_ALLOCATOR_TLSF to make it the default allocator of Vector and String on
+// freestanding environments.
+template<typename A>
+class TlsfAllocator {
+public:
+    static_assert(alignof(A) <= Tlsf::alignment, "Tlsf does not support over-aligned types");
+
+    using value_type = A;
+    using pointer = A*;
+    using const_pointer = const A*;
+    using reference = A&;
+    using const_reference = const A&;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+
+    template<typename B>
+    struct rebind {
+        using other = TlsfAllocator<B>;
+    };
+
+    TlsfAllocator() noexcept : _tlsf(&default_tlsf()) {}
+
+    TlsfAllocator(Tlsf& tlsf) noexcept : _tlsf(&tlsf) {}
+
+    template<typename B>
+    TlsfAllocator(const TlsfAllocator<B>& other) noexcept : _tlsf(other.tlsf()) {}
+
+    pointer allocate(size_type n) {
+        void* p = _tlsf->allocate(n * sizeof(A));
+        if (p == nullptr) {
+            throw RuntimeError("TlsfAllocator::allocate: out of memory");
+        }
+        return static_cast<pointer>(p);
+    }
+
+    void deallocate(pointer p, size_type) {
+        _tlsf->deallocate(p);
+    }
+
+    size_type max_size() const noexcept {
+        return _tlsf->region_size() / sizeof(A);
+    }
+
+    template<typename... Args>
+    void construct(pointer p, Args&&... args) {
+        new (p) A(efp::forward<Args>(args)...);
+    }
+
+    void destroy(pointer p) {
+        p->~A();
+    }
+
+    Tlsf* tlsf() const noexcept {
+        return _tlsf;
+    }
+
+private:
+    Tlsf* _tlsf;
+};
+
+template<typename A, typename B>
+bool operator==(const TlsfAllocator<A>& lhs, const TlsfAllocator<B>& rhs) {
+    return lhs.tlsf() == rhs.tlsf();
+}
+
+template<typename A, typename B>
+bool operator!=(const TlsfAllocator<A>& lhs, const TlsfAllocator<B>& rhs) {
+    return lhs.tlsf() != rhs.tlsf();
+}
+
+}  // namespace efp
+
+#endif
@@ -0,0 +1,309 @@
+#ifndef EFP_TRACKING_HPP_
+#define EFP_TRACKING_HPP_
+
+// ! Not for freestanding environments
+#if defined(__STDC_HOSTED__) && __STDC_HOSTED__ == 1
+
+    #include <cstdlib>
+
+    #include "efp/cpp_core.hpp"
+    #include "efp/allocator.hpp"
+    #include "efp/sequence.hpp"
+
+namespace efp {
+
+// AllocationStats
+struct AllocationStats {
+    size_t allocations;
+    size_t deallocations;
+    size_t bytes;  // Total bytes ever allocated
+    size_t live_bytes;
+    size_t peak_live_bytes;
+};
+
+// AllocationScope
+// Tags the allocations of the current thread while alive. Scopes nest, and an allocation is
+// counted in every enclosing scope of the thread.
+//
+//     AllocationScope scope {"map"};
+//     const auto bs = map(f, as);
+//     scope.stats().allocations;
+class AllocationScope {
+public:
+    explicit AllocationScope(const char* tag)
+        : _tag(tag), _stats {0, 0, 0, 0, 0}, _parent(_head()) {
+        _head() = this;
+    }
+
+    AllocationScope(const AllocationScope&) = delete;
+
+    AllocationScope& operator=(const AllocationScope&) = delete;
+
+    ~AllocationScope() {
+        _head() = _parent;
+    }
+
+    const char* tag() const {
+        return _tag;
+    }
+
+    const AllocationStats& stats() const {
+        return _stats;
+    }
+
+    // Innermost scope of the current thread. nullptr if there is none.
+    static AllocationScope* current() {
+        return _head();
+    }
+
+    static void record_allocation(size_t bytes) {
+        for (AllocationScope* s = _head(); s; s = s->_parent) {
+            ++s->_stats.allocations;
+            s->_stats.bytes += bytes;
+            s->_stats.live_bytes += bytes;
+            if (s->_stats.live_bytes > s->_stats.peak_live_bytes) {
+                s->_stats.peak_live_bytes = s->_stats.live_bytes;
+            }
+        }
+    }
+
+    // Live bytes could go below zero in a scope for memory allocated before entering it.
+    // Such deallocations are counted but do not reduce live bytes.
+    static void record_deallocation(size_t bytes) {
+        for (AllocationScope* s = _head(); s; s = s->_parent) {
+            ++s->_stats.deallocations;
+            s->_stats.live_bytes = s->_stats.live_bytes < bytes ? 0 : s->_stats.live_bytes - bytes;
+        }
+    }
+
+private:
+    static AllocationScope*& _head() {
+        thread_local AllocationScope* head = nullptr;
+        return head;
+    }
+
+    const char* _tag;
+    AllocationStats _stats;
+    AllocationScope* _parent;
+};
+
+namespace detail {
+    struct GlobalAllocationCounters {
+        std::atomic<size_t> allocations;
+        std::atomic<size_t> deallocations;
+        std::atomic<size_t> bytes;
+        std::atomic<size_t> live_bytes;
+        std::atomic<size_t> peak_live_bytes;
+    };
+
+    inline GlobalAllocationCounters& global_allocation_counters() {
+        static GlobalAllocationCounters counters {{0}, {0}, {0}, {0}, {0}};
+        return counters;
+    }
+}  // namespace detail
+
+// record_allocation
+// Count an allocation in the process wide counters and in the scopes of the current thread
+inline void record_allocation(size_t bytes) {
+    detail::GlobalAllocationCounters& c = detail::global_allocation_counters();
+
+    c.allocations.fetch_add(1, std::memory_order_relaxed);
+    c.bytes.fetch_add(bytes, std::memory_order_relaxed);
+
+    const size_t live = c.live_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    size_t peak = c.peak_live_bytes.load(std::memory_order_relaxed);
+    while (live > peak
+           && !c.peak_live_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+
+    AllocationScope::record_allocation(bytes);
+}
+
+// record_deallocation
+inline void record_deallocation(size_t bytes) {
+    detail::GlobalAllocationCounters& c = detail::global_allocation_counters();
+
+    c.deallocations.fetch_add(1, std::memory_order_relaxed);
+    c.live_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+
+    AllocationScope::record_deallocation(bytes);
+}
+
+// global_allocation_stats
+// Snapshot of the process wide counters. Each counter is read atomically, but not all of them
+// together.
+inline AllocationStats global_allocation_stats() {
+    const detail::GlobalAllocationCounters& c = detail::global_allocation_counters();
+
+    return AllocationStats {
+        c.allocations.load(std::memory_order_relaxed),
+        c.deallocations.load(std::memory_order_relaxed),
+        c.bytes.load(std::memory_order_relaxed),
+        c.live_bytes.load(std::memory_order_relaxed),
+        c.peak_live_bytes.load(std::memory_order_relaxed),
+    };
+}
+
+// TrackingAllocator
+// Records every allocation through the Inner allocator with record_allocation.
+// Combined with EFP_TRACK_GLOBAL_NEW, allocations of a heap backed Inner are counted twice.
+template<typename A, typename Inner = detail::DefaultAllocator<A>>
+class TrackingAllocator {
+public:
+    using value_type = A;
+    using pointer = A*;
+    using const_pointer = const A*;
+    using reference = A&;
+    using const_reference = const A&;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using inner_allocator_type = Inner;
+
+    template<typename B>
+    struct rebind {
+        using other =
+            TrackingAllocator<B, typename AllocatorTraits<Inner>::template rebind_alloc<B>>;
+    };
+
+    TrackingAllocator() : _inner() {}
+
+    explicit TrackingAllocator(const Inner& inner) : _inner(inner) {}
+
+    template<typename B, typename InnerB>
+    TrackingAllocator(const TrackingAllocator<B, InnerB>& other) : _inner(other.inner()) {}
+
+    pointer allocate(size_type n) {
+        pointer p = AllocatorTraits<Inner>::allocate(_inner, n);
+        record_allocation(n * sizeof(A));
+        return p;
+    }
+
+    void deallocate(pointer p, size_type n) {
+        record_deallocation(n * sizeof(A));
+        AllocatorTraits<Inner>::deallocate(_inner, p, n);
+    }
+
+    size_type max_size() const noexcept {
+        return AllocatorTraits<Inner>::max_size(_inner);
+    }
+
+    template<typename... Args>
+    void construct(pointer p, Args&&... args) {
+        AllocatorTraits<Inner>::construct(_inner, p, efp::forward<Args>(args)...);
+    }
+
+    void destroy(pointer p) {
+        AllocatorTraits<Inner>::destroy(_inner, p);
+    }
+
+    const Inner& inner() const {
+        return _inner;
+    }
+
+private:
+    Inner _inner;
+};
+
+template<typename A, typename InnerA, typename B, typename InnerB>
+bool operator==(
+    const TrackingAllocator<A, InnerA>& lhs,
+    const TrackingAllocator<B, InnerB>& rhs
+) {
+    return lhs.inner() == rhs.inner();
+}
+
+template<typename A, typename InnerA, typename B, typename InnerB>
+bool operator!=(
+    const TrackingAllocator<A, InnerA>& lhs,
+    const TrackingAllocator<B, InnerB>& rhs
+) {
+    return lhs.inner() != rhs.inner();
+}
+
+}  // namespace efp
+
+// EFP_TRACK_GLOBAL_NEW
+// Define in exactly one translation unit before including this header to replace the global
+// operator new and delete with ones calling record_allocation and record_deallocation.
+// Then allocations of any allocator, including std::allocator, show up in AllocationScope.
+// Over-aligned new and delete of C++17 are not replaced.
+    #if defined(EFP_TRACK_GLOBAL_NEW)
+
+namespace efp {
+namespace detail {
+    // Size of the allocation is stashed in front of the block, keeping max_align_t alignment
+    constexpr size_t tracking_header_size = alignof(std::max_align_t);
+
+    inline void* tracked_new(size_t size) {
+        void* raw = std::malloc(size + tracking_header_size);
+        if (raw == nullptr) {
+            return nullptr;
+        }
+
+        *static_cast<size_t*>(raw) = size;
+        record_allocation(size);
+        return static_cast<char*>(raw) + tracking_header_size;
+    }
+
+    inline void tracked_delete(void* p) noexcept {
+        if (p == nullptr) {
+            return;
+        }
+
+        void* raw = static_cast<char*>(p) - tracking_header_size;
+        record_deallocation(*static_cast<size_t*>(raw));
+        std::free(raw);
+    }
+}  // namespace detail
+}  // namespace efp
+
+void* operator new(size_t size) {
+    void* p = efp::detail::tracked_new(size);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    return efp::detail::tracked_new(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return efp::detail::tracked_new(size);
+}
+
+void operator delete(void* p) noexcept {
+    efp::detail::tracked_delete(p);
+}
+
+void operator delete[](void* p) noexcept {
+    efp::detail::tracked_delete(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+    efp::detail::tracked_delete(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+    efp::detail::tracked_delete(p);
+}
+
+// Sized delete of C++14. Defined regardless of the standard, since the other translation units
+// and the standard library could be compiled with it
+void operator delete(void* p, size_t) noexcept {
+    efp::detail::tracked_delete(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+    efp::detail::tracked_delete(p);
+}
+
+    #endif  // EFP_TRACK_GLOBAL_NEW
+
+#endif  // __STDC_HOSTED__ && __STDC_HOSTED__ == 1
+
+#endif
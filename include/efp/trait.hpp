@@ -45,6 +45,17 @@ struct CtCapacityImpl {
 template<typename A>
 using CtCapacity = typename CtCapacityImpl<CVRefRemoved<A>>::Type;
 
+// CtAlign
+// Should be IntegralConstant<size_t> with compile time alignment of the element storage.
+// Defaults to the natural alignment of the element
+template<typename A>
+struct CtAlignImpl {
+    using Type = Size<alignof(Element<A>)>;
+};
+
+template<typename A>
+using CtAlign = typename CtAlignImpl<CVRefRemoved<A>>::Type;
+
 template<typename As, size_t n, typename = Void<CtSize<As>>>
 constexpr auto length(const As&) -> CtSize<As> {
     static_assert(AlwaysFalse<As>::value, "length is not implemented for the type");
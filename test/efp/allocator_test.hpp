@@ -0,0 +1,288 @@
+#ifndef ALLOCATOR_TEST_HPP_
+#define ALLOCATOR_TEST_HPP_
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "efp.hpp"
+#include "test_common.hpp"
+
+using namespace efp;
+
+TEST_CASE("AlignedAllocator", "[AlignedAllocator]") {
+    SECTION("allocate") {
+        AlignedAllocator<float, 64> alloc {};
+
+        for (size_t n = 1; n < 100; n += 7) {
+            float* p = alloc.allocate(n);
+            CHECK(is_aligned(p, 64));
+            alloc.deallocate(p, n);
+        }
+    }
+
+    SECTION("rebind") {
+        using Rebound = AllocatorTraits<AlignedAllocator<float, 32>>::rebind_alloc<double>;
+        CHECK(IsSame<Rebound, AlignedAllocator<double, 32>>::value);
+    }
+
+    SECTION("AllocatorAlign") {
+        CHECK(AllocatorAlign<AlignedAllocator<float, 64>>::value == 64);
+        CHECK(AllocatorAlign<detail::DefaultAllocator<float>>::value == alignof(float));
+    }
+
+    SECTION("Vector") {
+        Vector<float, AlignedAllocator<float, 64>> as {1.f, 2.f, 3.f};
+        CHECK(is_aligned(as.data(), 64));
+
+        for (int i = 0; i < 100; ++i) {
+            as.push_back(static_cast<float>(i));
+            CHECK(is_aligned(as.data(), 64));
+        }
+
+        CHECK(as.size() == 103);
+        CHECK(as[2] == 3.f);
+        CHECK(as[102] == 99.f);
+        CHECK(CtAlign<decltype(as)>::value == 64);
+    }
+
+    SECTION("Vector of RAII elements") {
+        MockHW::reset();
+        {
+            Vector<MockRaii, AlignedAllocator<MockRaii, 64>> as {};
+            as.push_back(MockRaii {});
+            as.push_back(MockRaii {});
+            CHECK(MockHW::remaining_resource_count() == 2);
+
+            const auto bs = as;
+            CHECK(MockHW::remaining_resource_count() == 4);
+        }
+        CHECK(MockHW::is_sound());
+    }
+}
+
+TEST_CASE("Aligned RawStorage", "[RawStorage]") {
+    SECTION("Array") {
+        Array<float, 5, 32> as {1.f, 2.f, 3.f, 4.f, 5.f};
+        CHECK(is_aligned(data(as), 32));
+        CHECK(alignof(decltype(as)) == 32);
+        CHECK(CtAlign<decltype(as)>::value == 32);
+        CHECK(length(as) == 5);
+        CHECK(nth(4, as) == 5.f);
+    }
+
+    SECTION("ArrVec") {
+        ArrVec<double, 8, 64> as {1., 2., 3.};
+        CHECK(is_aligned(data(as), 64));
+        CHECK(CtAlign<decltype(as)>::value == 64);
+        CHECK(length(as) == 3);
+    }
+
+    SECTION("Default alignment") {
+        CHECK(CtAlign<Array<double, 3>>::value == alignof(double));
+        CHECK(CtAlign<ArrVec<double, 3>>::value == alignof(double));
+        CHECK(CtAlign<Vector<double>>::value == alignof(double));
+        CHECK(CtAlign<VectorView<const double>>::value == alignof(double));
+    }
+
+    SECTION("Conversion to Vector") {
+        const Array<double, 3, 64> as {1., 2., 3.};
+        const Vector<double> bs {as};
+        CHECK(bs == vector_3);
+    }
+}
+
+TEST_CASE("MonotonicArena", "[MonotonicArena]") {
+    SECTION("buffer") {
+        alignas(64) char buffer[256];
+        MonotonicArena arena {buffer, sizeof(buffer)};
+
+        void* p = arena.allocate(10, 1);
+        CHECK(p == buffer);
+
+        void* q = arena.allocate(8, 8);
+        CHECK(is_aligned(q, 8));
+        CHECK(static_cast<char*>(q) >= buffer + 10);
+        CHECK(arena.chunk_count() == 0);
+        CHECK(arena.allocated() == 18);
+    }
+
+    SECTION("overflow to heap") {
+        char buffer[16];
+        MonotonicArena arena {buffer, sizeof(buffer), 64};
+
+        arena.allocate(16, 1);
+        CHECK(arena.chunk_count() == 0);
+
+        void* p = arena.allocate(32, 16);
+        CHECK(is_aligned(p, 16));
+        CHECK(arena.chunk_count() == 1);
+
+        // Larger than the next chunk size
+        arena.allocate(1000, 8);
+        CHECK(arena.chunk_count() == 2);
+    }
+
+    SECTION("release") {
+        char buffer[32];
+        MonotonicArena arena {buffer, sizeof(buffer)};
+
+        arena.allocate(100, 8);
+        CHECK(arena.chunk_count() == 1);
+
+        arena.release();
+        CHECK(arena.chunk_count() == 0);
+        CHECK(arena.allocated() == 0);
+        CHECK(arena.allocate(4, 1) == buffer);
+    }
+}
+
+TEST_CASE("ArenaAllocator", "[ArenaAllocator]") {
+    MonotonicArena arena {};
+    const ArenaAllocator<int> alloc {arena};
+
+    SECTION("equality") {
+        MonotonicArena other {};
+        CHECK(alloc == ArenaAllocator<double>(arena));
+        CHECK(alloc != ArenaAllocator<int>(other));
+    }
+
+    SECTION("Vector") {
+        Vector<int, ArenaAllocator<int>> as {alloc};
+        for (int i = 0; i < 100; ++i) {
+            as.push_back(i);
+        }
+
+        CHECK(as.size() == 100);
+        CHECK(as[99] == 99);
+        CHECK(as.get_allocator() == alloc);
+        CHECK(arena.allocated() > 0);
+    }
+
+    SECTION("Vector constructors") {
+        const Vector<int, ArenaAllocator<int>> as {{1, 2, 3}, alloc};
+        CHECK(as.get_allocator() == alloc);
+        CHECK(as.size() == 3);
+
+        const Vector<int, ArenaAllocator<int>> bs {Array<int, 3> {1, 2, 3}, alloc};
+        CHECK(bs == as);
+
+        const Vector<int, ArenaAllocator<int>> cs {ArrVec<int, 3> {1, 2, 3}, alloc};
+        CHECK(cs == as);
+    }
+
+    SECTION("Vector copy and move") {
+        const Vector<int, ArenaAllocator<int>> as {{1, 2, 3}, alloc};
+
+        const auto bs = as;
+        CHECK(bs == as);
+        CHECK(bs.get_allocator() == alloc);
+
+        MonotonicArena other {};
+        Vector<int, ArenaAllocator<int>> cs {{4, 5}, ArenaAllocator<int>(other)};
+        cs = as;
+        CHECK(cs == as);
+        // Allocator is not propagated on copy assignment
+        CHECK(cs.get_allocator() == ArenaAllocator<int>(other));
+
+        Vector<int, ArenaAllocator<int>> ds {ArenaAllocator<int>(other)};
+        ds = efp::move(cs);
+        CHECK(ds == as);
+        CHECK(ds.get_allocator() == ArenaAllocator<int>(other));
+    }
+
+    SECTION("Vector of RAII elements") {
+        MockHW::reset();
+        {
+            Vector<MockRaii, ArenaAllocator<MockRaii>> as {ArenaAllocator<MockRaii>(arena)};
+            as.push_back(MockRaii {});
+            as.push_back(MockRaii {});
+            as.push_back(MockRaii {});
+
+            const auto bs = as;
+            CHECK(MockHW::remaining_resource_count() == 6);
+        }
+        CHECK(MockHW::is_sound());
+    }
+
+    SECTION("String") {
+        using ArenaString = BasicString<char, detail::DefaultCharTraits<char>, ArenaAllocator<char>>;
+        const ArenaAllocator<char> char_alloc {arena};
+
+        const ArenaString a {"Hello, world", char_alloc};
+        CHECK(a.size() == 12);
+        CHECK(a.get_allocator() == char_alloc);
+
+        const ArenaString b {"Hello", 5, char_alloc};
+        CHECK(b == ArenaString("Hello", char_alloc));
+
+        const ArenaString c {3, 'x', char_alloc};
+        CHECK(c == ArenaString("xxx", char_alloc));
+
+        const ArenaString d = a.substr(7, 5);
+        CHECK(d == ArenaString("world", char_alloc));
+        CHECK(d.get_allocator() == char_alloc);
+    }
+}
+
+TEST_CASE("HugePageAllocator", "[HugePageAllocator]") {
+    SECTION("below threshold") {
+        HugePageAllocator<double> alloc {};
+        double* p = alloc.allocate(100);
+        CHECK(alloc.mode() == HugePageMode::None);
+        p[99] = 1.;
+        alloc.deallocate(p, 100);
+    }
+
+    SECTION("above threshold") {
+        HugePageAllocator<double, 1024> alloc {};
+        const size_t n = huge_page_size / sizeof(double) + 1;
+
+        double* p = alloc.allocate(n);
+        if (alloc.mode() != HugePageMode::None) {
+            CHECK(is_aligned(p, huge_page_size));
+        }
+
+        p[0] = 1.;
+        p[n - 1] = 2.;
+        CHECK(p[0] + p[n - 1] == 3.);
+        alloc.deallocate(p, n);
+    }
+
+    SECTION("Vector") {
+        Vector<double, HugePageAllocator<double, 1024 * 1024>> as {};
+        for (size_t i = 0; i < 1024 * 1024; ++i) {
+            as.push_back(static_cast<double>(i));
+        }
+
+        CHECK(as[1024 * 1024 - 1] == 1024. * 1024. - 1.);
+        CHECK(sum(as) == 1024. * 1024. * (1024. * 1024. - 1.) / 2.);
+    }
+}
+
+TEST_CASE("Vector copy assignment", "[Vector]") {
+    SECTION("to larger") {
+        Vector<double> as {1., 2., 3., 4., 5.};
+        as = vector_3;
+        CHECK(as == vector_3);
+        CHECK(as.size() == 3);
+    }
+
+    SECTION("to smaller") {
+        Vector<int> as {1};
+        const Vector<int> bs {1, 2, 3, 4, 5};
+        as = bs;
+        CHECK(as == bs);
+        CHECK(as.size() == 5);
+    }
+
+    SECTION("from empty") {
+        Vector<int> as {1, 2};
+        const Vector<int> bs {};
+        as = bs;
+        CHECK(as.empty());
+
+        const Vector<int> cs = bs;
+        CHECK(cs.empty());
+    }
+}
+
+#endif
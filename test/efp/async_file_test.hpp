@@ -0,0 +1,167 @@
+#ifndef ASYNC_FILE_TEST_HPP_
+#define ASYNC_FILE_TEST_HPP_
+
+#include <cstdio>
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "efp.hpp"
+#include "test_common.hpp"
+
+using namespace efp;
+
+// Writes blocks at their offsets, reads them back in place and through the fixed path
+inline void check_io_queue(IoBackend backend) {
+    const char* path = "efp_async_file_test.bin";
+    const size_t blocks = 16;
+    const size_t block_size = 4096;
+
+    IoQueue io {8, backend, 3};
+    CHECK(io.backend() == backend);
+
+    Vector<char> data {};
+    for (size_t i = 0; i < blocks * block_size; ++i) {
+        data.push_back(static_cast<char>('a' + (i / block_size + i) % 26));
+    }
+
+    {
+        auto file = AsyncFile::open(path, "w").move();
+
+        // The depth bounds the requests queued and in flight
+        size_t next = 0;
+        size_t written = 0;
+        IoCompletion done[4];
+
+        while (written < blocks) {
+            while (next < blocks
+                   && io.write(file, data.data() + next * block_size, block_size,
+                               next * block_size, next)) {
+                ++next;
+            }
+            CHECK(io.queued() + io.in_flight() <= io.depth());
+
+            const size_t n = io.wait(done, 4);
+            for (size_t i = 0; i < n; ++i) {
+                CHECK(done[i].result == int64_t(block_size));
+                ++written;
+            }
+        }
+
+        CHECK(io.in_flight() == 0);
+        CHECK(file.size() == blocks * block_size);
+    }
+
+    SECTION("read") {
+        auto file = AsyncFile::open(path, "r").move();
+        Vector<char> back {};
+        back.resize(blocks * block_size);
+
+        for (size_t i = 0; i < 8; ++i) {
+            CHECK(io.read(file, back.data() + i * block_size, block_size, i * block_size, i));
+        }
+        CHECK_FALSE(io.read(file, back.data(), block_size, 0, 99));
+        CHECK(io.submit() == 8);
+
+        // Completions arrive in any order
+        IoCompletion done[8];
+        size_t seen = 0;
+        while (io.in_flight() != 0) {
+            const size_t n = io.wait(done, 8, 8);
+            for (size_t i = 0; i < n; ++i) {
+                CHECK(done[i].result == int64_t(block_size));
+                seen |= size_t(1) << done[i].user_data;
+            }
+        }
+        CHECK(seen == 0xff);
+        CHECK(std::memcmp(back.data(), data.data(), 8 * block_size) == 0);
+
+        // A read past the end is short, and one of a closed file fails with its errno
+        char tail[16];
+        CHECK(io.read(file, tail, sizeof(tail), blocks * block_size - 4, 0));
+        AsyncFile closed = AsyncFile::open(path, "r").move();
+        const int fd = closed.fd();
+        closed.close();
+        CHECK(fd >= 0);
+        CHECK(io.read(closed, tail, sizeof(tail), 0, 1));
+
+        NonBlockingQ<IoCompletion> queue {};
+        io.submit();
+        while (io.in_flight() != 0) {
+            io.poll(queue);
+        }
+
+        int64_t results[2] = {0, 0};
+        for (int i = 0; i < 2; ++i) {
+            const IoCompletion completion = queue.dequeue().value();
+            results[completion.user_data] = completion.result;
+        }
+        CHECK(results[0] == 4);
+        CHECK(results[1] == -EBADF);
+        CHECK(queue.dequeue().is_nothing());
+    }
+
+    SECTION("fixed files and buffers") {
+        Vector<AsyncFile> files {};
+        files.push_back(AsyncFile::open(path, "r").move());
+        files.push_back(AsyncFile::open(path, "r+").move());
+
+        Vector<Vector<char>> buffers {};
+        for (int i = 0; i < 2; ++i) {
+            Vector<char> buffer {};
+            buffer.resize(block_size);
+            buffers.push_back(efp::move(buffer));
+        }
+
+        CHECK(io.register_files(files));
+        CHECK(io.register_buffers(buffers));
+        CHECK_THROWS(io.read_fixed(2, 0, block_size, 0, 0));
+        CHECK_THROWS(io.read_fixed(0, 0, block_size + 1, 0, 0));
+
+        CHECK(io.read_fixed(0, 0, block_size, 3 * block_size, 0));
+        CHECK(io.read_fixed(0, 1, 100, 5 * block_size, 1));
+
+        // Registration is refused while requests are pending
+        CHECK_FALSE(io.register_files(files));
+
+        IoCompletion done[2];
+        CHECK(io.wait(done, 2, 2) == 2);
+        CHECK(std::memcmp(buffers[0].data(), data.data() + 3 * block_size, block_size) == 0);
+        CHECK(std::memcmp(buffers[1].data(), data.data() + 5 * block_size, 100) == 0);
+
+        // Writes the first buffer over the first block through the second file
+        CHECK(io.write_fixed(1, 0, block_size, 0, 2));
+        CHECK(io.wait(done, 2) == 1);
+        CHECK(done[0].user_data == 2);
+        CHECK(done[0].result == int64_t(block_size));
+
+        char check[block_size];
+        CHECK(io.read(files[0], check, block_size, 0, 3));
+        CHECK(io.wait(done, 2) == 1);
+        CHECK(std::memcmp(check, data.data() + 3 * block_size, block_size) == 0);
+    }
+
+    std::remove(path);
+}
+
+TEST_CASE("IoQueue", "[IoQueue]") {
+    SECTION("Threads") {
+        check_io_queue(IoBackend::Threads);
+    }
+
+    SECTION("Uring") {
+        if (IoQueue::uring_available()) {
+            check_io_queue(IoBackend::Uring);
+        } else {
+            CHECK_THROWS(IoQueue(8, IoBackend::Uring));
+        }
+    }
+
+    SECTION("Auto") {
+        IoQueue io {};
+        CHECK(io.backend() == (IoQueue::uring_available() ? IoBackend::Uring : IoBackend::Threads));
+        CHECK(AsyncFile::open("efp_async_file_test_missing.bin", "r").is_nothing());
+        CHECK(AsyncFile::open("efp_async_file_test_missing.bin", "x").is_nothing());
+    }
+}
+
+#endif
@@ -0,0 +1,124 @@
+#ifndef BINARY_LOG_TEST_HPP_
+#define BINARY_LOG_TEST_HPP_
+
+#include <cstdio>
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "efp.hpp"
+
+using namespace efp;
+
+enum class BinaryLogTestSide : uint8_t {
+    Buy = 1,
+    Sell = 2,
+};
+
+TEST_CASE("BinaryLog", "[BinaryLog]") {
+    const char* path = "efp_binary_log_test.blog";
+
+    const auto read_all = [path]() {
+        auto file = File::open(path, "rb").move();
+
+        Vector<char> bytes {};
+        char chunk[256];
+        size_t n;
+        while ((n = file.read(chunk, sizeof(chunk))) != 0) {
+            for (size_t i = 0; i < n; ++i) {
+                bytes.push_back(chunk[i]);
+            }
+        }
+        return bytes;
+    };
+
+    const auto read_texts = [](const Vector<char>& bytes) {
+        BinaryLogReader reader {VectorView<const char>(bytes.data(), bytes.size())};
+
+        Vector<String> texts {};
+        for (auto entry = reader.next(); entry; entry = reader.next()) {
+            texts.push_back(entry.value().text);
+        }
+        return texts;
+    };
+
+    SECTION("messages are rendered as efp::format would") {
+        {
+            auto file = File::open(path, "wb").move();
+            BinaryLog log {file};
+
+            const String venue {"XNAS"};
+            for (int i = 0; i < 3; ++i) {
+                CHECK(log.log_at(1000 + i, "order {} at {:.2f} on {}", i, i * 0.5, venue));
+            }
+
+            log.log_at(2000, "{} {} {} {}", true, 'c', uint8_t(7), int64_t(-5));
+            log.log_at(2001, "{} {:+.1f}", BinaryLogTestSide::Sell, -1.5f);
+            log.log_at(2002, "{}|{}", Enum<int, String> {String("text")}, Enum<int, String> {42});
+            log.log_at(2003, "no arguments");
+            log.log_at(2004, "{}", StringView {"view"});
+            log.log_at(2005, "{}", 5);
+            log.log("{}", "now");
+
+            // The same strings with other types are defined apart
+            CHECK(log.definitions() == 8);
+        }
+
+        const Vector<char> bytes = read_all();
+        BinaryLogReader reader {VectorView<const char>(bytes.data(), bytes.size())};
+
+        const Maybe<BinaryLogEntry> first = reader.next();
+        REQUIRE(first.has_value());
+        CHECK(first.value().timestamp == 1000);
+        CHECK(first.value().text == "order 0 at 0.00 on XNAS");
+
+        const Vector<String> texts = read_texts(bytes);
+        REQUIRE(texts.size() == 10);
+        CHECK(texts[2] == "order 2 at 1.00 on XNAS");
+        CHECK(texts[3] == "true c 7 -5");
+        CHECK(texts[4] == "2 -1.5");
+        CHECK(texts[5] == "text|42");
+        CHECK(texts[6] == "no arguments");
+        CHECK(texts[7] == "view");
+        CHECK(texts[8] == "5");
+        CHECK(texts[9] == "now");
+    }
+
+    SECTION("messages larger than the buffer") {
+        {
+            auto file = File::open(path, "wb").move();
+            BinaryLog log {file, 64};
+            log.log_at(0, "{}", String(1000, 'x'));
+            log.log_at(1, "{}", 1);
+        }
+
+        const Vector<String> texts = read_texts(read_all());
+        REQUIRE(texts.size() == 2);
+        CHECK(texts[0] == String(1000, 'x'));
+        CHECK(texts[1] == "1");
+    }
+
+    SECTION("a record cut short ends the log") {
+        {
+            auto file = File::open(path, "wb").move();
+            BinaryLog log {file};
+            log.log_at(0, "{} {}", 1, 2);
+            log.log_at(1, "{} {}", 3, 4);
+        }
+
+        Vector<char> bytes = read_all();
+        bytes.resize(bytes.size() - 3);
+
+        const Vector<String> texts = read_texts(bytes);
+        REQUIRE(texts.size() == 1);
+        CHECK(texts[0] == "1 2");
+    }
+
+    SECTION("not a binary log") {
+        const char text[] = "plain text, not a binary log";
+        CHECK_THROWS(BinaryLogReader {VectorView<const char>(text, sizeof(text))});
+    }
+
+    std::remove(path);
+}
+
+#endif
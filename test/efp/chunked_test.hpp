@@ -0,0 +1,161 @@
+#ifndef CHUNKED_TEST_HPP_
+#define CHUNKED_TEST_HPP_
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "efp.hpp"
+#include "test_common.hpp"
+
+using namespace efp;
+
+TEST_CASE("ChunkedVector Rule of 5", "[ChunkedVector]") {
+    SECTION("New Constructor") {
+        {
+            MockHW::reset();
+            ChunkedVector<MockRaii, 2> a;
+            CHECK(MockHW::remaining_resource_count() == 0);
+            a.push_back(MockRaii {});
+            a.push_back(MockRaii {});
+            a.push_back(MockRaii {});
+            CHECK(MockHW::remaining_resource_count() == 3);
+        }
+        CHECK(MockHW::is_sound());
+    }
+
+    SECTION("Copy Constructor") {
+        {
+            MockHW::reset();
+            ChunkedVector<MockRaii, 2> a;
+            a.emplace_back();
+            a.emplace_back();
+            a.emplace_back();
+            ChunkedVector<MockRaii, 2> b = a;
+            CHECK(MockHW::remaining_resource_count() == 6);
+        }
+        CHECK(MockHW::is_sound());
+    }
+
+    SECTION("Copy Assignment") {
+        {
+            MockHW::reset();
+            ChunkedVector<MockRaii, 2> a;
+            a.emplace_back();
+            a.emplace_back();
+            a.emplace_back();
+            ChunkedVector<MockRaii, 2> b;
+            b.emplace_back();
+            b = a;
+            CHECK(MockHW::remaining_resource_count() == 6);
+        }
+        CHECK(MockHW::is_sound());
+    }
+
+    SECTION("Move Constructor") {
+        {
+            MockHW::reset();
+            ChunkedVector<MockRaii, 2> a;
+            a.emplace_back();
+            a.emplace_back();
+            a.emplace_back();
+            ChunkedVector<MockRaii, 2> b = efp::move(a);
+            CHECK(MockHW::remaining_resource_count() == 3);
+            CHECK(a.empty());
+        }
+        CHECK(MockHW::is_sound());
+    }
+
+    SECTION("Move Assignment") {
+        {
+            MockHW::reset();
+            ChunkedVector<MockRaii, 2> a;
+            a.emplace_back();
+            a.emplace_back();
+            a.emplace_back();
+            ChunkedVector<MockRaii, 2> b;
+            b.emplace_back();
+            b = efp::move(a);
+            CHECK(MockHW::remaining_resource_count() == 3);
+        }
+        CHECK(MockHW::is_sound());
+    }
+}
+
+TEST_CASE("ChunkedVector", "[ChunkedVector]") {
+    SECTION("indexing") {
+        ChunkedVector<int, 4> as {};
+        for (int i = 0; i < 100; ++i) {
+            as.push_back(i);
+        }
+
+        CHECK(as.size() == 100);
+        CHECK(as.capacity() == 100);
+        CHECK(as.front() == 0);
+        CHECK(as.back() == 99);
+
+        bool is_all_correct = true;
+        for (int i = 0; i < 100; ++i) {
+            is_all_correct = is_all_correct && as[i] == i;
+        }
+        CHECK(is_all_correct);
+    }
+
+    SECTION("reference stability") {
+        ChunkedVector<int, 4> as {1, 2, 3};
+        const int* first = &as[0];
+        const int* third = &as[2];
+
+        for (int i = 0; i < 1000; ++i) {
+            as.push_back(i);
+        }
+
+        CHECK(first == &as[0]);
+        CHECK(third == &as[2]);
+        CHECK(*third == 3);
+    }
+
+    SECTION("pop_back and clear") {
+        ChunkedVector<int, 2> as {1, 2, 3};
+        as.pop_back();
+        CHECK(as.size() == 2);
+        CHECK(as.back() == 2);
+
+        as.clear();
+        CHECK(as.empty());
+        CHECK(as.capacity() == 4);
+        CHECK_THROWS(as.pop_back());
+    }
+
+    SECTION("chunk") {
+        ChunkedVector<int, 4> as {0, 1, 2, 3, 4, 5};
+        CHECK(as.chunk_count() == 2);
+        CHECK(length(as.chunk(0)) == 4);
+        CHECK(length(as.chunk(1)) == 2);
+        CHECK(nth(1, as.chunk(1)) == 5);
+
+        int total = 0;
+        for_each_chunk([&](VectorView<const int> c) { total += sum(c); }, as);
+        CHECK(total == 15);
+    }
+
+    SECTION("iterator") {
+        ChunkedVector<int, 2> as {1, 2, 3, 4, 5};
+        int total = 0;
+        for (const auto& a : as) {
+            total += a;
+        }
+        CHECK(total == 15);
+    }
+
+    SECTION("Sequence trait") {
+        const ChunkedVector<double, 2> as {1., 2., 3.};
+        CHECK(length(as) == 3);
+        CHECK(nth(2, as) == 3.);
+        CHECK(map([](double x) { return x * 2; }, as) == Vector<double> {2., 4., 6.});
+        CHECK(foldl(op_add<double>, 0., as) == 6.);
+        CHECK(filter([](double x) { return x > 1.; }, as) == Vector<double> {2., 3.});
+        CHECK(elem(2., as));
+        CHECK(find_index([](double x) { return x == 3.; }, as).value() == 2);
+    }
+}
+
+#endif
@@ -0,0 +1,158 @@
+#ifndef CSV_TEST_HPP_
+#define CSV_TEST_HPP_
+
+#include <thread>
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "efp.hpp"
+#include "test_common.hpp"
+
+using namespace efp;
+
+inline String csv_test_text(const StringView& s) {
+    return String(s.data(), s.size());
+}
+
+inline VectorView<const char> csv_test_bytes(const String& s) {
+    return VectorView<const char>(s.data(), s.size());
+}
+
+TEST_CASE("CsvReader", "[CsvReader]") {
+    SECTION("columns") {
+        const String csv {
+            "id,name,price,volume\n"
+            "1,apple,1.25,100\n"
+            "2,\"banana, ripe\",0.5,\n"
+            "\n"
+            "-3,\"say \"\"hi\"\"\",1e3,7\r\n"
+            "4,\"multi\nline\",-2.5e-3,8"
+        };
+
+        CsvReader reader {csv_test_bytes(csv)};
+        CHECK(reader.skip());
+        const auto table = reader.read<int32_t, StringView, double, Maybe<uint64_t>>();
+        CHECK(reader.done());
+
+        CHECK(table.size() == 4);
+        CHECK(table.column<0>()[2] == -3);
+        CHECK(csv_test_text(table.column<1>()[0]) == String("apple"));
+        CHECK(csv_test_text(table.column<1>()[1]) == String("banana, ripe"));
+        CHECK(csv_test_text(table.column<1>()[2]) == String("say \"\"hi\"\""));
+        CHECK(csv_test_text(table.column<1>()[3]) == String("multi\nline"));
+        CHECK(table.column<2>()[0] == 1.25);
+        CHECK(table.column<2>()[2] == 1000.0);
+        CHECK(table.column<2>()[3] == -2.5e-3);
+        CHECK(table.column<3>()[0].value() == 100);
+        CHECK(table.column<3>()[1].is_nothing());
+        CHECK(table.column<3>()[2].value() == 7);
+
+        // Text fields are views into the input
+        CHECK(table.column<1>()[0].data() == csv.data() + 23);
+    }
+
+    SECTION("records") {
+        const String csv {"a;\"b;c\";d\n;\ne"};
+        CsvReader reader {csv_test_bytes(csv), ';'};
+        Vector<StringView> fields {};
+
+        CHECK(reader.next(fields));
+        CHECK(fields.size() == 3);
+        CHECK(csv_test_text(fields[1]) == String("b;c"));
+
+        CHECK(reader.next(fields));
+        CHECK(fields.size() == 2);
+        CHECK(fields[0].empty());
+
+        CHECK(reader.next(fields));
+        CHECK(csv_test_text(fields[0]) == String("e"));
+        CHECK_FALSE(reader.next(fields));
+        CHECK_FALSE(reader.skip());
+    }
+
+    SECTION("numbers") {
+        const String csv {
+            "18446744073709551615,-9223372036854775808,0.1,3.4028234e38,"
+            "123456789012345678901234567890,\"x \"\"q\"\"\"\n"
+        };
+
+        const auto table = CsvReader(csv_test_bytes(csv))
+                               .read<uint64_t, int64_t, double, float, double, String>();
+        CHECK(table.column<0>()[0] == 18446744073709551615ull);
+        CHECK(table.column<1>()[0] == INT64_MIN);
+        CHECK(table.column<2>()[0] == 0.1);
+        CHECK(table.column<3>()[0] == 3.4028234e38f);
+        CHECK(table.column<4>()[0] == 1.2345678901234568e29);
+        CHECK(table.column<5>()[0] == String("x \"q\""));
+
+        const auto parse_int = [](const char* s) {
+            return CsvReader(VectorView<const char>(s, std::strlen(s))).read<int8_t>();
+        };
+        CHECK(parse_int("-128").column<0>()[0] == -128);
+        CHECK_THROWS(parse_int("128"));
+        CHECK_THROWS(parse_int("1x"));
+        CHECK_THROWS(parse_int(" 1"));
+
+        const auto parse_double = [](const char* s) {
+            return CsvReader(VectorView<const char>(s, std::strlen(s))).read<double>();
+        };
+        CHECK(parse_double("1e-400").column<0>()[0] == 0.0);
+        CHECK(parse_double("-inf").column<0>()[0] == -std::numeric_limits<double>::infinity());
+        CHECK_THROWS(parse_double("1e"));
+        CHECK_THROWS(parse_double("."));
+        CHECK_THROWS(parse_double("1.5.2"));
+
+        CHECK_THROWS(CsvReader(csv_test_bytes(String("1,2\n3"))).read<int, int>());
+    }
+
+    SECTION("chunks") {
+        String csv {};
+        for (int i = 0; i < 3000; ++i) {
+            format_to(csv, "{},\"note {}\n{}\",{}\n", i, i, i % 7, i * 0.5);
+        }
+
+        const Vector<VectorView<const char>> chunks = CsvReader::chunks(csv_test_bytes(csv), 4);
+        CHECK(chunks.size() == 4);
+
+        size_t total = 0;
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            total += chunks[i].size();
+            CHECK(chunks[i][chunks[i].size() - 1] == '\n');
+        }
+        CHECK(total == csv.size());
+
+        // Chunks read on their own threads and appended in order
+        using Table = CsvTable<int, StringView, double>;
+        Vector<Table> tables {};
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            tables.push_back(Table {});
+        }
+
+        Vector<std::thread> threads {};
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            threads.push_back(std::thread([&tables, &chunks, i] {
+                tables[i] = CsvReader(chunks[i]).read<int, StringView, double>();
+            }));
+        }
+        for (size_t i = 0; i < threads.size(); ++i) {
+            threads[i].join();
+        }
+
+        Table table {};
+        for (size_t i = 0; i < tables.size(); ++i) {
+            table.append(tables[i]);
+        }
+
+        const Table sequential = CsvReader(csv_test_bytes(csv)).read<int, StringView, double>();
+        CHECK(table.size() == 3000);
+        CHECK(table.column<0>() == sequential.column<0>());
+        CHECK(table.column<2>() == sequential.column<2>());
+        CHECK(table.column<0>()[2999] == 2999);
+        CHECK(csv_test_text(table.column<1>()[1500]) == String("note 1500\n2"));
+
+        CHECK(CsvReader::chunks(csv_test_bytes(String("a\nb")), 8).size() == 2);
+        CHECK(CsvReader::chunks(csv_test_bytes(String("")), 2).empty());
+    }
+}
+
+#endif
@@ -0,0 +1,159 @@
+#ifndef FLAT_MAP_TEST_HPP_
+#define FLAT_MAP_TEST_HPP_
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "efp.hpp"
+#include "test_common.hpp"
+
+using namespace efp;
+
+TEST_CASE("FlatMap", "[FlatMap]") {
+    SECTION("insert and find") {
+        FlatMap<int, double> m {};
+        CHECK(m.empty());
+        CHECK(m.find(1) == nullptr);
+
+        CHECK(m.insert(3, 3.));
+        CHECK(m.insert(1, 1.));
+        CHECK(m.insert(2, 2.));
+        CHECK_FALSE(m.insert(1, 10.));
+
+        CHECK(m.size() == 3);
+        CHECK(m.keys() == Vector<int> {1, 2, 3});
+        CHECK(m.values() == Vector<double> {1., 2., 3.});
+        CHECK(*m.find(2) == 2.);
+        CHECK(m.get(3).value() == 3.);
+        CHECK(m.get(4).is_nothing());
+        CHECK_FALSE(m.contains(0));
+    }
+
+    SECTION("lower_bound") {
+        const FlatMap<int, int> m {
+            Pair<int, int>(10, 0),
+            Pair<int, int>(20, 0),
+            Pair<int, int>(30, 0),
+        };
+
+        CHECK(m.lower_bound(5) == 0);
+        CHECK(m.lower_bound(10) == 0);
+        CHECK(m.lower_bound(11) == 1);
+        CHECK(m.lower_bound(30) == 2);
+        CHECK(m.lower_bound(31) == 3);
+        CHECK(FlatMap<int, int> {}.lower_bound(1) == 0);
+    }
+
+    SECTION("insert_or_assign, operator[] and erase") {
+        FlatMap<int, int> m {};
+        m.insert_or_assign(2, 2);
+        m.insert_or_assign(2, 20);
+        m[1] += 1;
+        m[1] += 1;
+
+        CHECK(m.keys() == Vector<int> {1, 2});
+        CHECK(m.values() == Vector<int> {2, 20});
+
+        CHECK(m.erase(1));
+        CHECK_FALSE(m.erase(1));
+        CHECK(m.keys() == Vector<int> {2});
+    }
+
+    SECTION("insert_bulk") {
+        FlatMap<int, int> m {};
+        m.insert(5, 50);
+        m.insert(1, 10);
+
+        const Vector<Pair<int, int>> entries {
+            Pair<int, int>(4, 40),
+            Pair<int, int>(5, 0),
+            Pair<int, int>(2, 20),
+            Pair<int, int>(4, 0),
+            Pair<int, int>(9, 90),
+        };
+        m.insert_bulk(entries);
+
+        // Existing keys and the first of duplicates are kept
+        CHECK(m.keys() == Vector<int> {1, 2, 4, 5, 9});
+        CHECK(m.values() == Vector<int> {10, 20, 40, 50, 90});
+    }
+
+    SECTION("large insert_bulk") {
+        Vector<Pair<int, int>> entries {};
+        for (int i = 0; i < 5000; ++i) {
+            const int k = (i * 7919) % 5000;
+            entries.push_back(Pair<int, int>(k, k * 2));
+        }
+
+        FlatMap<int, int> m {};
+        m.insert_bulk(entries);
+        CHECK(m.size() == 5000);
+
+        bool ok = true;
+        for (int i = 0; i < 5000; ++i) {
+            ok = ok && m.keys()[i] == i && *m.find(i) == i * 2;
+        }
+        CHECK(ok);
+    }
+
+    SECTION("string keys") {
+        FlatMap<String, int> m {};
+        m.insert(String {"b"}, 2);
+        m.insert(String {"ab"}, 1);
+        m.insert(String {"abc"}, 3);
+
+        CHECK(m.keys()[0] == "ab");
+        CHECK(m.keys()[1] == "abc");
+        CHECK(m.keys()[2] == "b");
+
+        const StringView view {"abcd", 3};
+        CHECK(*m.find(view) == 3);
+        CHECK(m.erase(view));
+        CHECK(m.size() == 2);
+    }
+
+    SECTION("soundness") {
+        MockHW::reset();
+        {
+            FlatMap<int, MockRaii> m {};
+            for (int i = 0; i < 20; ++i) {
+                m.insert((i * 7) % 20, MockRaii {});
+            }
+            for (int i = 0; i < 10; ++i) {
+                m.erase(i);
+            }
+            CHECK(MockHW::remaining_resource_count() == 10);
+
+            Vector<Pair<int, MockRaii>> entries {};
+            entries.push_back(Pair<int, MockRaii>(100, MockRaii {}));
+            m.insert_bulk(entries);
+        }
+        CHECK(MockHW::is_sound());
+    }
+}
+
+TEST_CASE("FlatSet", "[FlatSet]") {
+    SECTION("insert and contains") {
+        FlatSet<int> s {3, 1, 2, 3};
+        CHECK(s.keys() == Vector<int> {1, 2, 3});
+        CHECK(s.contains(2));
+        CHECK_FALSE(s.insert(2));
+        CHECK(s.insert(0));
+        CHECK(s.erase(3));
+        CHECK(s.keys() == Vector<int> {0, 1, 2});
+    }
+
+    SECTION("insert_bulk") {
+        FlatSet<double> s {2.5};
+        s.insert_bulk(vector_5);
+        s.insert_bulk(array_3);
+        CHECK(length(s) == 6);
+        CHECK(nth(2, s) == 2.5);
+    }
+
+    SECTION("sequence") {
+        const FlatSet<int> s {5, 4, 3};
+        CHECK(foldl([](int acc, int x) { return acc + x; }, 0, s) == 12);
+    }
+}
+
+#endif
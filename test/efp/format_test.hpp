@@ -79,4 +79,96 @@ TEST_CASE("format", "[format]") {
     }
 }
 
+TEST_CASE("format_to", "[format]") {
+    SECTION("Vector<char>") {
+        String out {};
+        efp::format_to(out, "{}-{}", 1, "a");
+        efp::format_to(out, "|{:>5}|", 42);
+        CHECK(out == "1-a|   42|");
+
+        // Crosses the inline capacity and grows
+        const String long_text(100, 'z');
+        efp::format_to(out, "{}{}", long_text, long_text);
+        CHECK(out.size() == 210);
+        CHECK(out.back() == 'z');
+        CHECK(std::strlen(out.c_str()) == 210);
+    }
+
+    SECTION("reused Vector<char> does not allocate") {
+        String out {};
+        out.reserve(256);
+
+        CHECK_ALLOCATION_FREE(for (int i = 0; i < 100; ++i) {
+            out.clear();
+            efp::format_to(out, "{} {:.3f} {}", i, i * 0.5, "telemetry");
+        });
+        CHECK(out == "99 49.500 telemetry");
+    }
+
+    SECTION("format_to_n into ArrVec<char, n>") {
+        ArrVec<char, 8> out {};
+        CHECK(efp::format_to_n(out, "{}", 123) == 3);
+        CHECK(out.size() == 3);
+
+        // Truncated to the capacity, returning the whole size
+        CHECK(efp::format_to_n(out, "{}", "abcdefghij") == 10);
+        CHECK(out.size() == 8);
+        CHECK(out[3] == 'a');
+        CHECK(out[7] == 'e');
+
+        CHECK(efp::format_to_n(out, "{}", 1) == 1);
+        CHECK(out.size() == 8);
+
+        // Far beyond the capacity
+        ArrVec<char, 4> small {};
+        CHECK(efp::format_to_n(small, "{}", String(1000, 'x')) == 1000);
+        CHECK(small.size() == 4);
+
+        CHECK_ALLOCATION_FREE(ArrVec<char, 32> buf {}; efp::format_to_n(buf, "{:08x}", 255u));
+    }
+
+    SECTION("formatted_size") {
+        CHECK(efp::formatted_size("{}", 12345) == 5);
+        CHECK(efp::formatted_size("{} {}", "ab", 1.5) == 6);
+        CHECK(efp::formatted_size("") == 0);
+    }
+}
+
+TEST_CASE("EFP_COMPILE", "[format]") {
+    SECTION("same output as the run time format string") {
+        CHECK(efp::format(EFP_COMPILE("{} {}"), 42, "answer") == "42 answer");
+        CHECK(efp::format(EFP_COMPILE("{:.3f}|{:>5}|{:08x}"), 3.14159, "ab", 255u)
+              == efp::format("{:.3f}|{:>5}|{:08x}", 3.14159, "ab", 255u));
+        CHECK(efp::format(EFP_COMPILE("{1}-{0}"), 'a', 'b') == "b-a");
+        CHECK(efp::format(EFP_COMPILE("{{{}}}"), true) == "{true}");
+        CHECK(efp::format(EFP_COMPILE("no fields")) == "no fields");
+        CHECK(efp::format(EFP_COMPILE("")) == "");
+        CHECK(efp::format(EFP_COMPILE("{}"), String("efp")) == "efp");
+        CHECK(efp::format(EFP_COMPILE("{}"), Vector<int> {1, 2}) == "[1, 2]");
+    }
+
+    SECTION("format_to and formatted_size") {
+        String out {};
+        out.reserve(256);
+
+        CHECK_ALLOCATION_FREE(for (int i = 0; i < 100; ++i) {
+            out.clear();
+            efp::format_to(out, EFP_COMPILE("{} {:.3f} {}"), i, i * 0.5, "telemetry");
+        });
+        CHECK(out == "99 49.500 telemetry");
+
+        ArrVec<char, 4> small {};
+        CHECK(efp::format_to_n(small, EFP_COMPILE("{}-{}"), 123, 456) == 7);
+        CHECK(small.size() == 4);
+
+        CHECK(efp::formatted_size(EFP_COMPILE("{} {}"), "ab", 1.5) == 6);
+    }
+
+#if __cplusplus >= 202002L
+    SECTION("compiled") {
+        CHECK(efp::format(efp::compiled<"{}:{}">, "key", 7) == "key:7");
+    }
+#endif
+}
+
 #endif
\ No newline at end of file
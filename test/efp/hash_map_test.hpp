@@ -0,0 +1,268 @@
+#ifndef HASH_MAP_TEST_HPP_
+#define HASH_MAP_TEST_HPP_
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "efp.hpp"
+#include "test_common.hpp"
+
+using namespace efp;
+
+TEST_CASE("HashMap", "[HashMap]") {
+    SECTION("insert and find") {
+        HashMap<int, double> m {};
+        CHECK(m.empty());
+        CHECK(m.find(1) == nullptr);
+
+        CHECK(m.insert(1, 1.));
+        CHECK(m.insert(2, 2.));
+        CHECK_FALSE(m.insert(1, 10.));
+
+        CHECK(m.size() == 2);
+        CHECK(*m.find(1) == 1.);
+        CHECK(*m.find(2) == 2.);
+        CHECK(m.get(2).value() == 2.);
+        CHECK(m.get(3).is_nothing());
+        CHECK(m.contains(1));
+        CHECK_FALSE(m.contains(3));
+    }
+
+    SECTION("insert_or_assign and operator[]") {
+        HashMap<int, int> m {};
+        m.insert_or_assign(1, 1);
+        m.insert_or_assign(1, 2);
+        CHECK(*m.find(1) == 2);
+
+        m[3] += 3;
+        m[3] += 3;
+        CHECK(m[3] == 6);
+        CHECK(m.size() == 2);
+    }
+
+    SECTION("initializer list") {
+        const HashMap<int, int> m {Pair<int, int>(1, 10), Pair<int, int>(2, 20)};
+        CHECK(m.size() == 2);
+        CHECK(*m.find(2) == 20);
+    }
+
+    SECTION("growth") {
+        HashMap<int, int> m {};
+        bool all_inserted = true;
+        for (int i = 0; i < 10000; ++i) {
+            all_inserted = m.insert(i, i * 2) && all_inserted;
+        }
+        CHECK(all_inserted);
+
+        CHECK(m.size() == 10000);
+        CHECK(m.capacity() >= 10000);
+
+        bool all_found = true;
+        for (int i = 0; i < 10000; ++i) {
+            const int* v = m.find(i);
+            all_found = all_found && v && *v == i * 2;
+        }
+        CHECK(all_found);
+        CHECK_FALSE(m.contains(10000));
+    }
+
+    SECTION("reserve") {
+        HashMap<int, int> m {};
+        m.reserve(1000);
+        const size_t capacity = m.capacity();
+        CHECK(capacity >= 1000);
+
+        for (int i = 0; i < 1000; ++i) {
+            m.insert(i, i);
+        }
+        CHECK(m.capacity() == capacity);
+    }
+
+    SECTION("erase") {
+        HashMap<int, int> m {};
+        for (int i = 0; i < 100; ++i) {
+            m.insert(i, i);
+        }
+
+        for (int i = 0; i < 100; i += 2) {
+            CHECK(m.erase(i));
+        }
+        CHECK_FALSE(m.erase(0));
+        CHECK(m.size() == 50);
+
+        bool ok = true;
+        for (int i = 0; i < 100; ++i) {
+            ok = ok && m.contains(i) == (i % 2 == 1);
+        }
+        CHECK(ok);
+
+        // The entries moved into the holes are still found
+        for (int i = 1; i < 100; i += 2) {
+            ok = ok && *m.find(i) == i;
+        }
+        CHECK(ok);
+    }
+
+    SECTION("tombstone churn") {
+        HashMap<int, int> m {};
+        m.reserve(64);
+        const size_t capacity = m.capacity();
+
+        for (int i = 0; i < 100000; ++i) {
+            m.insert(i, i);
+            if (i >= 32) {
+                m.erase(i - 32);
+            }
+        }
+
+        CHECK(m.size() == 32);
+        CHECK(m.capacity() == capacity);
+
+        bool ok = true;
+        for (int i = 100000 - 32; i < 100000; ++i) {
+            ok = ok && m.contains(i);
+        }
+        CHECK(ok);
+    }
+
+    SECTION("clear") {
+        HashMap<int, int> m {};
+        for (int i = 0; i < 100; ++i) {
+            m.insert(i, i);
+        }
+        m.clear();
+        CHECK(m.size() == 0);
+        CHECK_FALSE(m.contains(0));
+        CHECK(m.insert(0, 0));
+    }
+
+    SECTION("string keys") {
+        HashMap<String, int> m {};
+        m.insert(String {"one"}, 1);
+        m.insert(String {"two"}, 2);
+
+        const String three {"three"};
+        const StringView two_view {"two!", 3};
+
+        CHECK(*m.find(String {"one"}) == 1);
+        CHECK(*m.find(two_view) == 2);
+        CHECK(*m.find("one") == 1);
+        CHECK(m.find(three) == nullptr);
+        CHECK(m.erase(two_view));
+        CHECK(m.size() == 1);
+    }
+
+    SECTION("insert_bulk") {
+        const Vector<Pair<int, int>> entries {
+            Pair<int, int>(1, 1),
+            Pair<int, int>(2, 2),
+            Pair<int, int>(1, 10),
+        };
+
+        HashMap<int, int> m {};
+        m.insert_bulk(entries);
+        CHECK(m.size() == 2);
+        CHECK(*m.find(1) == 1);
+    }
+
+    SECTION("sequence") {
+        HashMap<int, int> m {};
+        for (int i = 0; i < 10; ++i) {
+            m.insert(i, i * i);
+        }
+
+        CHECK(length(m) == 10);
+        CHECK(fst(nth(3, m)) == 3);
+
+        int sum = 0;
+        for_each([&](const Pair<int, int>& e) { sum += snd(e); }, m);
+        CHECK(sum == 285);
+    }
+
+    SECTION("soundness") {
+        MockHW::reset();
+        {
+            HashMap<int, MockRaii> m {};
+            for (int i = 0; i < 100; ++i) {
+                m.insert(i, MockRaii {});
+            }
+            for (int i = 0; i < 50; ++i) {
+                m.erase(i);
+            }
+            CHECK(MockHW::remaining_resource_count() == 50);
+
+            HashMap<int, MockRaii> copied = m;
+            CHECK(MockHW::remaining_resource_count() == 100);
+        }
+        CHECK(MockHW::is_sound());
+    }
+}
+
+TEST_CASE("HashSet", "[HashSet]") {
+    SECTION("insert and contains") {
+        HashSet<int> s {1, 2, 3, 2};
+        CHECK(s.size() == 3);
+        CHECK(s.contains(2));
+        CHECK_FALSE(s.insert(3));
+        CHECK(s.erase(2));
+        CHECK_FALSE(s.contains(2));
+    }
+
+    SECTION("insert_bulk") {
+        HashSet<double> s {};
+        s.insert_bulk(vector_5);
+        s.insert_bulk(array_3);
+        CHECK(length(s) == 5);
+    }
+
+    SECTION("string") {
+        HashSet<String> s {String {"a"}, String {"b"}};
+        CHECK(s.contains("a"));
+        CHECK_FALSE(s.contains("c"));
+    }
+}
+
+TEST_CASE("ArrHashMap", "[ArrHashMap]") {
+    SECTION("capacity") {
+        ArrHashMap<int, int, 20> m {};
+        CHECK(m.capacity() >= 20);
+
+        for (int i = 0; i < 20; ++i) {
+            m.insert(i, i);
+        }
+        CHECK(m.size() == 20);
+        CHECK(*m.find(19) == 19);
+        CHECK_THROWS(m.insert(20, 20));
+    }
+
+    SECTION("churn") {
+        ArrHashMap<int, int, 8> m {};
+        for (int i = 0; i < 1000; ++i) {
+            m.insert(i, i);
+            if (i >= 4) {
+                m.erase(i - 4);
+            }
+        }
+        CHECK(m.size() == 4);
+        CHECK(m.contains(999));
+    }
+
+    SECTION("allocation free") {
+        CHECK_ALLOCATION_FREE({
+            ArrHashMap<int, double, 10> m {};
+            m.insert(1, 1.);
+            m.insert_or_assign(1, 2.);
+            CHECK(*m.find(1) == 2.);
+            m.erase(1);
+        });
+    }
+}
+
+TEST_CASE("ArrHashSet", "[ArrHashSet]") {
+    ArrHashSet<int, 4> s {1, 2, 3};
+    CHECK(length(s) == 3);
+    CHECK(s.contains(3));
+    CHECK(s.insert(4));
+    CHECK_THROWS(s.insert(5));
+}
+
+#endif
@@ -0,0 +1,117 @@
+#ifndef HASH_TEST_HPP_
+#define HASH_TEST_HPP_
+
+#include <unordered_map>
+#include <unordered_set>
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "efp.hpp"
+#include "test_common.hpp"
+
+using namespace efp;
+
+TEST_CASE("Hash", "[Hash]") {
+    SECTION("integer") {
+        CHECK(Hash<int>()(1) != 1);
+        CHECK(Hash<int>()(1) != Hash<int>()(2));
+        CHECK(Hash<int>()(42) == Hash<int>()(42));
+    }
+
+    SECTION("floating point") {
+        CHECK(Hash<double>()(0.) == Hash<double>()(-0.));
+        CHECK(Hash<double>()(1.) != Hash<double>()(2.));
+    }
+
+    SECTION("bytes of every length") {
+        // Crosses the boundaries of the short, medium and 48 byte loop paths
+        char buffer[200];
+        for (size_t i = 0; i < 200; ++i) {
+            buffer[i] = static_cast<char>(i * 7);
+        }
+
+        HashSet<size_t> hashes {};
+        for (size_t len = 0; len <= 200; ++len) {
+            hashes.insert(detail::hash_bytes(buffer, len));
+        }
+        CHECK(hashes.size() == 201);
+
+        // A single bit flip changes the hash
+        const uint64_t h = detail::hash_bytes(buffer, 100);
+        buffer[57] ^= 1;
+        CHECK(detail::hash_bytes(buffer, 100) != h);
+    }
+
+    SECTION("string and view") {
+        const String s {"hello"};
+        const StringView v {s.data(), 5};
+
+        CHECK(Hash<String>()(s) == Hash<StringView>()(v));
+        CHECK(Hash<String>()(s) == Hash<String>()("hello"));
+        CHECK(Hash<String>()(s) != Hash<String>()("hellp"));
+        CHECK(Hash<String>()(String {""}) == Hash<String>()(""));
+    }
+
+    SECTION("sequences") {
+        const Array<int, 3> a {1, 2, 3};
+        const Vector<int> b {1, 2, 3};
+        const Vector<int> c {3, 2, 1};
+
+        CHECK(Hash<Array<int, 3>>()(a) == Hash<Vector<int>>()(b));
+        CHECK(Hash<Vector<int>>()(b) != Hash<Vector<int>>()(c));
+        CHECK(Hash<Array<double, 3>>()(array_3) == Hash<Vector<double>>()(vector_3));
+        CHECK(
+            Hash<VectorView<const double>>()(vector_view_3) == Hash<Vector<double>>()(vector_3)
+        );
+        CHECK(Hash<Vector<double>>()(vector_3) != Hash<Vector<double>>()(vector_5));
+    }
+
+    SECTION("nested sequences") {
+        const Vector<String> a {String {"ab"}, String {"c"}};
+        const Vector<String> b {String {"a"}, String {"bc"}};
+
+        CHECK(Hash<Vector<String>>()(a) != Hash<Vector<String>>()(b));
+    }
+
+    SECTION("Enum and Maybe") {
+        const Enum<int, double> i {1};
+        const Enum<int, double> d {1.};
+
+        CHECK(Hash<Enum<int, double>>()(i) != Hash<Enum<int, double>>()(d));
+        CHECK(Hash<Enum<int, double>>()(i) == Hash<Enum<int, double>>()(Enum<int, double> {1}));
+
+        const Maybe<int> nothing_int = nothing;
+        CHECK(Hash<Maybe<int>>()(nothing_int) == Hash<Maybe<int>>()(Maybe<int> {nothing}));
+        CHECK(Hash<Maybe<int>>()(nothing_int) != Hash<Maybe<int>>()(Maybe<int> {0}));
+    }
+
+    SECTION("std::hash") {
+        std::unordered_set<String> set {};
+        set.insert(String {"one"});
+        set.insert(String {"two"});
+        CHECK(set.count(String {"one"}) == 1);
+        CHECK(set.count(String {"three"}) == 0);
+
+        std::unordered_map<Vector<int>, int> map {};
+        map[Vector<int> {1, 2}] = 3;
+        CHECK(map[Vector<int> {1, 2}] == 3);
+
+        // Falls back to std::hash
+        CHECK(Hash<std::string>()(std::string {"a"}) == Hash<std::string>()(std::string {"a"}));
+    }
+
+    SECTION("HashMap of sequences") {
+        HashMap<Vector<int>, int> m {};
+        m.insert(Vector<int> {1, 2}, 3);
+        CHECK(*m.find(Vector<int> {1, 2}) == 3);
+        CHECK(m.find(Vector<int> {2, 1}) == nullptr);
+
+        HashSet<Maybe<int>> s {};
+        s.insert(nothing);
+        s.insert(1);
+        CHECK(s.size() == 2);
+        CHECK(s.contains(Maybe<int> {1}));
+    }
+}
+
+#endif
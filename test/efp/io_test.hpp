@@ -0,0 +1,170 @@
+#ifndef IO_TEST_HPP_
+#define IO_TEST_HPP_
+
+#include <cstdio>
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "efp.hpp"
+#include "test_common.hpp"
+
+using namespace efp;
+
+TEST_CASE("File", "[File]") {
+    const char* path = "efp_io_test.txt";
+    const String long_line(300, 'l');
+
+    {
+        auto file = File::open(path, "w").move();
+        file.write("first\n");
+        file.write("\n");
+        file.write(long_line);
+        file.write("\nlast");
+    }
+
+    SECTION("read_line") {
+        auto file = File::open(path, "r").move();
+        CHECK(file.read_line().value() == "first");
+        CHECK(file.read_line().value().empty());
+        CHECK(file.read_line().value() == long_line);
+        CHECK(file.read_line().value() == "last");
+        CHECK(file.read_line().is_nothing());
+    }
+
+    SECTION("read_line with NUL bytes") {
+        // NUL bytes inside a line, at the end of the file and across the chunk of fgets
+        String nul_line(300, 'n');
+        nul_line[0] = '\0';
+        nul_line[254] = '\0';
+        nul_line[255] = '\0';
+        {
+            auto file = File::open(path, "wb").move();
+            file.write("a\0b\n", 4);
+            file.write(nul_line);
+            file.write("\n\0\n", 3);
+            file.write("c\0", 2);
+        }
+
+        auto file = File::open(path, "rb").move();
+        CHECK(file.read_line().value() == String("a\0b", 3));
+        CHECK(file.read_line().value() == nul_line);
+        CHECK(file.read_line().value() == String("\0", 1));
+        CHECK(file.read_line().value() == String("c\0", 2));
+        CHECK(file.read_line().is_nothing());
+    }
+
+    SECTION("read_lines") {
+        auto file = File::open(path, "r").move();
+        const Vector<String> lines = file.read_lines();
+
+        CHECK(lines.size() == 4);
+        CHECK(lines[0] == "first");
+        CHECK(lines[1].empty());
+        CHECK(lines[2] == long_line);
+        CHECK(lines[3] == "last");
+    }
+
+    SECTION("LineReader across blocks") {
+        // Blocks smaller than the lines carry over and grow the buffer
+        for (size_t block_size = 1; block_size <= 512; block_size *= 3) {
+            auto file = File::open(path, "r").move();
+            LineReader reader {file, block_size};
+
+            CHECK(reader.next().value() == "first");
+            CHECK(reader.next().value().empty());
+            const StringView line = reader.next().value();
+            CHECK(line.size() == long_line.size());
+            CHECK(line == long_line.c_str());
+            CHECK(reader.next().value() == "last");
+            CHECK(reader.next().is_nothing());
+            CHECK(reader.next().is_nothing());
+        }
+    }
+
+    SECTION("LineReader of an empty file") {
+        {
+            auto file = File::open(path, "w").move();
+        }
+
+        auto file = File::open(path, "r").move();
+        LineReader reader {file};
+        CHECK(reader.next().is_nothing());
+    }
+
+    std::remove(path);
+}
+
+TEST_CASE("BufWriter", "[BufWriter]") {
+    const char* path = "efp_buf_writer_test.txt";
+
+    SECTION("write, write_all and format_to") {
+        {
+            auto file = File::open(path, "w").move();
+            BufWriter out {file, 64};
+            CHECK(out.capacity() == 64);
+
+            const String name {"efp"};
+            CHECK(out.write("id,name\n"));
+            CHECK(out.write_all("1,", name, StringView {"\n"}));
+            CHECK(format_to(out, "{},{}\n", 2, 3.5));
+            CHECK(out.buffered() == 20);
+
+            // Longer than the buffer, across several drains
+            const String long_line(150, 'x');
+            CHECK(out.write(long_line));
+            CHECK(out.write('\n'));
+            CHECK(format_to(out, "{}{}\n", long_line, long_line));
+            CHECK(format_to(out, EFP_COMPILE("{}{}\n"), long_line, long_line));
+        }
+
+        auto file = File::open(path, "r").move();
+        const Vector<String> lines = file.read_lines();
+        CHECK(lines.size() == 6);
+        CHECK(lines[0] == "id,name");
+        CHECK(lines[1] == "1,efp");
+        CHECK(lines[2] == "2,3.5");
+        CHECK(lines[3].size() == 150);
+        CHECK(lines[4] == String(300, 'x'));
+        CHECK(lines[5] == String(300, 'x'));
+    }
+
+    SECTION("flush policy") {
+        auto file = File::open(path, "w").move();
+
+        // EOF is sticky on a stream, hence a new one for each look
+        const auto written = [path]() { return File::open(path, "r").move().read_lines(); };
+
+        BufWriter full {file, 1024, FlushPolicy::Full};
+        full.write("a\n");
+        CHECK(full.buffered() == 2);
+        CHECK(written().empty());
+        CHECK(full.flush());
+        CHECK(full.buffered() == 0);
+        CHECK(written().size() == 1);
+
+        BufWriter line {file, 1024, FlushPolicy::Line};
+        line.write("b");
+        CHECK(line.buffered() == 1);
+        format_to(line, "{}\n", 'c');
+        CHECK(line.buffered() == 0);
+        CHECK(written()[1] == "bc");
+
+        BufWriter always {file, 1024, FlushPolicy::Always};
+        always.write_all("d", "e");
+        CHECK(always.buffered() == 0);
+        CHECK(written()[2] == "de");
+    }
+
+    SECTION("format_to does not allocate") {
+        auto file = File::open(path, "w").move();
+        BufWriter out {file, 256};
+
+        CHECK_ALLOCATION_FREE(for (int i = 0; i < 100; ++i) {
+            format_to(out, "{},{:.2f},{}\n", i, i * 0.5, "row");
+        });
+    }
+
+    std::remove(path);
+}
+
+#endif
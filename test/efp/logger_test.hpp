@@ -0,0 +1,178 @@
+#ifndef LOGGER_TEST_HPP_
+#define LOGGER_TEST_HPP_
+
+#include <cstdio>
+#include <thread>
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "efp.hpp"
+
+using namespace efp;
+
+TEST_CASE("AsyncLogger", "[AsyncLogger]") {
+    const char* path = "efp_logger_test.txt";
+
+    // EOF is sticky on a stream, hence a new one for each look
+    const auto written = [path]() { return File::open(path, "r").move().read_lines(); };
+
+    SECTION("arguments are copied and formatted in the background") {
+        {
+            auto file = File::open(path, "w").move();
+            AsyncLogger logger {file};
+
+            const char name[] = "efp";
+            CHECK(logger.log("{} {:.2f} {}", 42, 3.14159, name));
+            {
+                // Gone before the line is formatted
+                const String temporary {"a string longer than the small string capacity"};
+                CHECK(logger.log("{}|{}", temporary, StringView {temporary.data(), 8}));
+            }
+            const char* c_str = "c_str";
+            CHECK(logger.log("{} {} {}", c_str, 'x', true));
+            CHECK(logger.log("no arguments"));
+        }
+
+        const Vector<String> lines = written();
+        REQUIRE(lines.size() == 4);
+        CHECK(lines[0] == "42 3.14 efp");
+        CHECK(lines[1] == "a string longer than the small string capacity|a string");
+        CHECK(lines[2] == "c_str x true");
+        CHECK(lines[3] == "no arguments");
+    }
+
+    SECTION("flush") {
+        auto file = File::open(path, "w").move();
+        AsyncLogger logger {file};
+
+        logger.log("{}", 1);
+        logger.flush();
+        CHECK(written().size() == 1);
+
+        logger.log("{}", 2);
+        logger.flush();
+        CHECK(written().size() == 2);
+    }
+
+    SECTION("lines of a thread keep their order across the wrap of the ring") {
+        const int thread_num = 4;
+        const int line_num = 2000;
+
+        {
+            auto file = File::open(path, "w").move();
+            AsyncLogger logger {file, 256};
+            CHECK(logger.ring_capacity() == 256);
+
+            std::thread threads[thread_num];
+            for (int t = 0; t < thread_num; ++t) {
+                threads[t] = std::thread([&logger, t] {
+                    for (int i = 0; i < line_num; ++i) {
+                        logger.log("{} {} {}", t, i, "padding of odd length");
+                    }
+                });
+            }
+
+            for (int t = 0; t < thread_num; ++t) {
+                threads[t].join();
+            }
+            CHECK(logger.dropped() == 0);
+        }
+
+        const Vector<String> lines = written();
+        REQUIRE(lines.size() == thread_num * line_num);
+
+        int next[thread_num] = {};
+        bool ordered = true;
+        for (size_t i = 0; i < lines.size(); ++i) {
+            int t = -1;
+            int n = -1;
+            std::sscanf(lines[i].c_str(), "%d %d", &t, &n);
+            ordered = ordered && t >= 0 && t < thread_num && n == next[t];
+            if (t >= 0 && t < thread_num) {
+                ++next[t];
+            }
+        }
+        CHECK(ordered);
+    }
+
+    SECTION("overflow policies") {
+        // A record of the line takes under half the ring
+        const String payload(60, 'x');
+        const int line_num = 5000;
+
+        {
+            auto file = File::open(path, "w").move();
+            AsyncLogger logger {file, 256, OverflowPolicy::Drop};
+
+            int logged = 0;
+            for (int i = 0; i < line_num; ++i) {
+                logged += logger.log("{}", payload) ? 1 : 0;
+            }
+            CHECK(size_t(logged) + logger.dropped() == size_t(line_num));
+            logger.flush();
+            CHECK(written().size() == size_t(logged));
+        }
+
+        {
+            auto file = File::open(path, "w").move();
+            AsyncLogger logger {file, 256, OverflowPolicy::Count};
+
+            int logged = 0;
+            for (int i = 0; i < line_num; ++i) {
+                logged += logger.log("{}", payload) ? 1 : 0;
+            }
+            const size_t dropped = logger.dropped();
+            logger.flush();
+
+            // Each report is a line of its own
+            size_t reported = 0;
+            size_t messages = 0;
+            const Vector<String> lines = written();
+            for (size_t i = 0; i < lines.size(); ++i) {
+                size_t n = 0;
+                if (std::sscanf(lines[i].c_str(), "AsyncLogger: %zu lines dropped", &n) == 1) {
+                    reported += n;
+                } else {
+                    ++messages;
+                }
+            }
+            CHECK(messages == size_t(logged));
+            CHECK(reported == dropped);
+        }
+
+        {
+            auto file = File::open(path, "w").move();
+            AsyncLogger logger {file, 256, OverflowPolicy::Block};
+            CHECK_THROWS(logger.log("{}", String(1000, 'x')));
+
+            // Half the ring, after a small line at each offset so that it wraps at every point
+            const String half(128 - sizeof(detail::LogRecord) - sizeof(size_t), 'h');
+            for (int i = 0; i < 40; ++i) {
+                CHECK(logger.log("{}", i));
+                logger.flush();
+                CHECK(logger.log("{}", half));
+            }
+            CHECK_THROWS(logger.log("{}", String(half.size() + 1, 'h')));
+
+            logger.flush();
+            const Vector<String> lines = written();
+            CHECK(lines.size() == 80);
+            CHECK(lines[78] == "39");
+            CHECK(lines[79] == half);
+        }
+
+        {
+            auto file = File::open(path, "w").move();
+            AsyncLogger logger {file, 256, OverflowPolicy::Drop};
+            CHECK(logger.log("{}", 1));
+            logger.flush();
+            CHECK_FALSE(logger.log("{}", String(190, 'x')));
+            CHECK(logger.dropped() == 1);
+            CHECK(logger.log("{}", String(60, 'x')));
+        }
+    }
+
+    std::remove(path);
+}
+
+#endif
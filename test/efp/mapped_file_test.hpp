@@ -0,0 +1,72 @@
+#ifndef MAPPED_FILE_TEST_HPP_
+#define MAPPED_FILE_TEST_HPP_
+
+#include <cstdio>
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "efp.hpp"
+#include "test_common.hpp"
+
+using namespace efp;
+
+TEST_CASE("MappedFile", "[MappedFile]") {
+    const char* path = "efp_mapped_file_test.bin";
+
+    SECTION("text") {
+        {
+            auto file = File::open(path, "w").move();
+            file.write("a,b\nc,d\n");
+        }
+
+        const auto mapped = MappedFile::open(path).move();
+        CHECK(mapped.size() == 8);
+        CHECK(mapped.advise(MapAdvice::Sequential));
+        CHECK(mapped.advise(MapAdvice::WillNeed, 3, 2));
+
+        const VectorView<const char> chars = mapped.chars();
+        CHECK(chars[0] == 'a');
+        CHECK(foldl([](int acc, char c) { return acc + (c == '\n'); }, 0, chars) == 2);
+        CHECK(find_index([](char c) { return c == 'c'; }, chars).value() == 4);
+        CHECK(mapped.bytes()[1] == uint8_t(','));
+    }
+
+    SECTION("records") {
+        const uint32_t records[4] = {1, 2, 3, 4};
+        {
+            auto file = File::open(path, "wb").move();
+            file.write(reinterpret_cast<const char*>(records), sizeof(records));
+        }
+
+        auto mapped = MappedFile::open(String {path}).move();
+        const VectorView<const uint32_t> view = mapped.view<uint32_t>();
+        CHECK(view.size() == 4);
+        CHECK(foldl([](uint32_t acc, uint32_t x) { return acc + x; }, uint32_t(0), view) == 10);
+        struct Rgb {
+            uint8_t r, g, b;
+        };
+        CHECK_THROWS(mapped.view<Rgb>());
+
+        // Moved mappings stay valid and unmap once
+        const MappedFile moved = efp::move(mapped);
+        CHECK(mapped.empty());
+        CHECK(moved.view<uint32_t>()[3] == 4);
+    }
+
+    SECTION("empty and missing files") {
+        {
+            auto file = File::open(path, "w").move();
+        }
+
+        const auto mapped = MappedFile::open(path).move();
+        CHECK(mapped.empty());
+        CHECK(mapped.chars().empty());
+        CHECK(mapped.advise(MapAdvice::Random));
+
+        CHECK(MappedFile::open("efp_mapped_file_test_missing.bin").is_nothing());
+    }
+
+    std::remove(path);
+}
+
+#endif
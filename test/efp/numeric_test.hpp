@@ -76,6 +76,14 @@ TEST_CASE("sum") {
     SECTION("std::vectors") {
         CHECK(sum(vector_5) == 15.);
     }
+
+    SECTION("aligned") {
+        const Array<double, 5, 64> as {1., 2., 3., 4., 5.};
+        CHECK(sum(as) == 15.);
+
+        const Vector<int, AlignedAllocator<int, 32>> bs {1, 2, 3, 4, 5};
+        CHECK(sum(bs) == 15);
+    }
 }
 
 TEST_CASE("product") {
@@ -90,6 +98,14 @@ TEST_CASE("product") {
     SECTION("std::vectors") {
         CHECK(product(vector_5) == 120.);
     }
+
+    SECTION("aligned") {
+        const Array<double, 5, 64> as {1., 2., 3., 4., 5.};
+        CHECK(product(as) == 120.);
+
+        const Vector<int, AlignedAllocator<int, 32>> bs {1, 2, 3, 4, 5};
+        CHECK(product(bs) == 120);
+    }
 }
 
 #endif
\ No newline at end of file
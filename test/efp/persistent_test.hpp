@@ -0,0 +1,132 @@
+#ifndef PERSISTENT_TEST_HPP_
+#define PERSISTENT_TEST_HPP_
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "efp.hpp"
+#include "test_common.hpp"
+
+using namespace efp;
+
+TEST_CASE("PVector Rule of 5", "[PVector]") {
+    SECTION("Versions") {
+        {
+            MockHW::reset();
+            PVector<MockRaii> a;
+            a = a.push_back(MockRaii {});
+            a = a.push_back(MockRaii {});
+            CHECK(MockHW::remaining_resource_count() == 2);
+
+            PVector<MockRaii> b = a;
+            CHECK(MockHW::remaining_resource_count() == 2);
+
+            PVector<MockRaii> c = b.push_back(MockRaii {});
+            CHECK(MockHW::remaining_resource_count() == 5);
+
+            PVector<MockRaii> d = efp::move(c);
+            CHECK(MockHW::remaining_resource_count() == 5);
+        }
+        CHECK(MockHW::is_sound());
+    }
+}
+
+TEST_CASE("PVector", "[PVector]") {
+    SECTION("push_back") {
+        PVector<int> as {};
+        for (int i = 0; i < 2000; ++i) {
+            as = as.push_back(i);
+        }
+
+        CHECK(as.size() == 2000);
+
+        bool is_all_correct = true;
+        for (int i = 0; i < 2000; ++i) {
+            is_all_correct = is_all_correct && as[i] == i;
+        }
+        CHECK(is_all_correct);
+    }
+
+    SECTION("structural sharing") {
+        PVector<int> as {};
+        for (int i = 0; i < 1100; ++i) {
+            as = as.push_back(i);
+        }
+
+        const auto bs = as.set(1000, -1);
+        CHECK(as[1000] == 1000);
+        CHECK(bs[1000] == -1);
+        CHECK(&as[0] == &bs[0]);
+        CHECK(&as[999] != &bs[999]);
+
+        const auto cs = as.push_back(42);
+        CHECK(as.size() == 1100);
+        CHECK(cs.size() == 1101);
+        CHECK(cs.back() == 42);
+        CHECK(&as[0] == &cs[0]);
+    }
+
+    SECTION("pop_back") {
+        const PVector<int> as {1, 2, 3};
+        const auto bs = as.pop_back();
+        CHECK(bs == PVector<int> {1, 2});
+        CHECK(as == PVector<int> {1, 2, 3});
+
+        const auto cs = bs.push_back(4);
+        CHECK(cs == PVector<int> {1, 2, 4});
+        CHECK(as == PVector<int> {1, 2, 3});
+        CHECK_THROWS(PVector<int> {}.pop_back());
+    }
+
+    SECTION("slice") {
+        PVector<int> as {};
+        for (int i = 0; i < 100; ++i) {
+            as = as.push_back(i);
+        }
+
+        const auto bs = as.slice(40, 70);
+        CHECK(bs.size() == 30);
+        CHECK(bs[0] == 40);
+        CHECK(bs.back() == 69);
+
+        const auto cs = bs.push_back(-1);
+        CHECK(cs[30] == -1);
+        CHECK(as[70] == 70);
+        CHECK(bs.set(0, -2)[0] == -2);
+        CHECK(as[40] == 40);
+        CHECK_THROWS(as.slice(10, 101));
+    }
+
+    SECTION("concat") {
+        const PVector<int> as {1, 2, 3};
+        const PVector<int> bs {4, 5};
+        CHECK(as.concat(bs) == PVector<int> {1, 2, 3, 4, 5});
+        CHECK(as.size() == 3);
+    }
+
+    SECTION("transient") {
+        const PVector<int> as {1, 2, 3};
+
+        auto t = as.transient();
+        for (int i = 4; i <= 100; ++i) {
+            t.push_back(i);
+        }
+        t.set(0, -1);
+        t.pop_back();
+
+        const auto bs = t.persistent();
+        CHECK(bs.size() == 99);
+        CHECK(bs[0] == -1);
+        CHECK(bs[98] == 99);
+        CHECK(as == PVector<int> {1, 2, 3});
+    }
+
+    SECTION("Sequence trait") {
+        const PVector<double> as {1., 2., 3.};
+        CHECK(length(as) == 3);
+        CHECK(map([](double x) { return x * 2; }, as) == Vector<double> {2., 4., 6.});
+        CHECK(foldl(op_add<double>, 0., as) == 6.);
+        CHECK(elem_index(3., as).value() == 2);
+    }
+}
+
+#endif
@@ -0,0 +1,129 @@
+#ifndef POOL_TEST_HPP_
+#define POOL_TEST_HPP_
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "efp.hpp"
+#include "test_common.hpp"
+
+using namespace efp;
+
+TEST_CASE("BlockPool", "[BlockPool]") {
+    SECTION("block size") {
+        BlockPool<> pool {3, 4};
+        CHECK(pool.block_size() == sizeof(void*));
+        CHECK(pool.block_align() == alignof(void*));
+
+        BlockPool<> pool_2 {40, 32};
+        CHECK(pool_2.block_size() == 64);
+        CHECK(pool_2.block_align() == 32);
+    }
+
+    SECTION("allocate and deallocate") {
+        BlockPool<8> pool {sizeof(double), alignof(double)};
+        CHECK(pool.chunk_count() == 0);
+
+        void* blocks[20];
+        for (size_t i = 0; i < 20; ++i) {
+            blocks[i] = pool.allocate();
+            CHECK(is_aligned(blocks[i], alignof(double)));
+        }
+        CHECK(pool.chunk_count() == 3);
+        CHECK(pool.capacity() == 24);
+
+        for (size_t i = 0; i < 20; ++i) {
+            pool.deallocate(blocks[i]);
+        }
+
+        // Returned blocks are reused before adding a chunk
+        for (size_t i = 0; i < 20; ++i) {
+            blocks[i] = pool.allocate();
+        }
+        CHECK(pool.chunk_count() == 3);
+
+        for (size_t i = 0; i < 20; ++i) {
+            pool.deallocate(blocks[i]);
+        }
+    }
+
+    SECTION("thread cache") {
+        BlockPool<16> pool {sizeof(int), alignof(int), true};
+
+        void* p = pool.allocate();
+        pool.deallocate(p);
+        CHECK(pool.allocate() == p);
+        pool.deallocate(p);
+        CHECK(pool.chunk_count() == 1);
+    }
+
+    SECTION("multi-threaded") {
+        BlockPool<32> pool {sizeof(size_t), alignof(size_t), true};
+
+        const auto work = [&pool]() {
+            Vector<size_t*> ps {};
+            for (size_t round = 0; round < 10; ++round) {
+                for (size_t i = 0; i < 100; ++i) {
+                    size_t* p = static_cast<size_t*>(pool.allocate());
+                    *p = i;
+                    ps.push_back(p);
+                }
+
+                for (size_t i = 0; i < ps.size(); ++i) {
+                    CHECK(*ps[i] == i);
+                    pool.deallocate(ps[i]);
+                }
+                ps.clear();
+            }
+        };
+
+        std::thread t_1 {work};
+        std::thread t_2 {work};
+        work();
+        t_1.join();
+        t_2.join();
+    }
+}
+
+TEST_CASE("PoolAllocator", "[PoolAllocator]") {
+    BlockPool<> pool {arc_block_size<MockRaii>(), alignof(MockRaii)};
+
+    SECTION("allocate") {
+        PoolAllocator<int> alloc {pool};
+        int* p = alloc.allocate(1);
+        CHECK(pool.chunk_count() == 1);
+        alloc.deallocate(p, 1);
+
+        // Arrays go to the global heap
+        int* q = alloc.allocate(100);
+        q[99] = 42;
+        alloc.deallocate(q, 100);
+        CHECK(pool.chunk_count() == 1);
+    }
+
+    SECTION("equality") {
+        BlockPool<> other {8};
+        CHECK(PoolAllocator<int>(pool) == PoolAllocator<double>(pool));
+        CHECK(PoolAllocator<int>(pool) != PoolAllocator<int>(other));
+    }
+
+    SECTION("Vector") {
+        Vector<int, PoolAllocator<int>> as {PoolAllocator<int>(pool)};
+        for (int i = 0; i < 100; ++i) {
+            as.push_back(i);
+        }
+        CHECK(as[99] == 99);
+    }
+
+    SECTION("arc_in") {
+        MockHW::reset();
+        {
+            const Arc<MockRaii> a = arc_in(pool, MockRaii {});
+            const Arc<MockRaii> b = a;
+            CHECK(MockHW::remaining_resource_count() == 1);
+            CHECK(pool.chunk_count() == 1);
+        }
+        CHECK(MockHW::is_sound());
+    }
+}
+
+#endif
@@ -0,0 +1,153 @@
+#ifndef ROPE_TEST_HPP_
+#define ROPE_TEST_HPP_
+
+#include <cstdio>
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "efp.hpp"
+#include "test_common.hpp"
+
+using namespace efp;
+
+TEST_CASE("Rope", "[Rope]") {
+    SECTION("insert and erase") {
+        Rope text {"hello world"};
+        text.insert(5, ",");
+        CHECK(text == "hello, world");
+
+        text.erase(0, 1);
+        CHECK(text.to_string() == "ello, world");
+        CHECK(text.size() == 11);
+        CHECK(text[4] == ',');
+        CHECK(text.at(10) == 'd');
+        CHECK_THROWS(text.at(11));
+
+        text.erase(4, 100);
+        CHECK(text == "ello");
+    }
+
+    SECTION("large text against String") {
+        // Deterministic edits across many leaves, mirrored on a String
+        Rope rope {};
+        String expected {};
+        uint32_t x = 12345;
+
+        for (int i = 0; i < 2000; ++i) {
+            x = x * 1103515245u + 12345u;
+            const size_t pos = expected.empty() ? 0 : (x >> 8) % (expected.size() + 1);
+
+            if (i % 5 == 4 && !expected.empty()) {
+                const size_t len = (x >> 4) % 300;
+                rope.erase(pos, len);
+
+                const size_t erased = len < expected.size() - pos ? len : expected.size() - pos;
+                String next = expected.substr(0, pos);
+                next += expected.substr(pos + erased);
+                expected = next;
+            } else {
+                const String piece(1 + (x >> 16) % 700, static_cast<char>('a' + i % 26));
+                rope.insert(pos, piece);
+                expected.insert(pos, piece.data(), piece.size());
+            }
+        }
+
+        CHECK(rope.size() == expected.size());
+        CHECK(rope.to_string() == expected);
+        CHECK(rope.substr(100, 1000) == expected.substr(100, 1000));
+
+        size_t total = 0;
+        rope.for_each_chunk([&](const char*, size_t length) { total += length; });
+        CHECK(total == expected.size());
+    }
+
+    SECTION("concat") {
+        Rope a {"abc"};
+        Rope b {String(1000, 'x')};
+        a.append(efp::move(b));
+
+        CHECK(b.empty());
+        CHECK(a.size() == 1003);
+        CHECK(a.substr(0, 4) == "abcx");
+
+        const Rope copy = a;
+        a.erase(0, 3);
+        CHECK(copy.size() == 1003);
+        CHECK(a.size() == 1000);
+    }
+
+    SECTION("many small ropes") {
+        Rope text {};
+        for (int i = 0; i < 20000; ++i) {
+            text.append(Rope("line\n"));
+        }
+
+        CHECK(text.size() == 5 * 20000);
+        CHECK(text.substr(5 * 12345, 5) == "line\n");
+
+        // A treap of 20000 leaves is expected about 2 ln n = 20 deep
+        CHECK(text.depth() < 60);
+    }
+
+    SECTION("random edits") {
+        String expected(1 << 18, 'a');
+        Rope text {expected};
+        uint32_t state = 12345;
+        const auto random = [&state]() {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            return state;
+        };
+
+        // Single characters inserted and erased at random, checked against a String at first
+        for (int i = 0; i < 100000; ++i) {
+            const bool mirrored = i < 5000;
+
+            if (random() & 1) {
+                const size_t pos = random() % (text.size() + 1);
+                text.insert(pos, "b", 1);
+                if (mirrored) {
+                    expected.insert(pos, "b", 1);
+                }
+            } else {
+                const size_t pos = random() % text.size();
+                text.erase(pos, 1);
+                if (mirrored) {
+                    expected.erase(pos);
+                }
+            }
+
+            if (i + 1 == 5000) {
+                CHECK(text.to_string() == expected);
+            }
+        }
+
+        // Neighbouring leaves are joined when they fit in one, so leaves are half full on average
+        size_t leaves = 0;
+        text.for_each_chunk([&](const char*, size_t) { ++leaves; });
+        CHECK(leaves <= 2 * text.size() / Rope::leaf_capacity + 1);
+        CHECK(text.depth() < 60);
+    }
+
+    SECTION("write_to") {
+        Rope text {"first\n"};
+        text.append("second\n");
+        text.insert(0, "zeroth\n");
+
+        const char* path = "efp_rope_test.txt";
+        {
+            auto file = File::open(path, "w").move();
+            CHECK(text.write_to(file));
+        }
+
+        auto file = File::open(path, "r").move();
+        CHECK(file.read_line().value() == "zeroth");
+        CHECK(file.read_line().value() == "first");
+        CHECK(file.read_line().value() == "second");
+
+        std::remove(path);
+    }
+}
+
+#endif
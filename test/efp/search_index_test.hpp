@@ -0,0 +1,87 @@
+#ifndef SEARCH_INDEX_TEST_HPP_
+#define SEARCH_INDEX_TEST_HPP_
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "efp.hpp"
+#include "test_common.hpp"
+
+using namespace efp;
+
+// Reference lower bound by linear scan
+template<typename As, typename A>
+size_t linear_lower_bound(const As& as, const A& key) {
+    size_t i = 0;
+    while (i < length(as) && nth(i, as) < key) {
+        ++i;
+    }
+    return i;
+}
+
+TEST_CASE("SearchIndex", "[SearchIndex]") {
+    SECTION("empty") {
+        const SearchIndex<int> index {Vector<int> {}};
+        CHECK(index.empty());
+        CHECK(index.lower_bound(1) == 0);
+        CHECK_FALSE(index.contains(1));
+    }
+
+    SECTION("lower_bound of every size") {
+        // Complete trees and the partial last levels of every shape
+        bool ok = true;
+        for (size_t n = 1; n <= 70; ++n) {
+            Vector<int> sorted {};
+            for (size_t i = 0; i < n; ++i) {
+                sorted.push_back(static_cast<int>(i * 2));
+            }
+
+            const SearchIndex<int> index {sorted};
+            for (int key = -1; key <= static_cast<int>(n * 2); ++key) {
+                ok = ok && index.lower_bound(key) == linear_lower_bound(sorted, key);
+                ok = ok && index.contains(key) == (key >= 0 && key % 2 == 0 && key < int(n * 2));
+            }
+        }
+        CHECK(ok);
+    }
+
+    SECTION("duplicates") {
+        const Vector<uint64_t> sorted {1, 3, 3, 3, 5, 8, 8};
+        const SearchIndex<uint64_t> index {sorted};
+
+        CHECK(index.lower_bound(3) == 1);
+        CHECK(index.lower_bound(4) == 4);
+        CHECK(index.lower_bound(8) == 5);
+        CHECK(index.lower_bound(9) == 7);
+        CHECK(index.contains(5));
+        CHECK_FALSE(index.contains(4));
+    }
+
+    SECTION("lower_bound_many") {
+        Vector<uint64_t> sorted {};
+        for (uint64_t i = 0; i < 1000; ++i) {
+            sorted.push_back(i * i);
+        }
+        const SearchIndex<uint64_t> index {sorted};
+
+        Vector<uint64_t> keys {};
+        for (uint64_t i = 0; i < 100; ++i) {
+            keys.push_back((i * 7919) % 1000001);
+        }
+
+        const Vector<size_t> bounds = index.lower_bound_many(keys);
+        CHECK(bounds.size() == 100);
+
+        bool ok = true;
+        for (size_t i = 0; i < 100; ++i) {
+            ok = ok && bounds[i] == index.lower_bound(keys[i]);
+            ok = ok && bounds[i] == linear_lower_bound(sorted, keys[i]);
+        }
+        CHECK(ok);
+    }
+
+    SECTION("unsorted") {
+        CHECK_THROWS(SearchIndex<int> {Vector<int> {1, 3, 2}});
+    }
+}
+
+#endif
@@ -198,6 +198,22 @@ TEST_CASE("Vector Rule of five", "Vector") {
         }
         CHECK(MockHW::is_sound());
     }
+
+    SECTION("Insert and Erase") {
+        {
+            MockHW::reset();
+            Vector<MockRaii> a;
+            a.push_back(MockRaii {});
+            a.push_back(MockRaii {});
+            a.insert(0, MockRaii {});
+            a.insert(3, MockRaii {});
+            CHECK(MockHW::remaining_resource_count() == 4);
+            a.erase(1);
+            a.erase(2);
+            CHECK(MockHW::remaining_resource_count() == 2);
+        }
+        CHECK(MockHW::is_sound());
+    }
 }
 
 TEST_CASE("Initialization") {
@@ -0,0 +1,244 @@
+#ifndef SERIALIZE_TEST_HPP_
+#define SERIALIZE_TEST_HPP_
+
+#include <cstdio>
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "efp.hpp"
+#include "test_common.hpp"
+
+using namespace efp;
+
+struct SerialTestPoint {
+    int32_t x;
+    int32_t y;
+    double weight;
+};
+
+struct SerialTestQuote {
+    String symbol;
+    Vector<double> prices;
+    Maybe<int64_t> volume;
+};
+
+namespace efp {
+template<>
+struct Serial<SerialTestQuote> {
+    template<typename Sink>
+    static void write(SerialWriter<Sink>& out, const SerialTestQuote& q) {
+        out.write(q.symbol);
+        out.write(q.prices);
+        out.write(q.volume);
+    }
+
+    static SerialTestQuote read(SerialReader& in) {
+        SerialTestQuote q {};
+        q.symbol = in.read<String>();
+        q.prices = in.read<Vector<double>>();
+        q.volume = in.read<Maybe<int64_t>>();
+        return q;
+    }
+};
+}  // namespace efp
+
+TEST_CASE("Serial", "[Serial]") {
+    Vector<double> prices {};
+    for (int i = 0; i < 1000; ++i) {
+        prices.push_back(i * 0.25);
+    }
+
+    SECTION("round trip") {
+        String bytes {};
+        {
+            SerialWriter<String> out {bytes, 3};
+            CHECK(out.write(uint8_t(7)));
+            CHECK(out.write(int64_t(-42)));
+            CHECK(out.write(Array<int, 3> {1, 2, 3}));
+
+            ArrVec<float, 8> floats {};
+            floats.push_back(1.5f);
+            floats.push_back(-2.0f);
+            CHECK(out.write(floats));
+
+            CHECK(out.write(prices));
+            CHECK(out.write(String("a string longer than the inline capacity")));
+
+            Vector<String> names {};
+            names.push_back(String("x"));
+            names.push_back(String(""));
+            names.push_back(String("zz"));
+            CHECK(out.write(names));
+
+            CHECK(out.write(Maybe<int>(5)));
+            CHECK(out.write(Maybe<int>(nothing)));
+            CHECK(out.write(Enum<int, String, double>(String("alt"))));
+            CHECK(out.write(SerialTestPoint {3, -4, 0.5}));
+
+            Vector<SerialTestQuote> quotes {};
+            quotes.push_back(SerialTestQuote {String("AAPL"), prices, int64_t(100)});
+            quotes.push_back(SerialTestQuote {String("MSFT"), Vector<double> {}, nothing});
+            CHECK(out.write(quotes));
+
+            // Blocks are aligned from the start of the stream
+            CHECK(out.offset() == bytes.size());
+        }
+
+        SerialReader in {bytes.data(), bytes.size()};
+        CHECK(in.version() == 3);
+        CHECK(in.read<uint8_t>() == 7);
+        CHECK(in.read<int64_t>() == -42);
+        CHECK(in.read<Array<int, 3>>() == Array<int, 3> {1, 2, 3});
+
+        const ArrVec<float, 8> floats = in.read<ArrVec<float, 8>>();
+        CHECK(floats.size() == 2);
+        CHECK(floats[1] == -2.0f);
+
+        const Vector<double> prices_back = in.read<Vector<double>>();
+        CHECK(prices_back == prices);
+        CHECK(in.read<String>() == String("a string longer than the inline capacity"));
+
+        const Vector<String> names = in.read<Vector<String>>();
+        CHECK(names.size() == 3);
+        CHECK(names[0] == String("x"));
+        CHECK(names[1].empty());
+        CHECK(names[2] == String("zz"));
+
+        CHECK(in.read<Maybe<int>>().value() == 5);
+        CHECK(in.read<Maybe<int>>().is_nothing());
+
+        const auto alt = in.read<Enum<int, String, double>>();
+        CHECK(alt.index() == 1);
+        CHECK(alt.get<1>() == String("alt"));
+
+        const SerialTestPoint point = in.read<SerialTestPoint>();
+        CHECK(point.x == 3);
+        CHECK(point.y == -4);
+        CHECK(point.weight == 0.5);
+
+        const Vector<SerialTestQuote> quotes = in.read<Vector<SerialTestQuote>>();
+        CHECK(quotes.size() == 2);
+        CHECK(quotes[0].symbol == String("AAPL"));
+        CHECK(quotes[0].prices == prices);
+        CHECK(quotes[0].volume.value() == 100);
+        CHECK(quotes[1].prices.empty());
+        CHECK(quotes[1].volume.is_nothing());
+
+        CHECK(in.remaining() == 0);
+        CHECK_THROWS(in.read<uint8_t>());
+    }
+
+    SECTION("views in place") {
+        const char* path = "efp_serialize_test.bin";
+        {
+            auto file = File::open(path, "wb").move();
+            BufWriter buffered {file, 256};
+            SerialWriter<BufWriter> out {buffered};
+            CHECK(out.write(String("prices")));
+            CHECK(out.write(prices));
+            CHECK(out.write(Array<int32_t, 4> {4, 3, 2, 1}));
+            CHECK(out.write(String("tail")));
+        }
+
+        const auto file = MappedFile::open(path).move();
+        SerialReader in {file.chars()};
+        const StringView name = in.read<StringView>();
+        CHECK(String(name.data(), name.size()) == String("prices"));
+
+        const VectorView<const double> view = in.view<double>();
+        CHECK(view.size() == prices.size());
+        CHECK(view[999] == prices[999]);
+        CHECK(reinterpret_cast<const char*>(view.data()) > file.chars().data());
+        CHECK(reinterpret_cast<const char*>(view.data()) < file.chars().data() + file.size());
+
+        const ArrayView<const int32_t, 4> array = in.array_view<int32_t, 4>();
+        CHECK(array[0] == 4);
+        CHECK(array[3] == 1);
+        CHECK(in.read<String>() == String("tail"));
+
+        std::remove(path);
+    }
+
+    SECTION("malformed streams") {
+        String bytes {};
+        {
+            SerialWriter<String> out {bytes};
+            out.write(prices);
+            out.write(Maybe<int>(1));
+        }
+
+        CHECK_THROWS(SerialReader(bytes.data(), 8));
+
+        String other_magic = bytes;
+        other_magic[0] = 'X';
+        CHECK_THROWS(SerialReader(other_magic.data(), other_magic.size()));
+
+        String other_format = bytes;
+        other_format[8] = 2;
+        CHECK_THROWS(SerialReader(other_format.data(), other_format.size()));
+
+        // Truncated in the middle of the block
+        SerialReader truncated {bytes.data(), 100};
+        CHECK_THROWS(truncated.read<Vector<double>>());
+
+        SerialReader mismatch {bytes.data(), bytes.size()};
+        CHECK_THROWS(mismatch.read<Array<double, 3>>());
+
+        SerialReader overflow {bytes.data(), bytes.size()};
+        CHECK_THROWS(overflow.read<ArrVec<double, 8>>());
+
+        String bad_index = bytes;
+        // The index, padding to the int and the int
+        bad_index[bad_index.size() - 8] = 2;
+        SerialReader index {bad_index.data(), bad_index.size()};
+        index.view<double>();
+        CHECK_THROWS(index.read<Maybe<int>>());
+
+        // A corrupt length throws when the elements run out, without allocating for all of it
+        String long_stream {};
+        {
+            SerialWriter<String> out {long_stream};
+            Vector<String> names {};
+            names.push_back(String("a"));
+            names.push_back(String("b"));
+            out.write(names);
+            out.write(String(1 << 16, 'x'));
+        }
+
+        const uint64_t corrupt = 60000;
+        _memcpy(long_stream.data() + 16, &corrupt, sizeof(corrupt));
+
+        bool strings_threw = false;
+        bool doubles_threw = false;
+        size_t peak = 0;
+        {
+            AllocationScope scope {"corrupt length"};
+            SerialReader strings {long_stream.data(), long_stream.size()};
+            try {
+                strings.read<Vector<String>>();
+            } catch (const std::exception&) {
+                strings_threw = true;
+            }
+
+            SerialReader doubles {long_stream.data(), long_stream.size()};
+            try {
+                doubles.read<Vector<double>>();
+            } catch (const std::exception&) {
+                doubles_threw = true;
+            }
+            peak = scope.stats().peak_live_bytes;
+        }
+        CHECK(strings_threw);
+        CHECK(doubles_threw);
+        CHECK(peak < 4 * long_stream.size());
+
+        // Views need the bytes aligned as the elements
+        String shifted {};
+        shifted.push_back(' ');
+        shifted.append(bytes.data(), bytes.size());
+        SerialReader misaligned {shifted.data() + 1, bytes.size()};
+        CHECK_THROWS(misaligned.view<double>());
+    }
+}
+
+#endif
@@ -65,6 +65,38 @@ TEST_CASE("Sorting algorithms sort correctly", "[sort]") {
         size_trosort_by(test_values, greater_than);
         CHECK(test_values == expected_descending);
     }
+
+    SECTION("sort merges runs longer than the insertion sort run") {
+        Vector<int> test_values {};
+        for (int i = 0; i < 1000; ++i) {
+            test_values.push_back((i * 37) % 101);
+        }
+        sort(test_values);
+
+        bool sorted = true;
+        for (size_t i = 1; i < test_values.size(); ++i) {
+            sorted = sorted && test_values[i - 1] <= test_values[i];
+        }
+        CHECK(sorted);
+    }
+
+    SECTION("sort_by is stable") {
+        Vector<Pair<int, int>> test_values {};
+        for (int i = 0; i < 200; ++i) {
+            test_values.push_back(Pair<int, int>(i % 3, i));
+        }
+        sort_by(test_values, [](const Pair<int, int>& a, const Pair<int, int>& b) {
+            return fst(a) < fst(b);
+        });
+
+        bool stable = true;
+        for (size_t i = 1; i < test_values.size(); ++i) {
+            if (fst(test_values[i - 1]) == fst(test_values[i])) {
+                stable = stable && snd(test_values[i - 1]) < snd(test_values[i]);
+            }
+        }
+        CHECK(stable);
+    }
 }
 
 #endif
\ No newline at end of file
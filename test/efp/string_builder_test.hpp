@@ -0,0 +1,83 @@
+#ifndef STRING_BUILDER_TEST_HPP_
+#define STRING_BUILDER_TEST_HPP_
+
+#include <cstdio>
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "efp.hpp"
+#include "test_common.hpp"
+
+using namespace efp;
+
+TEST_CASE("StringBuilder", "[StringBuilder]") {
+    SECTION("append and build") {
+        StringBuilder sb {};
+        CHECK(sb.empty());
+        CHECK(sb.build().empty());
+
+        const String name {"efp"};
+        sb.append("id,").append(name).append(',').append(3, '!');
+        CHECK(sb.size() == 10);
+        CHECK(sb.build() == "id,efp,!!!");
+
+        // Consecutive owned pieces share one
+        CHECK(sb.pieces().size() == 1);
+    }
+
+    SECTION("borrowed pieces") {
+        const String large(100, 'x');
+
+        StringBuilder sb {};
+        sb.append("[");
+        sb.append_borrowed(large);
+        sb.append("]");
+
+        CHECK(sb.pieces().size() == 3);
+        CHECK(sb.pieces()[1].data() == large.data());
+
+        const String built = sb.build();
+        CHECK(built.size() == 102);
+        CHECK(built.front() == '[');
+        CHECK(built.back() == ']');
+    }
+
+    SECTION("pieces larger than a block") {
+        StringBuilder sb {16};
+        String expected {};
+
+        for (int i = 0; i < 100; ++i) {
+            const String piece(static_cast<size_t>(i % 40), static_cast<char>('a' + i % 26));
+            sb.append(piece);
+            expected += piece;
+        }
+
+        CHECK(sb.build() == expected);
+
+        sb.clear();
+        CHECK(sb.empty());
+        sb.append("again");
+        CHECK(sb.build() == "again");
+    }
+
+    SECTION("write_to") {
+        StringBuilder sb {};
+        sb.append("line 1\n");
+        sb.append_borrowed("line 2\n");
+
+        const char* path = "efp_string_builder_test.txt";
+        {
+            auto file = File::open(path, "w").move();
+            CHECK(sb.write_to(file));
+        }
+
+        auto file = File::open(path, "r").move();
+        CHECK(file.read_line().value() == "line 1");
+        CHECK(file.read_line().value() == "line 2");
+        CHECK(file.read_line().is_nothing());
+
+        std::remove(path);
+    }
+}
+
+#endif
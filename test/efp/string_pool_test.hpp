@@ -0,0 +1,125 @@
+#ifndef STRING_POOL_TEST_HPP_
+#define STRING_POOL_TEST_HPP_
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "efp.hpp"
+#include "test_common.hpp"
+
+using namespace efp;
+
+TEST_CASE("StringPool", "[StringPool]") {
+    SECTION("intern") {
+        StringPool pool {};
+        const Symbol a = pool.intern("alpha");
+        const Symbol b = pool.intern(String {"beta"});
+        const Symbol a2 = pool.intern(StringView {"alphabet", 5});
+
+        CHECK(a == a2);
+        CHECK(a != b);
+        CHECK(pool.size() == 2);
+        CHECK(pool.view(a) == "alpha");
+        CHECK(String {pool.c_str(b)} == "beta");
+        CHECK(pool.view(a).size() == 5);
+    }
+
+    SECTION("find") {
+        StringPool pool {};
+        CHECK(pool.find("x").is_nothing());
+
+        const Symbol x = pool.intern("x");
+        CHECK(pool.find("x").value() == x);
+        CHECK_FALSE(pool.contains("y"));
+    }
+
+    SECTION("empty string") {
+        StringPool pool {};
+        const Symbol e = pool.intern("");
+        CHECK(pool.intern("") == e);
+        CHECK(pool.view(e).size() == 0);
+        CHECK(pool.c_str(e)[0] == '\0');
+    }
+
+    SECTION("many strings") {
+        StringPool pool {256};
+        Vector<Symbol> symbols {};
+        for (int i = 0; i < 5000; ++i) {
+            symbols.push_back(pool.intern(String {std::to_string(i).c_str()}));
+        }
+        CHECK(pool.size() == 5000);
+
+        bool ok = true;
+        for (int i = 0; i < 5000; ++i) {
+            const String s {std::to_string(i).c_str()};
+            ok = ok && symbols[i].id() == static_cast<uint32_t>(i);
+            ok = ok && pool.intern(s) == symbols[i];
+            ok = ok && pool.view(symbols[i]).size() == s.size();
+            ok = ok && String {pool.c_str(symbols[i])} == s;
+        }
+        CHECK(ok);
+    }
+
+    SECTION("interning an existing string does not allocate") {
+        StringPool pool {};
+        pool.intern("key");
+        CHECK_ALLOCATION_FREE(pool.intern("key"));
+    }
+
+    SECTION("symbols as keys") {
+        StringPool pool {};
+        HashMap<Symbol, int> counts {};
+        counts[pool.intern("a")] += 1;
+        counts[pool.intern("b")] += 1;
+        counts[pool.intern("a")] += 1;
+        CHECK(counts[pool.intern("a")] == 2);
+    }
+
+    SECTION("unknown symbol") {
+        StringPool pool {};
+        CHECK_THROWS(pool.view(Symbol {3}));
+    }
+
+    SECTION("concurrent intern and lookup") {
+        StringPool pool {};
+        const int thread_num = 4;
+        const int key_num = 509;  // Prime, so that every stride visits every key
+
+        std::vector<std::vector<uint32_t>> ids(thread_num, std::vector<uint32_t>(key_num));
+        std::vector<std::thread> threads {};
+
+        for (int t = 0; t < thread_num; ++t) {
+            threads.emplace_back([&pool, &ids, t]() {
+                for (int i = 0; i < key_num; ++i) {
+                    // Each thread interns the keys in a different order
+                    const int k = (i * (2 * t + 1)) % key_num;
+                    const String key {("key" + std::to_string(k)).c_str()};
+                    const Symbol s = pool.intern(key);
+                    ids[t][k] = s.id();
+
+                    // Every symbol seen is readable
+                    if (!(String {pool.c_str(s)} == key)) {
+                        ids[t][k] = uint32_t(-1);
+                    }
+                }
+            });
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        CHECK(pool.size() == static_cast<size_t>(key_num));
+
+        bool ok = true;
+        for (int t = 1; t < thread_num; ++t) {
+            ok = ok && ids[t] == ids[0];
+        }
+        CHECK(ok);
+    }
+}
+
+#endif
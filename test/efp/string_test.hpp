@@ -13,12 +13,13 @@ TEST_CASE("BasicString<Char>", "[BasicString<Char>]") {
         String str;
         CHECK(str.empty());
         CHECK(str.size() == 0);
-        CHECK(str.capacity() == 0);
+        CHECK(str.capacity() == String::local_capacity);
+        CHECK(str.c_str()[0] == '\0');
 
         WString wstr;
         CHECK(wstr.empty());
         CHECK(wstr.size() == 0);
-        CHECK(wstr.capacity() == 0);
+        CHECK(wstr.capacity() == WString::local_capacity);
     }
 
     SECTION("Constructor from C-Style String") {
@@ -287,6 +288,102 @@ TEST_CASE("BasicString<Char>", "[BasicString<Char>]") {
         CHECK(wstr3.compare(0, 5, wstr1) > 0);
     }
 
+    SECTION("Small string optimization") {
+        CHECK(sizeof(String) == 4 * sizeof(void*));
+        CHECK(String::local_capacity == 3 * sizeof(void*));
+
+        // The longest inline string
+        const String inline_max(String::local_capacity - 1, 'x');
+
+        // Only the operations are in the scope, as recording a check may allocate
+        String a {};
+        String c {};
+        String d {};
+        String sub {};
+        StringView v {};
+        CHECK_ALLOCATION_FREE(
+            a = String {"identifier"};
+            String b = a;
+            c = String {efp::move(b)};
+            c.append("_suffix");
+            c.insert(0, "p_");
+            c += String {"!"};
+            v = c;
+            sub = c.substr(2, 10);
+            d = inline_max;
+        );
+        CHECK(a == "identifier");
+        CHECK(v.size() == 20);
+        CHECK(sub == "identifier");
+        CHECK(c == "p_identifier_suffix!");
+        CHECK(d.size() == String::local_capacity - 1);
+
+        // Grows to the heap and back
+        String s {"short"};
+        const char* inline_data = s.data();
+        s.append(40, '-');
+        CHECK(s.size() == 45);
+        CHECK(s.data() != inline_data);
+        CHECK(std::strcmp(s.c_str() + 40, "-----") == 0);
+        CHECK(s.substr(0, 5) == "short");
+
+        s.resize(3);
+        s.shrink_to_fit();
+        CHECK(s.capacity() == String::local_capacity);
+        CHECK(s == "sho");
+
+        // Moving a heap string takes over the allocation
+        String heap(100, 'h');
+        const char* heap_data = heap.data();
+        const String moved {efp::move(heap)};
+        CHECK(moved.data() == heap_data);
+        CHECK(heap.empty());
+        CHECK(std::strcmp(heap.c_str(), "") == 0);
+
+        // Appending to itself across the boundary
+        String self {"0123456789ab"};
+        self += self;
+        CHECK(self == "0123456789ab0123456789ab");
+        self += self;
+        CHECK(self.size() == 48);
+
+        // Inserting a part of itself before, after and across the position, in place and
+        // while growing to the heap
+        String before {"0123456789"};
+        before.insert(6, before.c_str() + 1, 3);
+        CHECK(before == "0123451236789");
+        String after {"0123456789"};
+        after.insert(2, after.c_str() + 4, 5);
+        CHECK(after == "014567823456789");
+        String across {"0123456789"};
+        across.insert(5, across.c_str() + 3, 4);
+        CHECK(across == "01234345656789");
+        String grown {"0123456789abcdefghij"};
+        grown.insert(10, grown.c_str() + 5, 15);
+        CHECK(grown == "012345678956789abcdefghijabcdefghij");
+        CHECK(grown.size() == 35);
+
+        // Growing a piece at a time reallocates geometrically
+        size_t allocations = 0;
+        {
+            AllocationScope scope {"grow"};
+            String grow_append {};
+            String grow_insert {};
+            for (int i = 0; i < 10000; ++i) {
+                grow_append.append(1, 'x');
+                grow_insert.insert(grow_insert.size(), "ab", 2);
+            }
+            allocations = scope.stats().allocations;
+            CHECK(grow_append.size() == 10000);
+            CHECK(grow_insert.size() == 20000);
+        }
+        CHECK(allocations < 64);
+
+        WString w {L"wide"};
+        w.append(L" and long enough to leave the inline buffer");
+        CHECK(w == L"wide and long enough to leave the inline buffer");
+    }
+
     SECTION("Equality with C-Style String") {
         String str("Hello");
         CHECK(str == "Hello");
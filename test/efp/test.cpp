@@ -1,3 +1,6 @@
+// Count all the heap allocations of the test binary for CHECK_ALLOCATION_FREE
+#define EFP_TRACK_GLOBAL_NEW
+
 #include "./meta_test.hpp"
 #include "./sequence_test.hpp"
 #include "./enum_test.hpp"
@@ -6,8 +9,28 @@
 #include "./numeric_test.hpp"
 #include "./scientific_test.hpp"
 #include "./cyclic_test.hpp"
+#include "./chunked_test.hpp"
+#include "./persistent_test.hpp"
 #include "./c_utility_test.hpp"
 #include "./string_test.hpp"
 #include "./sort_test.hpp"
 #include "./format_test.hpp"
+#include "./hash_test.hpp"
+#include "./hash_map_test.hpp"
+#include "./flat_map_test.hpp"
+#include "./search_index_test.hpp"
+#include "./string_pool_test.hpp"
+#include "./string_builder_test.hpp"
+#include "./rope_test.hpp"
+#include "./io_test.hpp"
+#include "./mapped_file_test.hpp"
+#include "./async_file_test.hpp"
+#include "./serialize_test.hpp"
+#include "./csv_test.hpp"
+#include "./tlsf_test.hpp"
+#include "./pool_test.hpp"
 #include "./concurrency_test.hpp"
+#include "./logger_test.hpp"
+#include "./binary_log_test.hpp"
+#include "./allocator_test.hpp"
+#include "./tracking_test.hpp"
@@ -201,4 +201,17 @@ TEST_CASE("MockHW and MockRaii", "MockHW") {
     }
 }
 
+// CHECK_ALLOCATION_FREE
+// Checks that the statements do not allocate on the heap. Relies on EFP_TRACK_GLOBAL_NEW of test.cpp
+#define CHECK_ALLOCATION_FREE(...)                                     \
+    do {                                                               \
+        size_t _allocation_count = 0;                                  \
+        {                                                              \
+            efp::AllocationScope _allocation_scope {#__VA_ARGS__};     \
+            __VA_ARGS__;                                               \
+            _allocation_count = _allocation_scope.stats().allocations; \
+        }                                                              \
+        CHECK(_allocation_count == 0);                                 \
+    } while (0)
+
 #endif
\ No newline at end of file
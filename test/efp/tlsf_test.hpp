@@ -0,0 +1,177 @@
+#ifndef TLSF_TEST_HPP_
+#define TLSF_TEST_HPP_
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "efp.hpp"
+#include "test_common.hpp"
+
+using namespace efp;
+
+TEST_CASE("Tlsf", "[Tlsf]") {
+    alignas(16) static char region[64 * 1024];
+    Tlsf tlsf {region, sizeof(region)};
+
+    SECTION("allocate") {
+        CHECK(tlsf.region_size() > 60 * 1024);
+        CHECK(tlsf.used() == 0);
+
+        void* p = tlsf.allocate(100);
+        REQUIRE(p != nullptr);
+        CHECK(is_aligned(p, Tlsf::alignment));
+        CHECK(static_cast<char*>(p) >= region);
+        CHECK(static_cast<char*>(p) + 100 <= region + sizeof(region));
+        CHECK(tlsf.used() >= 100);
+
+        tlsf.deallocate(p);
+        CHECK(tlsf.used() == 0);
+    }
+
+    SECTION("zero and oversized request") {
+        CHECK(tlsf.allocate(0) == nullptr);
+        CHECK(tlsf.allocate(sizeof(region)) == nullptr);
+    }
+
+    SECTION("coalescing") {
+        const size_t whole = tlsf.largest_free_block();
+        CHECK(tlsf.fragmentation() == 0.);
+
+        void* ps[64];
+        for (size_t i = 0; i < 64; ++i) {
+            ps[i] = tlsf.allocate(500);
+            REQUIRE(ps[i] != nullptr);
+        }
+
+        // Free every other block, so the free space is split
+        for (size_t i = 0; i < 64; i += 2) {
+            tlsf.deallocate(ps[i]);
+        }
+        CHECK(tlsf.fragmentation() > 0.);
+
+        for (size_t i = 1; i < 64; i += 2) {
+            tlsf.deallocate(ps[i]);
+        }
+        CHECK(tlsf.largest_free_block() == whole);
+        CHECK(tlsf.fragmentation() == 0.);
+
+        // The region is not split anymore
+        void* p = tlsf.allocate(whole / 2 + 1000);
+        CHECK(p != nullptr);
+        tlsf.deallocate(p);
+    }
+
+    SECTION("exhaustion") {
+        size_t count = 0;
+        void* ps[1024];
+        while (count < 1024 && (ps[count] = tlsf.allocate(1000)) != nullptr) {
+            ++count;
+        }
+        CHECK(count > 50);
+        CHECK(count < 1024);
+
+        for (size_t i = 0; i < count; ++i) {
+            tlsf.deallocate(ps[i]);
+        }
+        CHECK(tlsf.used() == 0);
+    }
+
+    SECTION("no overlap") {
+        unsigned char* ps[100];
+        size_t sizes[100];
+        uint32_t seed = 42;
+
+        for (size_t round = 0; round < 10; ++round) {
+            for (size_t i = 0; i < 100; ++i) {
+                seed = seed * 1664525u + 1013904223u;
+                sizes[i] = 1 + (seed >> 24);
+                ps[i] = static_cast<unsigned char*>(tlsf.allocate(sizes[i]));
+                REQUIRE(ps[i] != nullptr);
+
+                for (size_t j = 0; j < sizes[i]; ++j) {
+                    ps[i][j] = static_cast<unsigned char>(i);
+                }
+            }
+
+            bool intact = true;
+            for (size_t i = 0; i < 100; ++i) {
+                for (size_t j = 0; j < sizes[i]; ++j) {
+                    intact = intact && ps[i][j] == static_cast<unsigned char>(i);
+                }
+            }
+            CHECK(intact);
+
+            // Free in an interleaved order to exercise merging in both directions
+            for (size_t i = round % 2; i < 100; i += 2) {
+                tlsf.deallocate(ps[i]);
+            }
+            for (size_t i = 1 - round % 2; i < 100; i += 2) {
+                tlsf.deallocate(ps[i]);
+            }
+        }
+
+        CHECK(tlsf.used() == 0);
+        CHECK(tlsf.fragmentation() == 0.);
+    }
+
+    SECTION("high water mark") {
+        void* p = tlsf.allocate(1000);
+        void* q = tlsf.allocate(2000);
+        const size_t peak = tlsf.used();
+
+        tlsf.deallocate(q);
+        CHECK(tlsf.high_water_mark() == peak);
+
+        tlsf.reset_high_water_mark();
+        CHECK(tlsf.high_water_mark() == tlsf.used());
+
+        tlsf.deallocate(p);
+    }
+}
+
+TEST_CASE("TlsfAllocator", "[TlsfAllocator]") {
+    alignas(16) static char region[16 * 1024];
+    Tlsf tlsf {region, sizeof(region)};
+    const TlsfAllocator<int> alloc {tlsf};
+
+    SECTION("Vector") {
+        Vector<int, TlsfAllocator<int>> as {alloc};
+        for (int i = 0; i < 1000; ++i) {
+            as.push_back(i);
+        }
+
+        CHECK(as[999] == 999);
+        CHECK(tlsf.used() >= 1000 * sizeof(int));
+    }
+
+    SECTION("out of memory") {
+        Vector<int, TlsfAllocator<int>> as {alloc};
+        CHECK_THROWS(as.reserve(sizeof(region)));
+    }
+
+    SECTION("Vector of RAII elements") {
+        MockHW::reset();
+        {
+            Vector<MockRaii, TlsfAllocator<MockRaii>> as {TlsfAllocator<MockRaii>(tlsf)};
+            as.push_back(MockRaii {});
+            as.push_back(MockRaii {});
+
+            const auto bs = as;
+            CHECK(MockHW::remaining_resource_count() == 4);
+        }
+        CHECK(MockHW::is_sound());
+        CHECK(tlsf.used() == 0);
+    }
+
+    SECTION("default_tlsf") {
+        default_tlsf().assign(region, sizeof(region));
+        CHECK(TlsfAllocator<int>().tlsf() == &default_tlsf());
+
+        {
+            Vector<int, TlsfAllocator<int>> as {1, 2, 3};
+            CHECK(default_tlsf().used() > 0);
+        }
+        CHECK(default_tlsf().used() == 0);
+    }
+}
+
+#endif
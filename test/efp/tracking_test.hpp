@@ -0,0 +1,102 @@
+#ifndef TRACKING_TEST_HPP_
+#define TRACKING_TEST_HPP_
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "efp.hpp"
+#include "test_common.hpp"
+
+using namespace efp;
+
+TEST_CASE("TrackingAllocator", "[TrackingAllocator]") {
+    SECTION("counts") {
+        size_t allocations = 0;
+        size_t deallocations = 0;
+        size_t peak = 0;
+        {
+            AllocationScope scope {"vector"};
+            {
+                Vector<int, TrackingAllocator<int>> as {};
+                as.reserve(10);
+                as.reserve(100);
+            }
+            allocations = scope.stats().allocations;
+            deallocations = scope.stats().deallocations;
+            peak = scope.stats().peak_live_bytes;
+        }
+
+        // Global new is tracked too, so each allocation is counted twice in tests
+        CHECK(allocations == 4);
+        CHECK(deallocations == 4);
+        CHECK(peak >= 2 * 110 * sizeof(int));
+    }
+
+    SECTION("nested scopes") {
+        size_t outer_count = 0;
+        size_t inner_count = 0;
+        const char* tag = nullptr;
+        {
+            AllocationScope outer {"outer"};
+            const Vector<int> as {1, 2, 3};
+            {
+                AllocationScope inner {"inner"};
+                tag = AllocationScope::current()->tag();
+                const Vector<int> bs = as;
+                inner_count = inner.stats().allocations;
+            }
+            outer_count = outer.stats().allocations;
+        }
+
+        CHECK(inner_count == 1);
+        CHECK(outer_count == 2);
+        CHECK(String(tag) == String("inner"));
+        CHECK(AllocationScope::current() == nullptr);
+    }
+
+    SECTION("global stats") {
+        const AllocationStats before = global_allocation_stats();
+        {
+            const Vector<int> as {1, 2, 3};
+        }
+        const AllocationStats after = global_allocation_stats();
+
+        CHECK(after.allocations - before.allocations == 1);
+        CHECK(after.deallocations - before.deallocations == 1);
+        CHECK(after.live_bytes == before.live_bytes);
+    }
+
+    SECTION("rebind") {
+        using Rebound = AllocatorTraits<TrackingAllocator<int>>::rebind_alloc<double>;
+        CHECK(IsSame<Rebound, TrackingAllocator<double, std::allocator<double>>>::value);
+    }
+}
+
+TEST_CASE("Allocation free", "[TrackingAllocator]") {
+    const auto times_2 = [](double x) { return 2. * x; };
+    const auto is_even = [](double x) { return static_cast<int>(x) % 2 == 0; };
+
+    SECTION("static size prelude") {
+        CHECK_ALLOCATION_FREE(map(times_2, array_3));
+        CHECK_ALLOCATION_FREE(map(times_2, arrvec_3));
+        CHECK_ALLOCATION_FREE(filter(is_even, array_5));
+        CHECK_ALLOCATION_FREE(append(array_3, array_5));
+        CHECK_ALLOCATION_FREE(concat(Array<Array<double, 3>, 2> {array_3, array_3}));
+        CHECK_ALLOCATION_FREE(
+            intercalate(array_3, Array<Array<double, 3>, 2> {array_3, array_3})
+        );
+        CHECK_ALLOCATION_FREE(elem_indices(2., array_5));
+    }
+
+    SECTION("static size scientific") {
+        CHECK_ALLOCATION_FREE(mean<double>(array_5));
+        CHECK_ALLOCATION_FREE(variance<double>(array_5));
+        CHECK_ALLOCATION_FREE(remove_dc<double>(array_5));
+    }
+
+    SECTION("views") {
+        CHECK_ALLOCATION_FREE(map(times_2, array_view_3));
+        CHECK_ALLOCATION_FREE(foldl([](double acc, double x) { return acc + x; }, 0., vector_view_5));
+    }
+}
+
+#endif